@@ -0,0 +1,413 @@
+#ifndef AOC_ALLOC_H
+#define AOC_ALLOC_H
+
+// Allocation accounting per phase and per call site.
+//
+//     ./nob alloc
+//     ./build/alloc/aoc --day 2      // tables go to stderr at exit
+//
+// The alloc profile compiles every file with -DAOC_ALLOC -include header/alloc.h, so this header comes
+// before anything else and malloc(), calloc(), realloc(), free() and strdup() become wrappers that know
+// the file, line and function they were called from. The dynamic arrays and string builders of nob.h
+// (da_append, sb_append...) go through them via NOB_REALLOC/NOB_FREE, the arrays and hash maps of
+// stb_ds via STBDS_REALLOC/STBDS_FREE.
+//
+// stb_ds allocates inside its own functions, so on its own STBDS_REALLOC would charge every arrput(),
+// hmput() or shput() to the few lines of std_ds.h that grow arrays and hash indexes. In this profile
+// std_ds.h calls those functions through ALLOC_STBDS_CALL, which records the file and line that used
+// the macro for the calling thread, and STBDS_REALLOC charges the recorded line. A macro used in the
+// arguments of another one, hmput(t, k, hmget(t, k)), ends the record early and the outer call is
+// charged to std_ds.h again.
+//
+// Every live block sits in a pointer table with its size, so a free is credited back to the phase and
+// the call site that allocated it. Blocks the wrappers never saw (libc internals) pass straight through.
+//
+// Phases are the perf_begin()/perf_end() phases of the running day: parse, part1, part2 and the steps
+// solvers mark. Anything outside of them counts towards "-". For both tables the report has calls,
+// requested bytes, bytes still live at exit and the peak of live bytes. Reallocs count as calls.
+//
+// In every other profile ALLOC_DAY/ALLOC_BEGIN/ALLOC_END expand to nothing and nothing is wrapped.
+//
+// Like stb_ds, the aoc runner links every day together and src/aoc.c carries the one copy of the
+// tables, days built on their own carry their own.
+
+#ifdef AOC_ALLOC
+
+#ifndef AOC_RUNNER
+#define AOC_ALLOC_IMPLEMENTATION
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+void* alloc__malloc(size_t size, const char* file, int line, const char* func);
+void* alloc__calloc(size_t count, size_t size, const char* file, int line, const char* func);
+void* alloc__realloc(void* ptr, size_t size, const char* file, int line, const char* func);
+void* alloc__stbds_realloc(void* ptr, size_t size, const char* file, int line, const char* func);
+void alloc__stbds_begin(const char* file, int line, const char* func);
+void* alloc__stbds_end(void* result);
+char* alloc__strdup(const char* s, const char* file, int line, const char* func);
+void alloc__free(void* ptr);
+
+void alloc_set_day(int day);
+void alloc_begin(const char* name);
+void alloc_end(void);
+
+#undef strdup
+#define malloc(size) alloc__malloc((size), __FILE__, __LINE__, __func__)
+#define calloc(count, size) alloc__calloc((count), (size), __FILE__, __LINE__, __func__)
+#define realloc(ptr, size) alloc__realloc((ptr), (size), __FILE__, __LINE__, __func__)
+#define strdup(s) alloc__strdup((s), __FILE__, __LINE__, __func__)
+#define free(ptr) alloc__free(ptr)
+
+#define NOB_REALLOC(ptr, size) alloc__realloc((ptr), (size), __FILE__, __LINE__, __func__)
+#define NOB_FREE(ptr) alloc__free(ptr)
+#define STBDS_REALLOC(context, ptr, size) alloc__stbds_realloc((ptr), (size), __FILE__, __LINE__, __func__)
+#define STBDS_FREE(context, ptr) alloc__free(ptr)
+#define ALLOC_STBDS_CALL(call) (alloc__stbds_begin(__FILE__, __LINE__, __func__), alloc__stbds_end(call))
+
+#define ALLOC_DAY(day) alloc_set_day(day)
+#define ALLOC_BEGIN(name) alloc_begin(name)
+#define ALLOC_END() alloc_end()
+
+#else
+
+#define ALLOC_DAY(day) ((void)0)
+#define ALLOC_BEGIN(name) ((void)0)
+#define ALLOC_END() ((void)0)
+
+#endif  // AOC_ALLOC
+
+#endif  // AOC_ALLOC_H
+
+// The implementation is emitted by the first inclusion that asks for it, for the runner that is the
+// one through perf.h in src/aoc.c. The real allocator is called as (malloc)() and friends, the
+// parentheses keep the wrapper macros from expanding.
+#if defined(AOC_ALLOC) && defined(AOC_ALLOC_IMPLEMENTATION) && !defined(AOC_ALLOC_IMPLEMENTED)
+#define AOC_ALLOC_IMPLEMENTED
+
+#include <pthread.h>
+#include <stdbool.h>
+
+#define ALLOC_MAX_DEPTH 16
+#define ALLOC_TOP_SITES 25
+
+typedef struct {
+    uint64_t calls;
+    uint64_t bytes;
+    uint64_t live;
+    uint64_t peak;
+} Alloc_Count;
+
+typedef struct {
+    const char* file;
+    int line;
+    const char* func;
+    Alloc_Count count;
+} Alloc_Site;
+
+typedef struct {
+    int day;
+    const char* name;
+    uint64_t runs;
+    Alloc_Count count;
+} Alloc_Phase;
+
+typedef struct {
+    void* ptr;  // NULL for a free slot
+    size_t size;
+    uint32_t site;
+    uint32_t phase;
+} Alloc_Block;
+
+static pthread_mutex_t alloc__mutex = PTHREAD_MUTEX_INITIALIZER;
+static bool alloc__exit_registered = false;
+
+static Alloc_Site* alloc__sites = NULL;
+static size_t alloc__site_count = 0;
+static size_t alloc__site_capacity = 0;
+static uint32_t* alloc__site_index = NULL;  // open addressing, site + 1, 0 for a free slot
+static size_t alloc__site_index_capacity = 0;
+
+static Alloc_Phase* alloc__phases = NULL;
+static size_t alloc__phase_count = 0;
+static size_t alloc__phase_capacity = 0;
+// Phases nest per thread, solvers running side by side in a batch each keep their own stack
+static _Thread_local uint32_t alloc__stack[ALLOC_MAX_DEPTH];
+static _Thread_local size_t alloc__depth = 0;
+static int alloc__day = 0;
+
+// The line that used the stb_ds macro running on this thread, file is NULL outside of one
+static _Thread_local const char* alloc__stbds_file = NULL;
+static _Thread_local int alloc__stbds_line = 0;
+static _Thread_local const char* alloc__stbds_func = NULL;
+
+static Alloc_Block* alloc__blocks = NULL;  // open addressing on the pointer, linear probing
+static size_t alloc__block_count = 0;
+static size_t alloc__block_capacity = 0;
+
+static Alloc_Count alloc__total = {0};
+
+static void* alloc__grow(void* items, size_t* capacity, size_t item_size) {
+    *capacity = *capacity ? *capacity * 2 : 64;
+    void* grown = (realloc)(items, *capacity * item_size);
+    if (grown == NULL) abort();
+    return grown;
+}
+
+static void alloc__add(Alloc_Count* count, size_t size) {
+    count->calls++;
+    count->bytes += size;
+    count->live += size;
+    if (count->live > count->peak) count->peak = count->live;
+}
+
+static uint64_t alloc__hash_site(const char* file, int line) {
+    uint64_t hash = 1469598103934665603ull;
+    for (const char* c = file; *c; ++c) hash = (hash ^ (unsigned char)*c) * 1099511628211ull;
+    return (hash ^ (uint64_t)line) * 1099511628211ull;
+}
+
+static void alloc__index_site(uint32_t site) {
+    size_t mask = alloc__site_index_capacity - 1;
+    size_t slot = alloc__hash_site(alloc__sites[site].file, alloc__sites[site].line) & mask;
+    while (alloc__site_index[slot] != 0) slot = (slot + 1) & mask;
+    alloc__site_index[slot] = site + 1;
+}
+
+static uint32_t alloc__site(const char* file, int line, const char* func) {
+    if (alloc__site_index_capacity > 0) {
+        size_t mask = alloc__site_index_capacity - 1;
+        for (size_t slot = alloc__hash_site(file, line) & mask; alloc__site_index[slot] != 0; slot = (slot + 1) & mask) {
+            const Alloc_Site* site = &alloc__sites[alloc__site_index[slot] - 1];
+            if (site->line == line && strcmp(site->file, file) == 0) return alloc__site_index[slot] - 1;
+        }
+    }
+
+    if (alloc__site_count == alloc__site_capacity) {
+        alloc__sites = alloc__grow(alloc__sites, &alloc__site_capacity, sizeof(Alloc_Site));
+    }
+    uint32_t site = (uint32_t)alloc__site_count++;
+    alloc__sites[site] = (Alloc_Site){.file = file, .line = line, .func = func};
+
+    // Keeps the index at most half full
+    if (alloc__site_count * 2 > alloc__site_index_capacity) {
+        (free)(alloc__site_index);
+        alloc__site_index_capacity = alloc__site_index_capacity ? alloc__site_index_capacity * 2 : 128;
+        alloc__site_index = (calloc)(alloc__site_index_capacity, sizeof(uint32_t));
+        if (alloc__site_index == NULL) abort();
+        for (uint32_t i = 0; i < alloc__site_count; ++i) alloc__index_site(i);
+    } else {
+        alloc__index_site(site);
+    }
+    return site;
+}
+
+static uint32_t alloc__phase(int day, const char* name) {
+    for (size_t i = 0; i < alloc__phase_count; ++i) {
+        if (alloc__phases[i].day == day && strcmp(alloc__phases[i].name, name) == 0) return (uint32_t)i;
+    }
+    if (alloc__phase_count == alloc__phase_capacity) {
+        alloc__phases = alloc__grow(alloc__phases, &alloc__phase_capacity, sizeof(Alloc_Phase));
+    }
+    alloc__phases[alloc__phase_count] = (Alloc_Phase){.day = day, .name = name};
+    return (uint32_t)alloc__phase_count++;
+}
+
+static size_t alloc__slot(const void* ptr) {
+    return (size_t)(((uintptr_t)ptr >> 4) * 11400714819323198485ull >> 20) & (alloc__block_capacity - 1);
+}
+
+static void alloc__insert(Alloc_Block block) {
+    size_t slot = alloc__slot(block.ptr);
+    while (alloc__blocks[slot].ptr != NULL) slot = (slot + 1) & (alloc__block_capacity - 1);
+    alloc__blocks[slot] = block;
+}
+
+static void alloc__report(void);
+
+static void alloc__track(void* ptr, size_t size, const char* file, int line, const char* func) {
+    pthread_mutex_lock(&alloc__mutex);
+    if (!alloc__exit_registered) {
+        alloc__exit_registered = true;
+        atexit(alloc__report);
+    }
+
+    if ((alloc__block_count + 1) * 2 > alloc__block_capacity) {
+        Alloc_Block* old = alloc__blocks;
+        size_t old_capacity = alloc__block_capacity;
+        alloc__block_capacity = old_capacity ? old_capacity * 2 : 1024;
+        alloc__blocks = (calloc)(alloc__block_capacity, sizeof(Alloc_Block));
+        if (alloc__blocks == NULL) abort();
+        for (size_t i = 0; i < old_capacity; ++i) {
+            if (old[i].ptr != NULL) alloc__insert(old[i]);
+        }
+        (free)(old);
+    }
+
+    uint32_t site = alloc__site(file, line, func);
+    uint32_t phase = alloc__depth > 0 ? alloc__stack[alloc__depth - 1] : alloc__phase(alloc__day, "-");
+    alloc__add(&alloc__sites[site].count, size);
+    alloc__add(&alloc__phases[phase].count, size);
+    alloc__add(&alloc__total, size);
+    alloc__insert((Alloc_Block){.ptr = ptr, .size = size, .site = site, .phase = phase});
+    alloc__block_count++;
+    pthread_mutex_unlock(&alloc__mutex);
+}
+
+static void alloc__untrack(void* ptr) {
+    pthread_mutex_lock(&alloc__mutex);
+    if (alloc__block_capacity == 0) {
+        pthread_mutex_unlock(&alloc__mutex);
+        return;
+    }
+
+    size_t mask = alloc__block_capacity - 1;
+    size_t slot = alloc__slot(ptr);
+    while (alloc__blocks[slot].ptr != NULL && alloc__blocks[slot].ptr != ptr) slot = (slot + 1) & mask;
+
+    if (alloc__blocks[slot].ptr == ptr) {
+        Alloc_Block block = alloc__blocks[slot];
+        alloc__sites[block.site].count.live -= block.size;
+        alloc__phases[block.phase].count.live -= block.size;
+        alloc__total.live -= block.size;
+        alloc__block_count--;
+
+        // Backward shift deletion, pulls later blocks of the probe run into the hole
+        size_t hole = slot;
+        for (size_t next = (hole + 1) & mask; alloc__blocks[next].ptr != NULL; next = (next + 1) & mask) {
+            size_t home = alloc__slot(alloc__blocks[next].ptr);
+            if (((next - home) & mask) >= ((next - hole) & mask)) {
+                alloc__blocks[hole] = alloc__blocks[next];
+                hole = next;
+            }
+        }
+        alloc__blocks[hole] = (Alloc_Block){0};
+    }
+    pthread_mutex_unlock(&alloc__mutex);
+}
+
+void* alloc__malloc(size_t size, const char* file, int line, const char* func) {
+    void* ptr = (malloc)(size);
+    if (ptr != NULL) alloc__track(ptr, size, file, line, func);
+    return ptr;
+}
+
+void* alloc__calloc(size_t count, size_t size, const char* file, int line, const char* func) {
+    void* ptr = (calloc)(count, size);
+    if (ptr != NULL) alloc__track(ptr, count * size, file, line, func);
+    return ptr;
+}
+
+void* alloc__realloc(void* ptr, size_t size, const char* file, int line, const char* func) {
+    // Untracked up front, ptr is dead once realloc() moved it. Should realloc() fail the old block
+    // stays live but is no longer counted.
+    if (ptr != NULL) alloc__untrack(ptr);
+    void* moved = (realloc)(ptr, size);
+    if (moved != NULL) alloc__track(moved, size, file, line, func);
+    return moved;
+}
+
+void* alloc__stbds_realloc(void* ptr, size_t size, const char* file, int line, const char* func) {
+    if (alloc__stbds_file != NULL) return alloc__realloc(ptr, size, alloc__stbds_file, alloc__stbds_line, alloc__stbds_func);
+    return alloc__realloc(ptr, size, file, line, func);
+}
+
+void alloc__stbds_begin(const char* file, int line, const char* func) {
+    alloc__stbds_file = file;
+    alloc__stbds_line = line;
+    alloc__stbds_func = func;
+}
+
+void* alloc__stbds_end(void* result) {
+    alloc__stbds_file = NULL;
+    return result;
+}
+
+char* alloc__strdup(const char* s, const char* file, int line, const char* func) {
+    size_t size = strlen(s) + 1;
+    char* copy = (malloc)(size);
+    if (copy == NULL) return NULL;
+    memcpy(copy, s, size);
+    alloc__track(copy, size, file, line, func);
+    return copy;
+}
+
+void alloc__free(void* ptr) {
+    if (ptr == NULL) return;
+    alloc__untrack(ptr);
+    (free)(ptr);
+}
+
+void alloc_set_day(int day) {
+    pthread_mutex_lock(&alloc__mutex);
+    alloc__day = day;
+    pthread_mutex_unlock(&alloc__mutex);
+}
+
+void alloc_begin(const char* name) {
+    pthread_mutex_lock(&alloc__mutex);
+    if (alloc__depth == ALLOC_MAX_DEPTH) abort();
+    uint32_t phase = alloc__phase(alloc__day, name);
+    alloc__phases[phase].runs++;
+    alloc__stack[alloc__depth++] = phase;
+    pthread_mutex_unlock(&alloc__mutex);
+}
+
+void alloc_end(void) {
+    pthread_mutex_lock(&alloc__mutex);
+    if (alloc__depth > 0) alloc__depth--;
+    pthread_mutex_unlock(&alloc__mutex);
+}
+
+static int alloc__compare_sites(const void* a, const void* b) {
+    uint64_t x = alloc__sites[*(const uint32_t*)a].count.calls;
+    uint64_t y = alloc__sites[*(const uint32_t*)b].count.calls;
+    return (x < y) - (x > y);
+}
+
+static void alloc__report(void) {
+    pthread_mutex_lock(&alloc__mutex);
+    FILE* out = stderr;
+
+    fprintf(out, "\nAllocations per phase\n");
+    fprintf(out, "%-4s %-12s %8s %12s %12s %14s %12s %12s\n", "day", "phase", "runs", "calls", "calls/run", "bytes",
+            "live", "peak");
+    for (size_t i = 0; i < alloc__phase_count; ++i) {
+        const Alloc_Phase* phase = &alloc__phases[i];
+        if (phase->count.calls == 0) continue;
+        double runs = phase->runs ? (double)phase->runs : 1.0;
+        fprintf(out, "%-4d %-12s %8llu %12llu %12.1f %14llu %12llu %12llu\n", phase->day, phase->name,
+                (unsigned long long)phase->runs, (unsigned long long)phase->count.calls, phase->count.calls / runs,
+                (unsigned long long)phase->count.bytes, (unsigned long long)phase->count.live,
+                (unsigned long long)phase->count.peak);
+    }
+    fprintf(out, "%-4s %-12s %8s %12llu %12s %14llu %12llu %12llu\n", "", "total", "", (unsigned long long)alloc__total.calls,
+            "", (unsigned long long)alloc__total.bytes, (unsigned long long)alloc__total.live,
+            (unsigned long long)alloc__total.peak);
+
+    uint32_t* order = (malloc)(alloc__site_count * sizeof(uint32_t) + 1);
+    if (order != NULL) {
+        for (uint32_t i = 0; i < alloc__site_count; ++i) order[i] = i;
+        qsort(order, alloc__site_count, sizeof(uint32_t), alloc__compare_sites);
+
+        size_t shown = alloc__site_count < ALLOC_TOP_SITES ? alloc__site_count : ALLOC_TOP_SITES;
+        fprintf(out, "\nAllocations per call site, top %zu of %zu by calls\n", shown, alloc__site_count);
+        fprintf(out, "%-36s %-24s %12s %14s %12s %12s\n", "site", "function", "calls", "bytes", "live", "peak");
+        for (size_t i = 0; i < shown; ++i) {
+            const Alloc_Site* site = &alloc__sites[order[i]];
+            char where[256];
+            snprintf(where, sizeof(where), "%s:%d", site->file, site->line);
+            fprintf(out, "%-36s %-24s %12llu %14llu %12llu %12llu\n", where, site->func,
+                    (unsigned long long)site->count.calls, (unsigned long long)site->count.bytes,
+                    (unsigned long long)site->count.live, (unsigned long long)site->count.peak);
+        }
+        (free)(order);
+    }
+    pthread_mutex_unlock(&alloc__mutex);
+}
+
+#endif  // AOC_ALLOC_IMPLEMENTATION
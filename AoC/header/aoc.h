@@ -0,0 +1,625 @@
+#ifndef AOC_AOC_H
+#define AOC_AOC_H
+
+// Uniform interface every day implements, and the command line driver that runs them.
+//
+// A day parses its input once into a state of its own choosing, both parts then read that state
+// (they must not modify it, so --repeat measures the same work every time). At the bottom of a day:
+//
+//     AOC_DAY(1, .name = "Secret Entrance", .input_path = "inputs/q1_input.txt",
+//             .parse = parse, .part_1 = part_1, .part_2 = part_2, .free = free_state)
+//
+// Built on its own the day gets a main() running just that day. Built with -DAOC_RUNNER it only
+// exports aoc_day_<n> instead, and src/aoc.c collects all of them into the `aoc` runner:
+//
+//     aoc [--day N] [--part 1|2] [--input PATH] [--warmup N] [--repeat N] [--format text|csv|json]
+//         [--report PATH] [--perf] [--save PATH] [--compare PATH] [--threshold PERCENT]
+//         [--cache PATH] [--cache-entries N] [--snapshot DIR] [--pipeline]
+//
+// Asking for warmup runs, repeats, a format or a report file turns on benchmarking: every phase
+// (parse, part1, part2) runs warmup + repeat times and the statistics of the repeats from bench.h are
+// written to the report (stderr by default) once all days have run. --perf adds the hardware counters
+// of perf.h to those rows, plus a row for every phase a solver marks with perf_begin()/perf_end().
+// --save writes the rows with their samples as a baseline, --compare checks them against one and
+// fails the run when a phase regressed (baseline.h). Both repeat every phase 10 times by default.
+//
+// --cache keeps the answers in a file and answers an input it has seen before without parsing it,
+// see cache.h. Benchmark runs ignore it. --snapshot writes the parsed state of the days that support
+// it to a folder and maps it back on the next run instead of parsing (snapshot.h), the parse row of a
+// benchmark is then called restore. --pipeline streams the input of the days made of independent
+// records through the reader, parser and solver threads of pipeline.h, timed as one pipeline phase.
+// Days with a .scan instead go over the lines once, timed as a scan phase.
+//
+// --input - reads stdin. A pipe is streamed like --pipeline by the days that can, the other days read
+// it into memory and parse it as usual. Benchmarks get one run out of a streamed pipe.
+//
+// Include nob.h and input.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before aoc.h"
+#endif
+#ifndef AOC_INPUT_H
+#error "include input.h before aoc.h"
+#endif
+
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arena.h"
+#include "bench.h"
+#include "baseline.h"
+#include "cache.h"
+#include "snapshot.h"
+#include "pipeline.h"
+#include "perf.h"
+#include "map_stats.h"
+
+typedef struct {
+    int number;
+    const char* name;
+    const char* input_path;                  // relative to the AoC folder
+    void* (*parse)(const Lines* lines);      // NULL result means the input was malformed
+    uint64_t (*part_1)(const void* state);
+    uint64_t (*part_2)(const void* state);   // NULL while the part is not solved yet
+    void (*free)(void* state);               // NULL when the state owns nothing, called as (day->free)() for alloc.h
+    // The straightforward solvers a fast part is checked against by `aoc diff` (diff.h), NULL while the
+    // part has only the one implementation
+    uint64_t (*reference_1)(const void* state);
+    uint64_t (*reference_2)(const void* state);
+    // The straightforward parse the references run on, for days whose fast work happens in .parse.
+    // NULL when the references share the state of .parse.
+    void* (*reference_parse)(const Lines* lines);
+    // Bumped whenever a change to the day can change its answers, `aoc --cache` (cache.h) keeps the
+    // answers of every version apart
+    uint32_t version;
+    // Binary snapshots of the parsed state for `aoc --snapshot` (snapshot.h), NULL for days that only
+    // parse. A restored state may point into the snapshot, it is freed with .free_restored (free() when
+    // NULL) while the snapshot is still mapped.
+    void (*save)(const void* state, Snapshot_Writer* out);
+    void* (*restore)(const Snapshot* snapshot);  // NULL result means the snapshot was malformed
+    void (*free_restored)(void* state);
+    // The records of the input for `aoc --pipeline` (pipeline.h), NULL when a part needs the whole input
+    const Pipeline_Stream* stream;
+    // .parse only reads lines->text (parallel_parse.h), so the runner does not index the lines
+    bool text_only;
+    // One pass over the lines of a pipe (`aoc --input -`, input.h) as they come in, for days whose parts
+    // only need the lines seen so far. Adds the answers of both parts, false means malformed input.
+    bool (*scan)(Line_Stream* lines, uint64_t answers[2]);
+} Aoc_Day;
+
+#ifdef AOC_RUNNER
+#define AOC_DAY(day_number, ...) const Aoc_Day aoc_day_##day_number = {.number = day_number, __VA_ARGS__};
+#else
+#define AOC_DAY(day_number, ...)                                         \
+    int main(int argc, char** argv) {                                    \
+        static const Aoc_Day day = {.number = day_number, __VA_ARGS__}; \
+        const Aoc_Day* days[] = {&day};                                 \
+        return aoc_main(days, 1, argc, argv);                           \
+    }
+#endif
+
+// Parser for the days whose parts walk the input lines directly, the line index is their state.
+static inline void* aoc_parse_lines(const Lines* lines) {
+    return (void*)lines;
+}
+
+typedef struct {
+    int day;          // 0 runs every day
+    int part;         // 0 runs both parts
+    const char* input;
+    size_t warmup;
+    size_t repeat;
+    bool bench;       // collect and print timing statistics
+    Bench_Format format;
+    const char* report;  // NULL prints the report to stderr
+    bool perf;           // hardware counters per phase
+    const char* save;     // baseline to write
+    const char* compare;  // baseline to check against
+    double threshold;     // percent a median may grow before it counts as a regression
+    const char* cache;    // answer cache, NULL solves every input
+    size_t cache_entries;
+    const char* snapshot;  // folder of parsed states, NULL parses every input
+    bool pipeline;         // stream the days that have a Pipeline_Stream or a .scan
+} Aoc_Options;
+
+static inline void aoc__usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s [--day N] [--part 1|2] [--input PATH] [--warmup N] [--repeat N] "
+            "[--format text|csv|json] [--report PATH] [--perf] [--save PATH] [--compare PATH] "
+            "[--threshold PERCENT] [--cache PATH] [--cache-entries N] [--snapshot DIR] [--pipeline]\n",
+            program);
+}
+
+static inline bool aoc__parse_count(const char* flag, const char* value, long min, long max, long* out) {
+    char* end = NULL;
+    long parsed = value ? strtol(value, &end, 10) : 0;
+    if (value == NULL || *end != '\0' || parsed < min || parsed > max) {
+        nob_log(NOB_ERROR, "%s expects a number between %ld and %ld", flag, min, max);
+        return false;
+    }
+    *out = parsed;
+    return true;
+}
+
+static inline bool aoc_parse_options(int argc, char** argv, Aoc_Options* options) {
+    const char* program = nob_shift(argv, argc);
+    *options = (Aoc_Options){.repeat = 1, .format = BENCH_TEXT, .threshold = BASELINE_DEFAULT_THRESHOLD};
+    bool repeat_given = false;
+
+    while (argc > 0) {
+        const char* flag = nob_shift(argv, argc);
+        const char* value = argc > 0 ? argv[0] : NULL;
+        long parsed = 0;
+
+        if (strcmp(flag, "--day") == 0) {
+            if (!aoc__parse_count(flag, value, 1, 25, &parsed)) return false;
+            options->day = (int)parsed;
+        } else if (strcmp(flag, "--part") == 0) {
+            if (!aoc__parse_count(flag, value, 1, 2, &parsed)) return false;
+            options->part = (int)parsed;
+        } else if (strcmp(flag, "--warmup") == 0) {
+            if (!aoc__parse_count(flag, value, 0, 1000000000, &parsed)) return false;
+            options->warmup = (size_t)parsed;
+            options->bench = true;
+        } else if (strcmp(flag, "--repeat") == 0) {
+            if (!aoc__parse_count(flag, value, 1, 1000000000, &parsed)) return false;
+            options->repeat = (size_t)parsed;
+            options->bench = options->bench || parsed > 1;
+            repeat_given = true;
+        } else if (strcmp(flag, "--format") == 0) {
+            if (value == NULL || !bench_parse_format(value, &options->format)) {
+                nob_log(NOB_ERROR, "--format expects text, csv or json");
+                return false;
+            }
+            options->bench = true;
+        } else if (strcmp(flag, "--report") == 0) {
+            if (value == NULL) {
+                nob_log(NOB_ERROR, "--report expects a path");
+                return false;
+            }
+            options->report = value;
+            options->bench = true;
+        } else if (strcmp(flag, "--perf") == 0) {
+            options->perf = true;
+            options->bench = true;
+            continue;  // takes no value
+        } else if (strcmp(flag, "--pipeline") == 0) {
+            options->pipeline = true;
+            continue;  // takes no value
+        } else if (strcmp(flag, "--save") == 0 || strcmp(flag, "--compare") == 0) {
+            if (value == NULL) {
+                nob_log(NOB_ERROR, "%s expects a path", flag);
+                return false;
+            }
+            *(strcmp(flag, "--save") == 0 ? &options->save : &options->compare) = value;
+            options->bench = true;
+        } else if (strcmp(flag, "--threshold") == 0) {
+            if (!aoc__parse_count(flag, value, 0, 1000, &parsed)) return false;
+            options->threshold = (double)parsed;
+        } else if (strcmp(flag, "--cache") == 0) {
+            if (value == NULL) {
+                nob_log(NOB_ERROR, "--cache expects a path");
+                return false;
+            }
+            options->cache = value;
+        } else if (strcmp(flag, "--cache-entries") == 0) {
+            if (!aoc__parse_count(flag, value, 2, 1000000000, &parsed)) return false;
+            options->cache_entries = (size_t)parsed;
+        } else if (strcmp(flag, "--snapshot") == 0) {
+            if (value == NULL) {
+                nob_log(NOB_ERROR, "--snapshot expects a folder");
+                return false;
+            }
+            options->snapshot = value;
+        } else if (strcmp(flag, "--input") == 0) {
+            if (value == NULL) {
+                nob_log(NOB_ERROR, "--input expects a path, or - for stdin");
+                return false;
+            }
+            options->input = value;
+        } else {
+            if (strcmp(flag, "--help") != 0 && strcmp(flag, "-h") != 0) {
+                nob_log(NOB_ERROR, "Unknown flag %s", flag);
+            }
+            aoc__usage(program);
+            return false;
+        }
+        nob_shift(argv, argc);
+    }
+
+    // A single run per phase gives the regression test nothing to work with
+    if ((options->save || options->compare) && !repeat_given) options->repeat = BASELINE_DEFAULT_REPEAT;
+    return true;
+}
+
+static inline void aoc__add_row(Bench_Report* report, const Aoc_Options* options, int day, const char* phase,
+                                Bench_Samples* samples) {
+    if (options->bench) {
+        Bench_Row row = {.day = day, .phase = phase, .stats = bench_stats(samples)};
+
+        // The timing stays the one of the repeats, the counters come from every run of the phase
+        const Perf_Phase* measured = options->perf ? perf_find(day, phase) : NULL;
+        if (measured) {
+            Bench_Row counted = perf_row(measured);
+            row.elements = counted.elements;
+            row.counter_mask = counted.counter_mask;
+            memcpy(row.counters, counted.counters, sizeof(row.counters));
+        }
+        if (options->save || options->compare) {
+            nob_da_append_many(&row.samples, samples->items, samples->count);
+        }
+        nob_da_append(report, row);
+    }
+    samples->count = 0;
+}
+
+// The phases the runner times itself, they have their rows already
+static inline bool aoc__runner_phase(const char* name) {
+    return strcmp(name, "parse") == 0 || strcmp(name, "restore") == 0 || strcmp(name, "pipeline") == 0 ||
+           strcmp(name, "part1") == 0 || strcmp(name, "part2") == 0;
+}
+
+// Rows for the phases a day marked itself, after its parse, part1 and part2 rows
+static inline void aoc__add_perf_rows(Bench_Report* report, int day) {
+    const Perf_Phases* phases = perf_phases();
+    for (size_t i = 0; i < phases->count; ++i) {
+        const Perf_Phase* phase = &phases->items[i];
+        if (phase->day != day) continue;
+        if (aoc__runner_phase(phase->name)) continue;
+        nob_da_append(report, perf_row(phase));
+    }
+}
+
+// Runs one part warmup + repeat times against the parsed state and prints the answer.
+static inline bool aoc__run_part(const Aoc_Day* day, int part, const void* state, size_t elements,
+                                 const Aoc_Options* options, Bench_Samples* samples, Bench_Report* report,
+                                 uint64_t* out) {
+    uint64_t (*solve)(const void*) = part == 1 ? day->part_1 : day->part_2;
+    if (solve == NULL) {
+        nob_log(NOB_WARNING, "Day %d has no part %d yet", day->number, part);
+        return false;
+    }
+
+    uint64_t answer = 0;
+    size_t runs = options->warmup + options->repeat;
+    for (size_t i = 0; i < runs; ++i) {
+        perf_begin(part == 1 ? "part1" : "part2");
+        uint64_t start = bench_now_ns();
+        answer = solve(state);
+        uint64_t elapsed = bench_now_ns() - start;
+        perf_end(elements);
+        if (i >= options->warmup) nob_da_append(samples, elapsed);
+    }
+
+    printf("Password (Part %d) : %" PRIu64 "\n", part, answer);
+    fflush(stdout);
+    aoc__add_row(report, options, day->number, part == 1 ? "part1" : "part2", samples);
+    *out = answer;
+    return true;
+}
+
+static inline Cache_Record aoc__cache_key(const Aoc_Day* day, int part, uint64_t hash, size_t size) {
+    return (Cache_Record){.hash = hash, .size = size, .version = day->version, .day = (uint8_t)day->number,
+                          .part = (uint8_t)part};
+}
+
+// Prints the answers of the parts from the cache when it has all of them, cached[] says which it had
+static inline bool aoc__answers_from_cache(const Aoc_Day* day, const bool wanted[2], Cache* cache, uint64_t hash,
+                                           size_t size, bool cached[2]) {
+    uint64_t start = bench_now_ns();
+    uint64_t answers[2] = {0};
+    size_t indices[2] = {0};
+    bool all = true;
+    for (int part = 1; part <= 2; ++part) {
+        if (!wanted[part - 1]) continue;
+        Cache_Record key = aoc__cache_key(day, part, hash, size);
+        cached[part - 1] = cache_lookup(cache, &key, &answers[part - 1], &indices[part - 1]);
+        all = all && cached[part - 1];
+    }
+    if (!all) return false;
+
+    for (int part = 1; part <= 2; ++part) {
+        if (!wanted[part - 1]) continue;
+        printf("Password (Part %d) : %" PRIu64 "\n", part, answers[part - 1]);
+        Cache_Record key = aoc__cache_key(day, part, hash, size);
+        cache_touch(cache, &key, answers[part - 1], indices[part - 1]);
+    }
+    fflush(stdout);
+    nob_log(NOB_INFO, "Day %d answered from %s in %.1f us", day->number, cache->path,
+            (bench_now_ns() - start) / 1e3);
+    return true;
+}
+
+static inline void aoc__free_state(const Aoc_Day* day, void* state, bool restored) {
+    if (!restored) {
+        if (day->free) (day->free)(state);
+    } else if (day->free_restored) {
+        (day->free_restored)(state);
+    } else {
+        free(state);
+    }
+}
+
+// Writes the parsed state for the next run, a snapshot that cannot be written only costs that run
+static inline void aoc__save_snapshot(const Aoc_Day* day, const Aoc_Options* options, const void* state,
+                                      uint64_t hash, size_t size) {
+    if (!nob_mkdir_if_not_exists(options->snapshot)) return;
+    Snapshot_Writer writer = {0};
+    day->save(state, &writer);
+    const char* path = snapshot_path(options->snapshot, day->number, hash);
+    if (snapshot_write(path, &writer, day->number, day->version, hash, size)) {
+        nob_log(NOB_INFO, "Saved the parsed state to %s", path);
+    }
+    snapshot_writer_free(&writer);
+}
+
+// One pass of the day's .scan over the lines of fd
+static inline bool aoc__scan(const Aoc_Day* day, int fd, uint64_t answers[2]) {
+    Line_Stream lines;
+    line_stream_init(&lines, fd);
+    bool ok = day->scan(&lines, answers) && !lines.failed;
+    line_stream_free(&lines);
+    return ok;
+}
+
+// Streams the input through the day's pipeline, or its scan when it has none, both parts in one go.
+// A file is read warmup + repeat times, a pipe only the once. Takes over fd, unless the pipeline could
+// not start its threads: then *serial is set and fd, not read from, is left for the regular parse.
+static inline bool aoc__run_stream(const Aoc_Day* day, const Aoc_Options* options, const char* path, int fd,
+                                   const bool wanted[2], Bench_Report* report, bool* serial) {
+    const char* phase = day->stream ? "pipeline" : "scan";
+    if (strcmp(path, "-") == 0) path = "stdin";
+    size_t runs = options->bench ? options->warmup + options->repeat : 1;
+    if (runs > 1 && !input_is_file(fd)) {
+        nob_log(NOB_WARNING, "%s can only be read once, timing a single run", path);
+        runs = 1;
+    }
+
+    Bench_Samples samples = {0};
+    uint64_t answers[2] = {0};
+    for (size_t i = 0; i < runs; ++i) {
+        if (i > 0 && lseek(fd, 0, SEEK_SET) < 0) {
+            nob_log(NOB_ERROR, "Could not rewind %s: %s", path, strerror(errno));
+            nob_da_free(samples);
+            close(fd);
+            return false;
+        }
+
+        answers[0] = answers[1] = 0;
+        perf_begin(phase);
+        uint64_t start = bench_now_ns();
+        Pipeline_Result result = PIPELINE_OK;
+        if (day->stream) {
+            result = pipeline_run(day->stream, fd, answers);
+        } else if (!aoc__scan(day, fd, answers)) {
+            result = PIPELINE_FAILED;
+        }
+        uint64_t elapsed = bench_now_ns() - start;
+        perf_end(0);
+
+        if (result == PIPELINE_NO_THREADS) {
+            nob_log(NOB_WARNING, "Day %d parses %s without the pipeline", day->number, path);
+            nob_da_free(samples);
+            *serial = true;
+            return false;
+        }
+        if (result == PIPELINE_FAILED) {
+            nob_log(NOB_ERROR, "Day %d could not stream %s", day->number, path);
+            nob_da_free(samples);
+            close(fd);
+            return false;
+        }
+        if (i >= options->warmup || runs == 1) nob_da_append(&samples, elapsed);
+    }
+    close(fd);
+    aoc__add_row(report, options, day->number, phase, &samples);
+
+    for (int part = 1; part <= 2; ++part) {
+        if (!wanted[part - 1]) continue;
+        if ((part == 1 ? day->part_1 : day->part_2) == NULL) {
+            nob_log(NOB_WARNING, "Day %d has no part %d yet", day->number, part);
+            continue;
+        }
+        printf("Password (Part %d) : %" PRIu64 "\n", part, answers[part - 1]);
+    }
+    fflush(stdout);
+    if (options->perf) aoc__add_perf_rows(report, day->number);
+    nob_da_free(samples);
+    return true;
+}
+
+static inline bool aoc_run_day(const Aoc_Day* day, const Aoc_Options* options, Cache* cache, Bench_Report* report) {
+    TRACE_SCOPE(day->name);
+    perf_set_day(day->number);
+    const char* path = options->input ? options->input : day->input_path;
+
+    // Unsolved parts are skipped quietly unless they were asked for
+    bool wanted[2] = {
+        options->part == 1 || (options->part == 0 && day->part_1),
+        options->part == 2 || (options->part == 0 && day->part_2),
+    };
+    int fd = input_open(path);
+    if (fd < 0) return false;
+
+    // Pipes are read as they come in by the days that can, the others read them to the end first
+    if ((day->stream || day->scan) && (options->pipeline || !input_is_file(fd))) {
+        bool serial = false;
+        bool ok = aoc__run_stream(day, options, path, fd, wanted, report, &serial);
+        if (!serial) return ok;
+    }
+
+    Input input = {0};
+    if (!input_map_fd(fd, path, &input)) return false;
+
+    // A part without a solver still has to warn, so only days that can answer everything use the cache
+    bool snapshots = options->snapshot && day->save && day->restore;
+    uint64_t hash = cache || snapshots ? cache_hash(input.data, input.size, 0) : 0;
+    bool cached[2] = {0};
+    if (cache && (!wanted[0] || day->part_1) && (!wanted[1] || day->part_2)) {
+        if (aoc__answers_from_cache(day, wanted, cache, hash, input.size, cached)) {
+            input_free(&input);
+            return true;
+        }
+    }
+
+    // A snapshot replaces the parsing, the lines are not even indexed. Neither are they for days that
+    // parse the text themselves.
+    Snapshot snapshot = {0};
+    const char* snapshot_file = snapshots ? snapshot_path(options->snapshot, day->number, hash) : NULL;
+    bool restored = snapshots && snapshot_open(snapshot_file, day->number, day->version, hash, input.size, &snapshot);
+    if (!restored && !day->text_only) input_index_lines(&input);
+    const char* phase = restored ? "restore" : "parse";
+
+    // Parsing is timed like the parts, every run but the last frees its state right away
+    Bench_Samples samples = {0};
+    void* state = NULL;
+    size_t runs = options->bench ? options->warmup + options->repeat : 1;
+    for (size_t i = 0; i < runs; ++i) {
+        perf_begin(phase);
+        uint64_t start = bench_now_ns();
+        state = restored ? day->restore(&snapshot) : day->parse(&input.lines);
+        uint64_t elapsed = bench_now_ns() - start;
+        perf_end(input.lines.count);
+
+        if (state == NULL) {
+            if (restored) {
+                nob_log(NOB_ERROR, "Day %d could not restore %s, delete it to parse %s again", day->number,
+                        snapshot_file, path);
+            } else {
+                nob_log(NOB_ERROR, "Day %d could not parse %s", day->number, path);
+            }
+            nob_da_free(samples);
+            snapshot_close(&snapshot);
+            input_free(&input);
+            return false;
+        }
+        if (i >= options->warmup || !options->bench) nob_da_append(&samples, elapsed);
+        if (i + 1 < runs) aoc__free_state(day, state, restored);
+    }
+    aoc__add_row(report, options, day->number, phase, &samples);
+    if (snapshots && !restored) aoc__save_snapshot(day, options, state, hash, input.size);
+
+    for (int part = 1; part <= 2; ++part) {
+        uint64_t answer = 0;
+        if (!wanted[part - 1]) continue;
+        if (!aoc__run_part(day, part, state, input.lines.count, options, &samples, report, &answer)) continue;
+        if (cache && !cached[part - 1]) {
+            Cache_Record key = aoc__cache_key(day, part, hash, input.size);
+            cache_store(cache, &key, answer);
+        }
+    }
+    if (options->perf) aoc__add_perf_rows(report, day->number);
+
+    aoc__free_state(day, state, restored);
+    snapshot_close(&snapshot);
+    nob_da_free(samples);
+    input_free(&input);
+    return true;
+}
+
+static inline bool aoc__write_report(const Aoc_Options* options, const Bench_Report* report) {
+    if (options->report == NULL) {
+        bench_print_report(stderr, report, options->format);
+        return true;
+    }
+
+    FILE* out = fopen(options->report, "w");
+    if (out == NULL) {
+        nob_log(NOB_ERROR, "Could not open %s: %s", options->report, strerror(errno));
+        return false;
+    }
+    bench_print_report(out, report, options->format);
+    fclose(out);
+    return true;
+}
+
+// Writes the baseline with --save and checks against the one loaded for --compare
+static inline bool aoc__check_baseline(const Aoc_Options* options, const Baseline* baseline,
+                                       const Bench_Report* report) {
+    bool ok = true;
+    if (options->compare) {
+        size_t regressions = baseline_compare(baseline, report, options->threshold, stderr);
+        if (regressions) {
+            nob_log(NOB_ERROR, "%zu phase%s regressed by more than %.0f%% against %s", regressions,
+                    regressions == 1 ? "" : "s", options->threshold, options->compare);
+            ok = false;
+        }
+    }
+    if (options->save) {
+        FILE* out = fopen(options->save, "w");
+        if (out == NULL) {
+            nob_log(NOB_ERROR, "Could not open %s: %s", options->save, strerror(errno));
+            return false;
+        }
+        bench_print_report(out, report, BENCH_JSON);
+        fclose(out);
+        nob_log(NOB_INFO, "Saved the baseline to %s", options->save);
+    }
+    return ok;
+}
+
+static inline int aoc_main(const Aoc_Day* const* days, size_t count, int argc, char** argv) {
+    Aoc_Options options;
+    if (!aoc_parse_options(argc, argv, &options)) return 1;
+
+    if (options.input && options.day == 0 && count > 1) {
+        nob_log(NOB_ERROR, "--input needs --day to know which solver reads it");
+        return 1;
+    }
+
+    // Loaded before anything runs, a missing baseline should not cost a whole benchmark run first
+    Baseline baseline = {0};
+    if (options.compare && !baseline_load(options.compare, &baseline)) return 1;
+
+    Cache cache_storage = {.fd = -1};
+    Cache* cache = NULL;
+    if (options.cache && options.bench) {
+        nob_log(NOB_WARNING, "Benchmark runs solve every input, ignoring --cache");
+    } else if (options.cache) {
+        if (!cache_open(options.cache, options.cache_entries, &cache_storage)) {
+            baseline_free(&baseline);
+            return 1;
+        }
+        cache = &cache_storage;
+    }
+
+    if (options.perf) perf_start();
+
+    Bench_Report report = {0};
+    bool found = false;
+    for (size_t i = 0; i < count; ++i) {
+        const Aoc_Day* day = days[i];
+        if (options.day != 0 && options.day != day->number) continue;
+        found = true;
+
+        if (count > 1) {
+            printf("--- Day %d: %s ---\n", day->number, day->name);
+            fflush(stdout);
+        }
+        if (!aoc_run_day(day, &options, cache, &report)) {
+            if (cache) cache_close(cache);
+            return 1;
+        }
+    }
+
+    if (!found) {
+        nob_log(NOB_ERROR, "There is no day %d", options.day);
+        if (cache) cache_close(cache);
+        return 1;
+    }
+
+    bool ok = !options.bench || aoc__write_report(&options, &report);
+    ok = aoc__check_baseline(&options, &baseline, &report) && ok;
+    map_stats_print(stderr);
+    if (options.perf) perf_stop();
+    if (cache) cache_close(cache);
+    baseline_free(&baseline);
+    bench_report_free(&report);
+    return ok ? 0 : 1;
+}
+
+#endif  // AOC_AOC_H
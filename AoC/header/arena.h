@@ -0,0 +1,185 @@
+#ifndef AOC_ARENA_H
+#define AOC_ARENA_H
+
+// Growable bump allocator, a replacement for the fixed NOB_TEMP_CAPACITY temp buffer of nob.h.
+//
+// Memory comes from a linked list of blocks. When the current block is full the next one is reused
+// (after a rewind/reset) or a new one is linked in, so nothing is ever copied and pointers stay
+// valid until they are rewound past. The save/rewind/reset calls mirror nob_temp_save(),
+// nob_temp_rewind() and nob_temp_reset().
+//
+//     Arena arena = {.huge_pages = true};
+//     char* line = arena_sv_to_cstr(&arena, sv);
+//     ...
+//     arena_free(&arena);
+//
+// With huge_pages set, blocks are mapped with MAP_HUGETLB when the system has huge pages reserved
+// and fall back to transparent huge pages (MADV_HUGEPAGE) otherwise.
+//
+// Include nob.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before arena.h"
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define ARENA_DEFAULT_BLOCK_SIZE (8 * 1024 * 1024)
+#define ARENA_HUGE_PAGE_SIZE (2 * 1024 * 1024)
+#define ARENA_ALIGNMENT 16
+
+typedef struct Arena_Block {
+    struct Arena_Block* next;
+    size_t capacity;  // usable bytes in data
+    size_t used;
+    size_t mapped;    // size of the mapping, 0 when the block came from malloc()
+    char data[];
+} Arena_Block;
+
+typedef struct {
+    Arena_Block* first;
+    Arena_Block* current;
+    size_t block_size;  // 0 means ARENA_DEFAULT_BLOCK_SIZE
+    bool huge_pages;
+} Arena;
+
+typedef struct {
+    Arena_Block* block;
+    size_t used;
+} Arena_Mark;
+
+static inline size_t arena__align(size_t n, size_t alignment) {
+    return (n + alignment - 1) & ~(alignment - 1);
+}
+
+static inline Arena_Block* arena__new_block(Arena* arena, size_t min_capacity) {
+    size_t block_size = arena->block_size ? arena->block_size : ARENA_DEFAULT_BLOCK_SIZE;
+    size_t size = sizeof(Arena_Block) + (min_capacity > block_size ? min_capacity : block_size);
+    Arena_Block* block = NULL;
+
+    if (arena->huge_pages) {
+        size = arena__align(size, ARENA_HUGE_PAGE_SIZE);
+        void* data = MAP_FAILED;
+#ifdef MAP_HUGETLB
+        data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+        if (data == MAP_FAILED) {
+            // No reserved huge pages, let the kernel back the block with transparent ones instead
+            data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+#ifdef MADV_HUGEPAGE
+            if (data != MAP_FAILED) madvise(data, size, MADV_HUGEPAGE);
+#endif
+        }
+        NOB_ASSERT(data != MAP_FAILED && "Buy more RAM lol");
+        block = data;
+        block->mapped = size;
+    } else {
+        block = malloc(size);
+        NOB_ASSERT(block != NULL && "Buy more RAM lol");
+        block->mapped = 0;
+    }
+
+    block->next = NULL;
+    block->capacity = size - sizeof(Arena_Block);
+    block->used = 0;
+    return block;
+}
+
+static inline void* arena_alloc(Arena* arena, size_t size) {
+    size = arena__align(size ? size : 1, ARENA_ALIGNMENT);
+
+    if (arena->current == NULL) {
+        arena->first = arena->current = arena__new_block(arena, size);
+    }
+
+    Arena_Block* block = arena->current;
+    while (block->used + size > block->capacity) {
+        if (block->next == NULL || block->next->capacity < size) {
+            // Link a fresh block in front of the (too small) leftovers, they are reused later
+            Arena_Block* fresh = arena__new_block(arena, size);
+            fresh->next = block->next;
+            block->next = fresh;
+        }
+        block = block->next;
+        block->used = 0;
+    }
+
+    arena->current = block;
+    void* result = block->data + block->used;
+    block->used += size;
+    return result;
+}
+
+static inline char* arena_strndup(Arena* arena, const char* cstr, size_t n) {
+    char* result = arena_alloc(arena, n + 1);
+    memcpy(result, cstr, n);
+    result[n] = '\0';
+    return result;
+}
+
+static inline char* arena_strdup(Arena* arena, const char* cstr) {
+    return arena_strndup(arena, cstr, strlen(cstr));
+}
+
+static inline char* arena_sv_to_cstr(Arena* arena, Nob_String_View sv) {
+    return arena_strndup(arena, sv.data, sv.count);
+}
+
+static inline Arena_Mark arena_save(const Arena* arena) {
+    return (Arena_Mark){
+        .block = arena->current,
+        .used = arena->current ? arena->current->used : 0,
+    };
+}
+
+// Everything allocated after the mark is released. The blocks stay linked and are reused.
+static inline void arena_rewind(Arena* arena, Arena_Mark mark) {
+    if (mark.block == NULL) {
+        arena->current = arena->first;
+        if (arena->current) arena->current->used = 0;
+        return;
+    }
+    arena->current = mark.block;
+    arena->current->used = mark.used;
+}
+
+static inline void arena_reset(Arena* arena) {
+    arena_rewind(arena, (Arena_Mark){0});
+}
+
+// Moves the blocks of other in front of those of arena, which frees them along with its own. What was
+// allocated from other stays valid, other is left empty.
+static inline void arena_adopt(Arena* arena, Arena* other) {
+    if (other->first == NULL) return;
+    if (arena->first == NULL) {
+        arena->first = other->first;
+        arena->current = other->current;
+    } else {
+        Arena_Block* last = other->first;
+        while (last->next) last = last->next;
+        last->next = arena->first;
+        arena->first = other->first;
+    }
+    other->first = other->current = NULL;
+}
+
+static inline void arena_free(Arena* arena) {
+    Arena_Block* block = arena->first;
+    while (block) {
+        Arena_Block* next = block->next;
+        if (block->mapped) {
+            munmap(block, block->mapped);
+        } else {
+            free(block);
+        }
+        block = next;
+    }
+    arena->first = arena->current = NULL;
+}
+
+#endif  // AOC_ARENA_H
@@ -0,0 +1,188 @@
+#ifndef AOC_BASELINE_H
+#define AOC_BASELINE_H
+
+// Benchmark baselines and the regression check against them, `aoc --save` and `aoc --compare`.
+//
+//     aoc --save baseline.json                     # every day, 10 repeats per phase
+//     aoc --compare baseline.json [--threshold 10]  # exits with 1 when a phase got slower
+//
+// A baseline is the JSON report of bench.h with the samples of every row. Comparing matches the rows
+// by day and phase and calls a phase a regression only when all of these hold:
+//
+//   - its median grew by more than the threshold (percent, 10 by default),
+//   - by more than BASELINE_MIN_DELTA_NS, sub-microsecond phases are all noise,
+//   - and the Mann-Whitney test on both sets of samples says the new runs are slower with
+//     p < BASELINE_ALPHA.
+//
+// Rows with fewer than BASELINE_MIN_SAMPLES samples on either side cannot be tested, for them the
+// threshold alone decides. Phases only one side has are listed but never fail the check.
+//
+// Include nob.h and bench.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before baseline.h"
+#endif
+#ifndef AOC_BENCH_H
+#error "include bench.h before baseline.h"
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BASELINE_DEFAULT_REPEAT 10
+#define BASELINE_DEFAULT_THRESHOLD 10.0
+#define BASELINE_MIN_SAMPLES 5
+#define BASELINE_MIN_DELTA_NS 1000
+#define BASELINE_ALPHA 0.01
+
+typedef struct {
+    int day;
+    char phase[32];
+    uint64_t median_ns;
+    Bench_Samples samples;  // sorted
+} Baseline_Row;
+
+typedef struct {
+    Baseline_Row* items;
+    size_t count;
+    size_t capacity;
+} Baseline;
+
+static inline void baseline_free(Baseline* baseline) {
+    for (size_t i = 0; i < baseline->count; ++i) nob_da_free(baseline->items[i].samples);
+    nob_da_free(*baseline);
+    *baseline = (Baseline){0};
+}
+
+// Finds `"key":` between from and end, returns the first character of its value
+static inline const char* baseline__value(const char* from, const char* end, const char* key) {
+    size_t key_len = strlen(key);
+    for (const char* p = from; p + key_len + 2 < end; ++p) {
+        if (p[0] == '"' && memcmp(p + 1, key, key_len) == 0 && p[key_len + 1] == '"') {
+            p += key_len + 2;
+            while (p < end && (*p == ':' || *p == ' ')) ++p;
+            return p;
+        }
+    }
+    return NULL;
+}
+
+// Reads a JSON report as bench_print_report() writes it. Only the keys a comparison needs are
+// looked at, anything else in the rows is skipped.
+static inline bool baseline_load(const char* path, Baseline* baseline) {
+    Nob_String_Builder sb = {0};
+    if (!nob_read_entire_file(path, &sb)) return false;
+    nob_sb_append_null(&sb);
+
+    const char* end = sb.items + sb.count - 1;
+    const char* row = strstr(sb.items, "{\"day\"");
+    while (row) {
+        const char* next = strstr(row + 1, "{\"day\"");
+        const char* row_end = next ? next : end;
+
+        Baseline_Row parsed = {0};
+        const char* day = baseline__value(row, row_end, "day");
+        const char* phase = baseline__value(row, row_end, "phase");
+        const char* median = baseline__value(row, row_end, "median_ns");
+        if (day == NULL || phase == NULL || median == NULL || *phase != '"') {
+            nob_log(NOB_ERROR, "%s is not a benchmark report", path);
+            nob_sb_free(sb);
+            baseline_free(baseline);
+            return false;
+        }
+        parsed.day = (int)strtol(day, NULL, 10);
+        parsed.median_ns = strtoull(median, NULL, 10);
+        size_t phase_len = strcspn(phase + 1, "\"");
+        if (phase_len >= sizeof(parsed.phase)) phase_len = sizeof(parsed.phase) - 1;
+        memcpy(parsed.phase, phase + 1, phase_len);
+
+        const char* samples = baseline__value(row, row_end, "samples_ns");
+        if (samples && *samples == '[') {
+            char* p = (char*)samples + 1;
+            while (p < row_end && *p != ']') {
+                char* after = NULL;
+                uint64_t sample = strtoull(p, &after, 10);
+                if (after == p) break;
+                nob_da_append(&parsed.samples, sample);
+                p = after;
+                while (p < row_end && (*p == ',' || *p == ' ')) ++p;
+            }
+            qsort(parsed.samples.items, parsed.samples.count, sizeof(uint64_t), bench__cmp_u64);
+        }
+        nob_da_append(baseline, parsed);
+        row = next;
+    }
+
+    nob_sb_free(sb);
+    return true;
+}
+
+typedef enum {
+    BASELINE_SAME,
+    BASELINE_FASTER,
+    BASELINE_SLOWER,      // slower beyond the threshold but within the noise
+    BASELINE_REGRESSION,
+    BASELINE_NEW,
+} Baseline_Verdict;
+
+static inline const char* baseline__verdict_name(Baseline_Verdict verdict) {
+    switch (verdict) {
+        case BASELINE_SAME: return "same";
+        case BASELINE_FASTER: return "faster";
+        case BASELINE_SLOWER: return "noise";
+        case BASELINE_REGRESSION: return "REGRESSION";
+        case BASELINE_NEW: return "new";
+    }
+    return "?";
+}
+
+// Prints one line per row of the report to out and returns how many phases regressed
+static inline size_t baseline_compare(const Baseline* baseline, const Bench_Report* report, double threshold,
+                                      FILE* out) {
+    size_t regressions = 0;
+    fprintf(out, "%-4s %-12s %12s %12s %9s %9s %s\n", "day", "phase", "base ms", "now ms", "change", "p", "verdict");
+    for (size_t i = 0; i < report->count; ++i) {
+        const Bench_Row* row = &report->items[i];
+        const Baseline_Row* base = NULL;
+        for (size_t b = 0; b < baseline->count; ++b) {
+            if (baseline->items[b].day == row->day && strcmp(baseline->items[b].phase, row->phase) == 0) {
+                base = &baseline->items[b];
+            }
+        }
+        if (base == NULL) {
+            fprintf(out, "%-4d %-12s %12s %12.4f %9s %9s %s\n", row->day, row->phase, "-", row->stats.median / 1e6,
+                    "-", "-", baseline__verdict_name(BASELINE_NEW));
+            continue;
+        }
+
+        uint64_t now = row->stats.median;
+        double change = base->median_ns ? 100.0 * ((double)now / (double)base->median_ns - 1.0) : 0.0;
+        bool testable = base->samples.count >= BASELINE_MIN_SAMPLES && row->samples.count >= BASELINE_MIN_SAMPLES;
+        double p = testable ? bench_mann_whitney(base->samples.items, base->samples.count, row->samples.items,
+                                                 row->samples.count)
+                            : 0.0;
+
+        Baseline_Verdict verdict = BASELINE_SAME;
+        if (change > threshold && now > base->median_ns + BASELINE_MIN_DELTA_NS) {
+            verdict = p < BASELINE_ALPHA ? BASELINE_REGRESSION : BASELINE_SLOWER;
+        } else if (change < -threshold) {
+            verdict = BASELINE_FASTER;
+        }
+        if (verdict == BASELINE_REGRESSION) regressions++;
+
+        fprintf(out, "%-4d %-12s %12.4f %12.4f %+8.1f%% ", row->day, row->phase, base->median_ns / 1e6, now / 1e6,
+                change);
+        if (testable) {
+            fprintf(out, "%9.4f", p);
+        } else {
+            fprintf(out, "%9s", "-");
+        }
+        fprintf(out, " %s\n", baseline__verdict_name(verdict));
+    }
+    return regressions;
+}
+
+#endif  // AOC_BASELINE_H
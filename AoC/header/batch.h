@@ -0,0 +1,319 @@
+#ifndef AOC_BATCH_H
+#define AOC_BATCH_H
+
+// One day over every input file of a folder in a single process, `aoc --batch` in the runner.
+//
+//     aoc --day N --batch DIR [--part 1|2] [--order input|completion] [--format text|csv|json]
+//
+// The files of DIR (sorted by name, dot files skipped) are spread over the thread pool of pool.h,
+// every worker loads, parses and solves one file at a time. Results are written to stdout as they
+// come in: --order input (the default) holds a finished file back until all files before it are
+// out, --order completion writes every file the moment it is done. Failed files are reported too,
+// and make the command exit with 1. A summary with the throughput goes to stderr.
+//
+// The solvers themselves run serially on their worker, their own parallel loops included.
+//
+// Include nob.h, input.h, aoc.h and pool.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before batch.h"
+#endif
+#ifndef AOC_AOC_H
+#error "include aoc.h before batch.h"
+#endif
+#ifndef AOC_POOL_H
+#error "include pool.h before batch.h"
+#endif
+
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef enum {
+    BATCH_INPUT_ORDER,
+    BATCH_COMPLETION_ORDER,
+} Batch_Order;
+
+typedef struct {
+    int day;
+    int part;  // 0 runs both parts
+    const char* folder;
+    Batch_Order order;
+    Bench_Format format;
+} Batch_Options;
+
+typedef struct {
+    char* path;
+    bool done;
+    bool ok;
+    bool solved[2];
+    uint64_t answers[2];
+    uint64_t elapsed_ns;  // load, parse and solve
+} Batch_File;
+
+typedef struct {
+    Batch_File* items;
+    size_t count;
+    size_t capacity;
+} Batch_Files;
+
+typedef struct {
+    const Aoc_Day* day;
+    const Batch_Options* options;
+    Batch_Files files;
+
+    pthread_mutex_t lock;  // guards the fields below and stdout
+    size_t next;           // first file not written yet, for --order input
+    size_t written;
+    size_t failed;
+} Batch;
+
+static inline void batch__usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s --day N --batch DIR [--part 1|2] [--order input|completion] [--format text|csv|json]\n",
+            program);
+}
+
+static inline bool batch_parse_options(int argc, char** argv, Batch_Options* options) {
+    const char* program = nob_shift(argv, argc);
+    *options = (Batch_Options){.format = BENCH_TEXT};
+
+    while (argc > 0) {
+        const char* flag = nob_shift(argv, argc);
+        const char* value = argc > 0 ? argv[0] : NULL;
+        long parsed = 0;
+
+        if (strcmp(flag, "--day") == 0) {
+            if (!aoc__parse_count(flag, value, 1, 25, &parsed)) return false;
+            options->day = (int)parsed;
+        } else if (strcmp(flag, "--part") == 0) {
+            if (!aoc__parse_count(flag, value, 1, 2, &parsed)) return false;
+            options->part = (int)parsed;
+        } else if (strcmp(flag, "--batch") == 0) {
+            if (value == NULL) {
+                nob_log(NOB_ERROR, "--batch expects a folder");
+                return false;
+            }
+            options->folder = value;
+        } else if (strcmp(flag, "--order") == 0) {
+            if (value && strcmp(value, "input") == 0) {
+                options->order = BATCH_INPUT_ORDER;
+            } else if (value && strcmp(value, "completion") == 0) {
+                options->order = BATCH_COMPLETION_ORDER;
+            } else {
+                nob_log(NOB_ERROR, "--order expects input or completion");
+                return false;
+            }
+        } else if (strcmp(flag, "--format") == 0) {
+            if (value == NULL || !bench_parse_format(value, &options->format)) {
+                nob_log(NOB_ERROR, "--format expects text, csv or json");
+                return false;
+            }
+        } else {
+            if (strcmp(flag, "--help") != 0 && strcmp(flag, "-h") != 0) {
+                nob_log(NOB_ERROR, "Unknown flag %s", flag);
+            }
+            batch__usage(program);
+            return false;
+        }
+        nob_shift(argv, argc);
+    }
+
+    if (options->day == 0 || options->folder == NULL) {
+        nob_log(NOB_ERROR, "--batch needs --day to know which solver reads the files");
+        batch__usage(program);
+        return false;
+    }
+    return true;
+}
+
+static inline int batch__compare_paths(const void* a, const void* b) {
+    return strcmp(((const Batch_File*)a)->path, ((const Batch_File*)b)->path);
+}
+
+// The regular files of the folder, sorted so the input order does not depend on the file system
+static inline bool batch_collect_files(const char* folder, Batch_Files* files) {
+    Nob_File_Paths children = {0};
+    size_t checkpoint = nob_temp_save();
+    if (!nob_read_entire_dir(folder, &children)) return false;
+
+    for (size_t i = 0; i < children.count; ++i) {
+        if (children.items[i][0] == '.') continue;
+        char* path = strdup(nob_temp_sprintf("%s/%s", folder, children.items[i]));
+        NOB_ASSERT(path != NULL && "Buy more RAM lol");
+        if (nob_get_file_type(path) != NOB_FILE_REGULAR) {
+            free(path);
+            continue;
+        }
+        Batch_File file = {.path = path};
+        nob_da_append(files, file);
+    }
+    qsort(files->items, files->count, sizeof(*files->items), batch__compare_paths);
+
+    nob_da_free(children);
+    nob_temp_rewind(checkpoint);
+    return true;
+}
+
+// A file name as a JSON string: quotes, backslashes and control characters escaped
+static inline void batch__print_json_string(const char* text) {
+    putchar('"');
+    for (const unsigned char* c = (const unsigned char*)text; *c; ++c) {
+        switch (*c) {
+            case '"': fputs("\\\"", stdout); break;
+            case '\\': fputs("\\\\", stdout); break;
+            case '\n': fputs("\\n", stdout); break;
+            case '\r': fputs("\\r", stdout); break;
+            case '\t': fputs("\\t", stdout); break;
+            default:
+                if (*c < 0x20) {
+                    printf("\\u%04x", *c);
+                } else {
+                    putchar(*c);
+                }
+        }
+    }
+    putchar('"');
+}
+
+// A file name as a CSV field, quoted with its quotes doubled when it holds a separator, a quote or a
+// line break (RFC 4180)
+static inline void batch__print_csv_field(const char* text) {
+    if (strpbrk(text, ",\"\r\n") == NULL) {
+        fputs(text, stdout);
+        return;
+    }
+    putchar('"');
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"') putchar('"');
+        putchar(*c);
+    }
+    putchar('"');
+}
+
+// Called with the lock held
+static inline void batch__write(Batch* batch, const Batch_File* file) {
+    bool first = batch->written++ == 0;
+    switch (batch->options->format) {
+        case BENCH_TEXT:
+            if (!file->ok) {
+                printf("%s: failed\n", file->path);
+                break;
+            }
+            printf("%s:", file->path);
+            for (int part = 0; part < 2; ++part) {
+                if (file->solved[part]) printf(" part%d %" PRIu64, part + 1, file->answers[part]);
+            }
+            printf(" (%.3f ms)\n", file->elapsed_ns / 1e6);
+            break;
+
+        case BENCH_CSV:
+            if (first) printf("file,status,part1,part2,elapsed_ns\n");
+            batch__print_csv_field(file->path);
+            printf(",%s,", file->ok ? "ok" : "failed");
+            if (file->solved[0]) printf("%" PRIu64, file->answers[0]);
+            printf(",");
+            if (file->solved[1]) printf("%" PRIu64, file->answers[1]);
+            printf(",%" PRIu64 "\n", file->elapsed_ns);
+            break;
+
+        case BENCH_JSON:
+            printf("%s  {\"file\": ", first ? "[\n" : ",\n");
+            batch__print_json_string(file->path);
+            printf(", \"status\": \"%s\"", file->ok ? "ok" : "failed");
+            for (int part = 0; part < 2; ++part) {
+                if (file->solved[part]) printf(", \"part%d\": %" PRIu64, part + 1, file->answers[part]);
+            }
+            printf(", \"elapsed_ns\": %" PRIu64 "}", file->elapsed_ns);
+            break;
+    }
+    fflush(stdout);
+}
+
+static inline void batch__solve(const Batch* batch, Batch_File* file) {
+    const Aoc_Day* day = batch->day;
+    uint64_t start = bench_now_ns();
+
+    Input input = {0};
+    if (!input_load(file->path, &input)) return;
+    void* state = day->parse(&input.lines);
+    if (state == NULL) {
+        nob_log(NOB_ERROR, "Day %d could not parse %s", day->number, file->path);
+        input_free(&input);
+        return;
+    }
+
+    for (int part = 1; part <= 2; ++part) {
+        uint64_t (*solve)(const void*) = part == 1 ? day->part_1 : day->part_2;
+        if (solve == NULL || (batch->options->part != 0 && batch->options->part != part)) continue;
+        file->answers[part - 1] = solve(state);
+        file->solved[part - 1] = true;
+    }
+
+    if (day->free) (day->free)(state);
+    input_free(&input);
+    file->ok = true;
+    file->elapsed_ns = bench_now_ns() - start;
+}
+
+static inline void batch__files(size_t begin, size_t end, Pool_Worker* worker, void* ctx) {
+    (void)worker;
+    Batch* batch = ctx;
+
+    for (size_t i = begin; i < end; ++i) {
+        Batch_File* file = &batch->files.items[i];
+        batch__solve(batch, file);
+
+        pthread_mutex_lock(&batch->lock);
+        file->done = true;
+        if (!file->ok) batch->failed++;
+        if (batch->options->order == BATCH_COMPLETION_ORDER) {
+            batch__write(batch, file);
+        } else {
+            while (batch->next < batch->files.count && batch->files.items[batch->next].done) {
+                batch__write(batch, &batch->files.items[batch->next++]);
+            }
+        }
+        pthread_mutex_unlock(&batch->lock);
+    }
+}
+
+static inline int batch_main(const Aoc_Day* const* days, size_t count, int argc, char** argv) {
+    Batch_Options options;
+    if (!batch_parse_options(argc, argv, &options)) return 1;
+
+    Batch batch = {.options = &options};
+    for (size_t i = 0; i < count; ++i) {
+        if (days[i]->number == options.day) batch.day = days[i];
+    }
+    if (batch.day == NULL) {
+        nob_log(NOB_ERROR, "There is no day %d", options.day);
+        return 1;
+    }
+    if (!batch_collect_files(options.folder, &batch.files)) return 1;
+    if (batch.files.count == 0) {
+        nob_log(NOB_ERROR, "There are no files in %s", options.folder);
+        return 1;
+    }
+
+    perf_set_day(options.day);
+    pthread_mutex_init(&batch.lock, NULL);
+    uint64_t start = bench_now_ns();
+    parallel_for(0, batch.files.count, 1, batch__files, &batch);
+    uint64_t elapsed = bench_now_ns() - start;
+    pthread_mutex_destroy(&batch.lock);
+    if (options.format == BENCH_JSON) printf("\n]\n");
+
+    nob_log(NOB_INFO, "%zu files in %.3f ms on %zu threads (%.1f files/s), %zu failed", batch.files.count,
+            elapsed / 1e6, pool_worker_count(), batch.files.count / (elapsed / 1e9), batch.failed);
+
+    for (size_t i = 0; i < batch.files.count; ++i) free(batch.files.items[i].path);
+    nob_da_free(batch.files);
+    return batch.failed ? 1 : 0;
+}
+
+#endif  // AOC_BATCH_H
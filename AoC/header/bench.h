@@ -0,0 +1,296 @@
+#ifndef AOC_BENCH_H
+#define AOC_BENCH_H
+
+// Timing samples and the statistics every benchmark in the repo reports.
+//
+//     Bench_Samples samples = {0};
+//     for (size_t i = 0; i < warmup + repeat; ++i) {
+//         uint64_t start = bench_now_ns();
+//         work();
+//         if (i >= warmup) da_append(&samples, bench_now_ns() - start);
+//     }
+//     Bench_Stats stats = bench_stats(&samples);
+//
+// Reports are printed as an aligned text table, CSV or JSON. All values are in nanoseconds, the
+// text table shows milliseconds. Rows that carry hardware counters (see perf.h) get extra columns,
+// rows that kept their samples list them in JSON, which is the baseline format of baseline.h.
+//
+// Include nob.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before bench.h"
+#endif
+
+#include <inttypes.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef struct {
+    uint64_t* items;
+    size_t count;
+    size_t capacity;
+} Bench_Samples;
+
+typedef struct {
+    size_t runs;
+    uint64_t min;
+    uint64_t median;
+    uint64_t p90;
+    uint64_t p99;
+    double mean;
+    double stddev;
+} Bench_Stats;
+
+typedef enum {
+    BENCH_TEXT,
+    BENCH_CSV,
+    BENCH_JSON,
+} Bench_Format;
+
+// Hardware counters perf.h can attach to a row
+typedef enum {
+    BENCH_CYCLES,
+    BENCH_INSTRUCTIONS,
+    BENCH_L1D_MISSES,
+    BENCH_LLC_MISSES,
+    BENCH_BRANCH_MISSES,
+    BENCH_COUNTER_COUNT,
+} Bench_Counter;
+
+static const char* const bench_counter_names[BENCH_COUNTER_COUNT] = {
+    "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses",
+};
+
+typedef struct {
+    int day;
+    const char* phase;  // "parse", "part1", "part2" or anything else the caller measures
+    Bench_Stats stats;
+    uint64_t elements;                     // what one run processed, 0 when unknown
+    unsigned counter_mask;                 // bit per Bench_Counter that was measured, 0 for timers only
+    double counters[BENCH_COUNTER_COUNT];  // per run
+    Bench_Samples samples;                 // sorted, only kept for baselines, owned by the report
+} Bench_Row;
+
+typedef struct {
+    Bench_Row* items;
+    size_t count;
+    size_t capacity;
+} Bench_Report;
+
+static inline uint64_t bench_now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec;
+}
+
+static inline int bench__cmp_u64(const void* a, const void* b) {
+    uint64_t x = *(const uint64_t*)a;
+    uint64_t y = *(const uint64_t*)b;
+    return (x > y) - (x < y);
+}
+
+// Nearest rank percentile of sorted samples
+static inline uint64_t bench__percentile(const uint64_t* sorted, size_t count, double p) {
+    size_t rank = (size_t)ceil(p / 100.0 * (double)count);
+    if (rank == 0) rank = 1;
+    return sorted[rank - 1];
+}
+
+// Sorts the samples in place.
+static inline Bench_Stats bench_stats(Bench_Samples* samples) {
+    Bench_Stats stats = {.runs = samples->count};
+    if (samples->count == 0) return stats;
+
+    qsort(samples->items, samples->count, sizeof(*samples->items), bench__cmp_u64);
+
+    double sum = 0;
+    for (size_t i = 0; i < samples->count; ++i) sum += (double)samples->items[i];
+    stats.mean = sum / (double)samples->count;
+
+    double variance = 0;
+    for (size_t i = 0; i < samples->count; ++i) {
+        double diff = (double)samples->items[i] - stats.mean;
+        variance += diff * diff;
+    }
+    stats.stddev = samples->count > 1 ? sqrt(variance / (double)(samples->count - 1)) : 0.0;
+
+    stats.min = samples->items[0];
+    stats.median = bench__percentile(samples->items, samples->count, 50);
+    stats.p90 = bench__percentile(samples->items, samples->count, 90);
+    stats.p99 = bench__percentile(samples->items, samples->count, 99);
+    return stats;
+}
+
+static inline void bench_report_free(Bench_Report* report) {
+    for (size_t i = 0; i < report->count; ++i) nob_da_free(report->items[i].samples);
+    nob_da_free(*report);
+    *report = (Bench_Report){0};
+}
+
+// One sided p-value of the Mann-Whitney U test for the b samples being slower than the a samples.
+// Both must be sorted. Uses the normal approximation with the tie correction, which is close enough
+// from about 5 samples on each side. Unlike comparing means it does not care how the runs are
+// distributed, a few runs hit by an interrupt do not move it.
+static inline double bench_mann_whitney(const uint64_t* a, size_t n, const uint64_t* b, size_t m) {
+    if (n == 0 || m == 0) return 1.0;
+
+    // Merge both sorted sides, every run of equal values gets the average of its ranks
+    double rank_sum_b = 0;
+    double ties = 0;
+    size_t i = 0, j = 0;
+    while (i < n || j < m) {
+        uint64_t value = (j == m || (i < n && a[i] <= b[j])) ? a[i] : b[j];
+        size_t in_a = 0, in_b = 0;
+        while (i < n && a[i] == value) ++i, ++in_a;
+        while (j < m && b[j] == value) ++j, ++in_b;
+        double first = (double)(i + j - in_a - in_b) + 1;
+        double t = (double)(in_a + in_b);
+        rank_sum_b += (double)in_b * (first + (t - 1) / 2);
+        ties += t * t * t - t;
+    }
+
+    double total = (double)(n + m);
+    double u = rank_sum_b - (double)m * ((double)m + 1) / 2;
+    double mean = (double)n * (double)m / 2;
+    double variance = (double)n * (double)m / 12 * ((total + 1) - ties / (total * (total - 1)));
+    if (variance <= 0) return u > mean ? 0.0 : 1.0;
+
+    double z = (u - mean - 0.5) / sqrt(variance);
+    return 0.5 * erfc(z / sqrt(2.0));
+}
+
+static inline bool bench_parse_format(const char* name, Bench_Format* format) {
+    if (strcmp(name, "text") == 0) {
+        *format = BENCH_TEXT;
+    } else if (strcmp(name, "csv") == 0) {
+        *format = BENCH_CSV;
+    } else if (strcmp(name, "json") == 0) {
+        *format = BENCH_JSON;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static inline bool bench__has_counter(const Bench_Row* row, Bench_Counter counter) {
+    return (row->counter_mask >> counter) & 1;
+}
+
+// A counter per processed element, or per run when the row does not know its element count
+static inline double bench__per_element(const Bench_Row* row, Bench_Counter counter) {
+    return row->counters[counter] / (double)(row->elements ? row->elements : 1);
+}
+
+static inline double bench__ipc(const Bench_Row* row) {
+    bool measured = bench__has_counter(row, BENCH_CYCLES) && bench__has_counter(row, BENCH_INSTRUCTIONS);
+    return measured && row->counters[BENCH_CYCLES] > 0 ? row->counters[BENCH_INSTRUCTIONS] / row->counters[BENCH_CYCLES] : 0;
+}
+
+static inline void bench__print_text_counter(FILE* out, const Bench_Row* row, Bench_Counter counter) {
+    if (bench__has_counter(row, counter)) {
+        fprintf(out, " %12.4f", bench__per_element(row, counter));
+    } else {
+        fprintf(out, " %12s", "-");
+    }
+}
+
+static inline void bench_print_report(FILE* out, const Bench_Report* report, Bench_Format format) {
+    // The counter columns only show up when at least one row has counters
+    bool counters = false;
+    for (size_t i = 0; i < report->count; ++i) counters = counters || report->items[i].counter_mask != 0;
+
+    switch (format) {
+        case BENCH_TEXT:
+            fprintf(out, "%-4s %-12s %8s %12s %12s %12s %12s %12s %12s", "day", "phase", "runs", "min ms",
+                    "median ms", "p90 ms", "p99 ms", "mean ms", "stddev ms");
+            if (counters) {
+                fprintf(out, " %12s %6s %12s %12s %12s", "elements", "IPC", "L1D miss/el", "LLC miss/el",
+                        "br miss/el");
+            }
+            fprintf(out, "\n");
+            for (size_t i = 0; i < report->count; ++i) {
+                const Bench_Row* row = &report->items[i];
+                const Bench_Stats* s = &row->stats;
+                fprintf(out, "%-4d %-12s %8zu %12.4f %12.4f %12.4f %12.4f %12.4f %12.4f", row->day, row->phase,
+                        s->runs, s->min / 1e6, s->median / 1e6, s->p90 / 1e6, s->p99 / 1e6, s->mean / 1e6,
+                        s->stddev / 1e6);
+                if (counters) {
+                    fprintf(out, " %12" PRIu64 " %6.2f", row->elements, bench__ipc(row));
+                    bench__print_text_counter(out, row, BENCH_L1D_MISSES);
+                    bench__print_text_counter(out, row, BENCH_LLC_MISSES);
+                    bench__print_text_counter(out, row, BENCH_BRANCH_MISSES);
+                }
+                fprintf(out, "\n");
+            }
+            break;
+
+        case BENCH_CSV:
+            fprintf(out, "day,phase,runs,min_ns,median_ns,p90_ns,p99_ns,mean_ns,stddev_ns");
+            if (counters) {
+                fprintf(out, ",elements");
+                for (size_t c = 0; c < BENCH_COUNTER_COUNT; ++c) fprintf(out, ",%s", bench_counter_names[c]);
+                fprintf(out, ",ipc");
+            }
+            fprintf(out, "\n");
+            for (size_t i = 0; i < report->count; ++i) {
+                const Bench_Row* row = &report->items[i];
+                const Bench_Stats* s = &row->stats;
+                fprintf(out, "%d,%s,%zu,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.1f,%.1f", row->day,
+                        row->phase, s->runs, s->min, s->median, s->p90, s->p99, s->mean, s->stddev);
+                if (counters) {
+                    fprintf(out, ",%" PRIu64, row->elements);
+                    for (size_t c = 0; c < BENCH_COUNTER_COUNT; ++c) {
+                        if (bench__has_counter(row, (Bench_Counter)c)) {
+                            fprintf(out, ",%.1f", row->counters[c]);
+                        } else {
+                            fprintf(out, ",");
+                        }
+                    }
+                    fprintf(out, ",%.3f", bench__ipc(row));
+                }
+                fprintf(out, "\n");
+            }
+            break;
+
+        case BENCH_JSON:
+            fprintf(out, "[\n");
+            for (size_t i = 0; i < report->count; ++i) {
+                const Bench_Row* row = &report->items[i];
+                const Bench_Stats* s = &row->stats;
+                fprintf(out,
+                        "  {\"day\": %d, \"phase\": \"%s\", \"runs\": %zu, \"min_ns\": %" PRIu64
+                        ", \"median_ns\": %" PRIu64 ", \"p90_ns\": %" PRIu64 ", \"p99_ns\": %" PRIu64
+                        ", \"mean_ns\": %.1f, \"stddev_ns\": %.1f",
+                        row->day, row->phase, s->runs, s->min, s->median, s->p90, s->p99, s->mean, s->stddev);
+                if (row->counter_mask) {
+                    fprintf(out, ", \"elements\": %" PRIu64 ", \"ipc\": %.3f, \"counters\": {", row->elements,
+                            bench__ipc(row));
+                    bool first = true;
+                    for (size_t c = 0; c < BENCH_COUNTER_COUNT; ++c) {
+                        if (!bench__has_counter(row, (Bench_Counter)c)) continue;
+                        fprintf(out, "%s\"%s\": %.1f", first ? "" : ", ", bench_counter_names[c], row->counters[c]);
+                        first = false;
+                    }
+                    fprintf(out, "}");
+                }
+                if (row->samples.count) {
+                    fprintf(out, ", \"samples_ns\": [");
+                    for (size_t k = 0; k < row->samples.count; ++k) {
+                        fprintf(out, "%s%" PRIu64, k ? ", " : "", row->samples.items[k]);
+                    }
+                    fprintf(out, "]");
+                }
+                fprintf(out, "}%s\n", i + 1 < report->count ? "," : "");
+            }
+            fprintf(out, "]\n");
+            break;
+    }
+}
+
+#endif  // AOC_BENCH_H
@@ -0,0 +1,360 @@
+#ifndef AOC_CACHE_H
+#define AOC_CACHE_H
+
+// Answers of earlier runs kept on disk, `aoc --cache PATH` in the runner.
+//
+//     aoc --cache answers.cache [--cache-entries N]
+//
+// Before a day parses anything its input file is hashed (XXH64 of the bytes) and the answers of the
+// parts that would run are looked up by that hash, the input size, the day, the part and the day's
+// .version (see Aoc_Day). When every one of them is there they are printed straight away, nothing is
+// parsed or solved. Answers that were not there are appended once they are computed.
+//
+// The file is a 16 byte header followed by 32 byte records, append only. Lookups scan a read-only
+// mapping of it from the newest record back, a record carries a check of its own fields so a torn
+// append at the end is skipped. Once the file holds more than --cache-entries records (4096 by
+// default, 128 KiB) it is compacted to the newest half of its keys. A hit in the older half is
+// appended again, so answers that keep being asked for survive the compaction.
+//
+// Appends and compactions hold an flock() on the file, concurrent runners do not tear each other's
+// records. Benchmark runs never use the cache, they are there to time the solvers.
+//
+// Include nob.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before cache.h"
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define CACHE_MAGIC "AOCCACH1"
+#define CACHE_DEFAULT_ENTRIES 4096
+
+typedef struct {
+    char magic[8];
+    uint32_t record_size;
+    uint32_t reserved;
+} Cache_Header;
+
+// The fields up to answer are the key, a lookup ignores answer and check
+typedef struct {
+    uint64_t hash;     // cache_hash() of the input bytes
+    uint64_t size;     // of the input in bytes
+    uint32_t version;  // of the day's solvers
+    uint8_t day;
+    uint8_t part;
+    uint16_t check;    // of every other field, 0 while the record is a key
+    uint64_t answer;
+} Cache_Record;
+
+_Static_assert(sizeof(Cache_Header) == 16, "the cache header is 16 bytes on disk");
+_Static_assert(sizeof(Cache_Record) == 32, "cache records are 32 bytes on disk");
+
+typedef struct {
+    const char* path;
+    int fd;
+    void* mapping;      // the file as it was when it was opened, NULL while it has no records
+    size_t mapped_size;
+    const Cache_Record* records;
+    size_t count;       // records in the mapping
+    size_t max_entries;
+} Cache;
+
+#define CACHE__P1 0x9E3779B185EBCA87ULL
+#define CACHE__P2 0xC2B2AE3D27D4EB4FULL
+#define CACHE__P3 0x165667B19E3779F9ULL
+#define CACHE__P4 0x85EBCA77C2B2AE63ULL
+#define CACHE__P5 0x27D4EB2F165667C5ULL
+
+static inline uint64_t cache__rotl(uint64_t x, int r) {
+    return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t cache__read64(const uint8_t* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t cache__round(uint64_t acc, uint64_t input) {
+    acc += input * CACHE__P2;
+    return cache__rotl(acc, 31) * CACHE__P1;
+}
+
+static inline uint64_t cache__merge(uint64_t acc, uint64_t lane) {
+    acc ^= cache__round(0, lane);
+    return acc * CACHE__P1 + CACHE__P4;
+}
+
+// XXH64, four lanes of 8 bytes per step. The keys end up on disk, so the hash must not change
+// between runs or builds: a fixed algorithm, seeded only by the caller. stbds_hash_bytes() is meant for
+// the in-memory tables of stb_ds and may change along with them.
+static inline uint64_t cache_hash(const void* data, size_t size, uint64_t seed) {
+    const uint8_t* p = data;
+    const uint8_t* end = p + size;
+    uint64_t h;
+
+    if (size >= 32) {
+        uint64_t v1 = seed + CACHE__P1 + CACHE__P2;
+        uint64_t v2 = seed + CACHE__P2;
+        uint64_t v3 = seed;
+        uint64_t v4 = seed - CACHE__P1;
+        for (; p + 32 <= end; p += 32) {
+            v1 = cache__round(v1, cache__read64(p));
+            v2 = cache__round(v2, cache__read64(p + 8));
+            v3 = cache__round(v3, cache__read64(p + 16));
+            v4 = cache__round(v4, cache__read64(p + 24));
+        }
+        h = cache__rotl(v1, 1) + cache__rotl(v2, 7) + cache__rotl(v3, 12) + cache__rotl(v4, 18);
+        h = cache__merge(h, v1);
+        h = cache__merge(h, v2);
+        h = cache__merge(h, v3);
+        h = cache__merge(h, v4);
+    } else {
+        h = seed + CACHE__P5;
+    }
+    h += (uint64_t)size;
+
+    for (; p + 8 <= end; p += 8) {
+        h ^= cache__round(0, cache__read64(p));
+        h = cache__rotl(h, 27) * CACHE__P1 + CACHE__P4;
+    }
+    if (p + 4 <= end) {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        h ^= (uint64_t)v * CACHE__P1;
+        h = cache__rotl(h, 23) * CACHE__P2 + CACHE__P3;
+        p += 4;
+    }
+    for (; p < end; ++p) {
+        h ^= (uint64_t)*p * CACHE__P5;
+        h = cache__rotl(h, 11) * CACHE__P1;
+    }
+
+    h ^= h >> 33;
+    h *= CACHE__P2;
+    h ^= h >> 29;
+    h *= CACHE__P3;
+    h ^= h >> 32;
+    return h;
+}
+
+static inline uint16_t cache__check(const Cache_Record* record) {
+    Cache_Record copy = *record;
+    copy.check = 0;
+    uint16_t check = (uint16_t)cache_hash(&copy, sizeof(copy), 0);
+    return check ? check : 1;  // a zeroed record never checks out
+}
+
+static inline bool cache__same_key(const Cache_Record* a, const Cache_Record* b) {
+    return a->hash == b->hash && a->size == b->size && a->version == b->version && a->day == b->day &&
+           a->part == b->part;
+}
+
+static inline void cache__unmap(Cache* cache) {
+    if (cache->mapping) munmap(cache->mapping, cache->mapped_size);
+    cache->mapping = NULL;
+    cache->mapped_size = 0;
+    cache->records = NULL;
+    cache->count = 0;
+}
+
+// Opens (or creates) the file and maps the records it has, without taking the lock: readers only
+// ever look at whole records of an append-only file.
+static inline bool cache__open_file(Cache* cache) {
+    cache->fd = open(cache->path, O_RDWR | O_CREAT | O_APPEND | O_CLOEXEC, 0644);
+    if (cache->fd < 0) {
+        nob_log(NOB_ERROR, "Could not open %s: %s", cache->path, strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(cache->fd, &st) < 0) {
+        nob_log(NOB_ERROR, "Could not stat %s: %s", cache->path, strerror(errno));
+        return false;
+    }
+
+    Cache_Header header = {.record_size = sizeof(Cache_Record)};
+    memcpy(header.magic, CACHE_MAGIC, sizeof(header.magic));
+    if (st.st_size == 0) {
+        // Two runners creating the cache at once would both write a header, the lock keeps it to one
+        flock(cache->fd, LOCK_EX);
+        if (fstat(cache->fd, &st) == 0 && st.st_size == 0 && write(cache->fd, &header, sizeof(header)) < 0) {
+            nob_log(NOB_ERROR, "Could not write %s: %s", cache->path, strerror(errno));
+            flock(cache->fd, LOCK_UN);
+            return false;
+        }
+        flock(cache->fd, LOCK_UN);
+        return true;
+    }
+
+    Cache_Header found = {0};
+    if (st.st_size < (off_t)sizeof(found) || pread(cache->fd, &found, sizeof(found), 0) != sizeof(found) ||
+        memcmp(found.magic, header.magic, sizeof(found.magic)) != 0 || found.record_size != sizeof(Cache_Record)) {
+        nob_log(NOB_ERROR, "%s is not an answer cache", cache->path);
+        return false;
+    }
+
+    size_t count = ((size_t)st.st_size - sizeof(Cache_Header)) / sizeof(Cache_Record);
+    if (count == 0) return true;
+    cache->mapped_size = sizeof(Cache_Header) + count * sizeof(Cache_Record);
+    cache->mapping = mmap(NULL, cache->mapped_size, PROT_READ, MAP_SHARED, cache->fd, 0);
+    if (cache->mapping == MAP_FAILED) {
+        nob_log(NOB_ERROR, "Could not map %s: %s", cache->path, strerror(errno));
+        cache->mapping = NULL;
+        return false;
+    }
+    cache->records = (const Cache_Record*)((const char*)cache->mapping + sizeof(Cache_Header));
+    cache->count = count;
+    return true;
+}
+
+static inline void cache_close(Cache* cache) {
+    cache__unmap(cache);
+    if (cache->fd >= 0) close(cache->fd);
+    cache->fd = -1;
+}
+
+static inline bool cache_open(const char* path, size_t max_entries, Cache* cache) {
+    *cache = (Cache){.path = path, .fd = -1, .max_entries = max_entries ? max_entries : CACHE_DEFAULT_ENTRIES};
+    if (!cache__open_file(cache)) {
+        cache_close(cache);
+        return false;
+    }
+    return true;
+}
+
+// Locks the file, reopening it first when a compaction of another runner replaced it in the meantime
+static inline bool cache__lock(Cache* cache) {
+    for (;;) {
+        if (flock(cache->fd, LOCK_EX) < 0) return false;
+
+        struct stat held, current;
+        if (fstat(cache->fd, &held) == 0 && stat(cache->path, &current) == 0 && held.st_ino == current.st_ino &&
+            held.st_dev == current.st_dev) {
+            return true;
+        }
+        cache_close(cache);
+        if (!cache__open_file(cache)) return false;
+    }
+}
+
+typedef struct {
+    Cache_Record record;
+    size_t age;  // 0 for the newest record
+} Cache__Aged;
+
+// By key, the newest record of a key first
+static inline int cache__compare_aged(const void* a, const void* b) {
+    const Cache_Record* x = &((const Cache__Aged*)a)->record;
+    const Cache_Record* y = &((const Cache__Aged*)b)->record;
+    if (x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+    if (x->size != y->size) return x->size < y->size ? -1 : 1;
+    if (x->version != y->version) return x->version < y->version ? -1 : 1;
+    if (x->day != y->day) return x->day < y->day ? -1 : 1;
+    if (x->part != y->part) return x->part < y->part ? -1 : 1;
+    size_t age_a = ((const Cache__Aged*)a)->age;
+    size_t age_b = ((const Cache__Aged*)b)->age;
+    return age_a < age_b ? -1 : age_a > age_b;
+}
+
+// Rewrites the file with the newest record of the newest max_entries / 2 keys, called with the lock
+// held. The new file replaces the old one by rename(), runners that still have the old one open
+// notice it in cache__lock().
+static inline bool cache__compact(Cache* cache) {
+    Nob_String_Builder sb = {0};
+    if (!nob_read_entire_file(cache->path, &sb)) return false;
+
+    // The valid records, newest first
+    size_t count = sb.count > sizeof(Cache_Header) ? (sb.count - sizeof(Cache_Header)) / sizeof(Cache_Record) : 0;
+    Cache__Aged* aged = malloc(count * sizeof(*aged) + 1);
+    NOB_ASSERT(aged != NULL && "Buy more RAM lol");
+    size_t valid = 0;
+    for (size_t i = count; i-- > 0;) {
+        Cache_Record record;
+        memcpy(&record, sb.items + sizeof(Cache_Header) + i * sizeof(record), sizeof(record));
+        if (record.check != cache__check(&record)) continue;
+        aged[valid] = (Cache__Aged){.record = record, .age = valid};
+        valid++;
+    }
+
+    // Only the first record of every key in key order is its newest, the rest are superseded
+    qsort(aged, valid, sizeof(*aged), cache__compare_aged);
+    bool* newest = calloc(valid + 1, sizeof(bool));
+    Cache_Record* by_age = malloc(valid * sizeof(Cache_Record) + 1);
+    NOB_ASSERT(newest != NULL && by_age != NULL && "Buy more RAM lol");
+    for (size_t i = 0; i < valid; ++i) {
+        newest[aged[i].age] = i == 0 || !cache__same_key(&aged[i].record, &aged[i - 1].record);
+        by_age[aged[i].age] = aged[i].record;
+    }
+
+    size_t keep = cache->max_entries / 2 ? cache->max_entries / 2 : 1;
+    size_t kept = 0;
+    for (size_t age = 0; age < valid && kept < keep; ++age) {
+        if (newest[age]) by_age[kept++] = by_age[age];
+    }
+
+    // Written oldest first, the lookups expect the newest records at the end
+    sb.count = sizeof(Cache_Header);
+    for (size_t i = kept; i-- > 0;) nob_sb_append_buf(&sb, &by_age[i], sizeof(Cache_Record));
+    free(aged);
+    free(newest);
+    free(by_age);
+
+    const char* tmp = nob_temp_sprintf("%s.tmp", cache->path);
+    bool ok = nob_write_entire_file(tmp, sb.items, sb.count) && rename(tmp, cache->path) == 0;
+    if (!ok) nob_log(NOB_WARNING, "Could not compact %s: %s", cache->path, strerror(errno));
+    nob_sb_free(sb);
+    return ok;
+}
+
+// Looks the key up, newest record first
+static inline bool cache_lookup(const Cache* cache, const Cache_Record* key, uint64_t* answer, size_t* index) {
+    for (size_t i = cache->count; i-- > 0;) {
+        const Cache_Record* record = &cache->records[i];
+        if (!cache__same_key(record, key)) continue;
+        if (record->check != cache__check(record)) continue;
+        *answer = record->answer;
+        if (index) *index = i;
+        return true;
+    }
+    return false;
+}
+
+// Appends the answer of the key, and compacts the file once it holds too many records. A cache that
+// cannot be written only logs a warning, the answers are right either way.
+static inline void cache_store(Cache* cache, const Cache_Record* key, uint64_t answer) {
+    if (cache->fd < 0 || !cache__lock(cache)) return;
+
+    Cache_Record record = *key;
+    record.answer = answer;
+    record.check = 0;
+    record.check = cache__check(&record);
+    if (write(cache->fd, &record, sizeof(record)) != sizeof(record)) {
+        nob_log(NOB_WARNING, "Could not write %s: %s", cache->path, strerror(errno));
+    }
+
+    struct stat st;
+    if (fstat(cache->fd, &st) == 0) {
+        size_t count = ((size_t)st.st_size - sizeof(Cache_Header)) / sizeof(Cache_Record);
+        if (count > cache->max_entries) cache__compact(cache);
+    }
+    if (cache->fd >= 0) flock(cache->fd, LOCK_UN);
+}
+
+// Called for a hit: records in the older half are appended again so the next compaction keeps them
+static inline void cache_touch(Cache* cache, const Cache_Record* key, uint64_t answer, size_t index) {
+    if (index < cache->count / 2) cache_store(cache, key, answer);
+}
+
+#endif  // AOC_CACHE_H
@@ -0,0 +1,312 @@
+#ifndef AOC_DIFF_H
+#define AOC_DIFF_H
+
+// Differential testing of the fast solvers against their references, `aoc diff` in the runner.
+//
+//     aoc diff [--day N] [--sizes N,N,...] [--seeds N] [--seed N] [--format text|csv|json] [--report PATH]
+//
+// A day that replaces a straightforward solver with a faster one keeps the old one as .reference_1
+// or .reference_2 (see Aoc_Day). For every such part this parses generated inputs (gen.h) of every
+// size with --seeds consecutive seeds starting at --seed, runs both solvers on the same state and
+// compares the answers. Sizes default to a tenth of the real input and the real input size, moved up
+// to the nearest size the generator takes.
+//
+// Every run is timed, the report lists the mismatches and the total time of both solvers per part and
+// size, and the speedup of the fast one. For a day with a .reference_parse both sides are timed from
+// the text, .parse and the part against .reference_parse and the reference. A mismatch also logs the gen command that reproduces its
+// input. Mismatches, and inputs that could not be generated or parsed, make the command exit with 1.
+// Days without references are skipped.
+//
+// Include nob.h, input.h and aoc.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before diff.h"
+#endif
+#ifndef AOC_AOC_H
+#error "include aoc.h before diff.h"
+#endif
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "gen.h"
+
+#define DIFF_MAX_SIZES 16
+
+typedef struct {
+    int day;  // 0 checks every day with a reference
+    size_t sizes[DIFF_MAX_SIZES];
+    size_t size_count;  // 0 picks the sizes from gen_days
+    size_t seeds;
+    uint64_t seed;
+    Bench_Format format;
+    const char* report;  // NULL prints the report to stdout
+} Diff_Options;
+
+typedef struct {
+    int day;
+    int part;
+    size_t size;
+    size_t seeds;
+    size_t mismatches;
+    size_t failures;        // inputs that could not be generated or parsed
+    uint64_t fast_ns;       // summed over the seeds
+    uint64_t reference_ns;
+} Diff_Result;
+
+typedef struct {
+    Diff_Result* items;
+    size_t count;
+    size_t capacity;
+} Diff_Results;
+
+static inline void diff__usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s diff [--day N] [--sizes N,N,...] [--seeds N] [--seed N] [--format text|csv|json] "
+            "[--report PATH]\n",
+            program);
+}
+
+static inline bool diff__parse_sizes(const char* value, Diff_Options* options) {
+    options->size_count = 0;
+    while (value && *value) {
+        char* end = NULL;
+        unsigned long long size = strtoull(value, &end, 10);
+        if (end == value || size == 0 || (*end != ',' && *end != '\0')) return false;
+        if (options->size_count == DIFF_MAX_SIZES) return false;
+        options->sizes[options->size_count++] = (size_t)size;
+        value = *end == ',' ? end + 1 : end;
+    }
+    return options->size_count > 0;
+}
+
+static inline bool diff_parse_options(int argc, char** argv, Diff_Options* options) {
+    const char* program = nob_shift(argv, argc);
+    nob_shift(argv, argc);  // "diff"
+    *options = (Diff_Options){.seeds = 3, .seed = 1, .format = BENCH_TEXT};
+
+    while (argc > 0) {
+        const char* flag = nob_shift(argv, argc);
+        const char* value = argc > 0 ? argv[0] : NULL;
+        long parsed = 0;
+
+        if (strcmp(flag, "--day") == 0) {
+            if (!aoc__parse_count(flag, value, 1, 25, &parsed)) return false;
+            options->day = (int)parsed;
+        } else if (strcmp(flag, "--sizes") == 0) {
+            if (!diff__parse_sizes(value, options)) {
+                nob_log(NOB_ERROR, "--sizes expects up to %d comma separated sizes", DIFF_MAX_SIZES);
+                return false;
+            }
+        } else if (strcmp(flag, "--seeds") == 0) {
+            if (!aoc__parse_count(flag, value, 1, 1000000, &parsed)) return false;
+            options->seeds = (size_t)parsed;
+        } else if (strcmp(flag, "--seed") == 0) {
+            if (!aoc__parse_count(flag, value, 0, 2147483647, &parsed)) return false;
+            options->seed = (uint64_t)parsed;
+        } else if (strcmp(flag, "--format") == 0) {
+            if (value == NULL || !bench_parse_format(value, &options->format)) {
+                nob_log(NOB_ERROR, "--format expects text, csv or json");
+                return false;
+            }
+        } else if (strcmp(flag, "--report") == 0) {
+            if (value == NULL) {
+                nob_log(NOB_ERROR, "--report expects a path");
+                return false;
+            }
+            options->report = value;
+        } else {
+            if (strcmp(flag, "--help") != 0 && strcmp(flag, "-h") != 0) {
+                nob_log(NOB_ERROR, "Unknown flag %s", flag);
+            }
+            diff__usage(program);
+            return false;
+        }
+        nob_shift(argv, argc);
+    }
+    return true;
+}
+
+// The states of one input, parse_ns and reference_parse_ns are 0 when both share the state
+typedef struct {
+    void* state;
+    void* reference_state;
+    uint64_t parse_ns;
+    uint64_t reference_parse_ns;
+} Diff__States;
+
+// Runs both solvers of one part on their states and adds the outcome to result
+static inline void diff__part(const Aoc_Day* day, int part, const Diff__States* states, uint64_t seed,
+                              Diff_Result* result) {
+    uint64_t (*fast)(const void*) = part == 1 ? day->part_1 : day->part_2;
+    uint64_t (*reference)(const void*) = part == 1 ? day->reference_1 : day->reference_2;
+
+    uint64_t start = bench_now_ns();
+    uint64_t fast_answer = fast(states->state);
+    uint64_t middle = bench_now_ns();
+    uint64_t reference_answer = reference(states->reference_state);
+    uint64_t end = bench_now_ns();
+
+    result->seeds++;
+    result->fast_ns += states->parse_ns + middle - start;
+    result->reference_ns += states->reference_parse_ns + end - middle;
+    if (fast_answer != reference_answer) {
+        result->mismatches++;
+        nob_log(NOB_ERROR, "day %d part %d: fast %" PRIu64 " != reference %" PRIu64 ", reproduce with "
+                "gen --day %d --size %zu --seed %" PRIu64,
+                day->number, part, fast_answer, reference_answer, day->number, result->size, seed);
+    }
+}
+
+static inline void diff_day(const Aoc_Day* day, const Diff_Options* options, Diff_Results* results) {
+    const Gen_Day* gen_day = gen_find_day(day->number);
+    size_t sizes[DIFF_MAX_SIZES] = {gen_valid_size(gen_day, gen_day->default_size / 10),
+                                    gen_valid_size(gen_day, gen_day->default_size)};
+    size_t size_count = 2;
+    if (options->size_count) {
+        memcpy(sizes, options->sizes, sizeof(sizes));
+        size_count = options->size_count;
+    }
+
+    for (size_t s = 0; s < size_count; ++s) {
+        Diff_Result part_results[2] = {
+            {.day = day->number, .part = 1, .size = sizes[s]},
+            {.day = day->number, .part = 2, .size = sizes[s]},
+        };
+
+        for (size_t i = 0; i < options->seeds; ++i) {
+            Gen_Params params = {.day = day->number, .size = sizes[s], .seed = options->seed + i};
+            Nob_String_Builder sb = {0};
+            if (!gen_input(&params, &sb)) {
+                part_results[0].failures++;
+                part_results[1].failures++;
+                nob_sb_free(sb);
+                continue;
+            }
+
+            Input input = {0};
+            input_from_memory(sb.items, sb.count, &input);
+            Diff__States states = {0};
+            uint64_t start = bench_now_ns();
+            states.state = day->parse(&input.lines);
+            states.reference_state = states.state;
+            if (states.state != NULL && day->reference_parse) {
+                states.parse_ns = bench_now_ns() - start;
+                start = bench_now_ns();
+                states.reference_state = day->reference_parse(&input.lines);
+                states.reference_parse_ns = bench_now_ns() - start;
+            }
+
+            if (states.state == NULL || states.reference_state == NULL) {
+                nob_log(NOB_ERROR, "day %d could not parse gen --day %d --size %zu --seed %" PRIu64, day->number,
+                        day->number, sizes[s], params.seed);
+                part_results[0].failures++;
+                part_results[1].failures++;
+            } else {
+                if (day->reference_1) diff__part(day, 1, &states, params.seed, &part_results[0]);
+                if (day->reference_2) diff__part(day, 2, &states, params.seed, &part_results[1]);
+            }
+            if (day->free && states.state) (day->free)(states.state);
+            if (day->free && states.reference_state && states.reference_state != states.state) {
+                (day->free)(states.reference_state);
+            }
+            input_free(&input);
+            nob_sb_free(sb);
+        }
+
+        for (int part = 0; part < 2; ++part) {
+            bool checked = part == 0 ? day->reference_1 != NULL : day->reference_2 != NULL;
+            if (checked) nob_da_append(results, part_results[part]);
+        }
+    }
+}
+
+static inline double diff__speedup(const Diff_Result* result) {
+    return result->fast_ns ? (double)result->reference_ns / (double)result->fast_ns : 0.0;
+}
+
+static inline void diff_print_report(FILE* out, const Diff_Results* results, Bench_Format format) {
+    switch (format) {
+        case BENCH_TEXT:
+            fprintf(out, "%-4s %-4s %10s %6s %10s %8s %12s %12s %9s\n", "day", "part", "size", "seeds", "mismatches",
+                    "failed", "fast ms", "reference ms", "speedup");
+            for (size_t i = 0; i < results->count; ++i) {
+                const Diff_Result* result = &results->items[i];
+                fprintf(out, "%-4d %-4d %10zu %6zu %10zu %8zu %12.3f %12.3f %8.1fx%s\n", result->day, result->part,
+                        result->size, result->seeds, result->mismatches, result->failures, result->fast_ns / 1e6,
+                        result->reference_ns / 1e6, diff__speedup(result),
+                        result->mismatches ? "  MISMATCH" : result->failures ? "  FAILED" : "");
+            }
+            break;
+
+        case BENCH_CSV:
+            fprintf(out, "day,part,size,seeds,mismatches,failures,fast_ns,reference_ns,speedup\n");
+            for (size_t i = 0; i < results->count; ++i) {
+                const Diff_Result* result = &results->items[i];
+                fprintf(out, "%d,%d,%zu,%zu,%zu,%zu,%" PRIu64 ",%" PRIu64 ",%.3f\n", result->day, result->part,
+                        result->size, result->seeds, result->mismatches, result->failures, result->fast_ns,
+                        result->reference_ns, diff__speedup(result));
+            }
+            break;
+
+        case BENCH_JSON:
+            fprintf(out, "[\n");
+            for (size_t i = 0; i < results->count; ++i) {
+                const Diff_Result* result = &results->items[i];
+                fprintf(out,
+                        "%s  {\"day\": %d, \"part\": %d, \"size\": %zu, \"seeds\": %zu, \"mismatches\": %zu, "
+                        "\"failures\": %zu, \"fast_ns\": %" PRIu64 ", \"reference_ns\": %" PRIu64 ", \"speedup\": %.3f}",
+                        i ? ",\n" : "", result->day, result->part, result->size, result->seeds, result->mismatches,
+                        result->failures, result->fast_ns, result->reference_ns, diff__speedup(result));
+            }
+            fprintf(out, "\n]\n");
+            break;
+    }
+}
+
+static inline int diff_main(const Aoc_Day* const* days, size_t count, int argc, char** argv) {
+    Diff_Options options;
+    if (!diff_parse_options(argc, argv, &options)) return 1;
+
+    Diff_Results results = {0};
+    bool any = false;
+    for (size_t i = 0; i < count; ++i) {
+        const Aoc_Day* day = days[i];
+        if (options.day != 0 && options.day != day->number) continue;
+        if (day->reference_1 == NULL && day->reference_2 == NULL) continue;
+        if (gen_find_day(day->number) == NULL) continue;
+        any = true;
+        diff_day(day, &options, &results);
+    }
+
+    if (!any) {
+        if (options.day) {
+            nob_log(NOB_ERROR, "Day %d has no reference solver to diff against", options.day);
+        } else {
+            nob_log(NOB_ERROR, "No day has a reference solver to diff against");
+        }
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (options.report) {
+        out = fopen(options.report, "w");
+        if (out == NULL) {
+            nob_log(NOB_ERROR, "Could not open %s: %s", options.report, strerror(errno));
+            nob_da_free(results);
+            return 1;
+        }
+    }
+    diff_print_report(out, &results, options.format);
+    if (out != stdout) fclose(out);
+
+    size_t failed = 0;
+    for (size_t i = 0; i < results.count; ++i) failed += results.items[i].mismatches + results.items[i].failures;
+    nob_da_free(results);
+    return failed ? 1 : 0;
+}
+
+#endif  // AOC_DIFF_H
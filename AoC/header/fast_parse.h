@@ -0,0 +1,203 @@
+#ifndef AOC_FAST_PARSE_H
+#define AOC_FAST_PARSE_H
+
+// Integer parsing straight from Nob_String_View, no copies, no locale, no errno.
+//
+// A run of up to 16 ASCII digits is converted with SSE4.1 lane arithmetic (digit pairs, quads and
+// octets are combined with maddubs/madd, like a multiply-accumulate tree). Builds without SSE4.1
+// fall back to an 8-digit SWAR kernel, and anything longer than 16 digits finishes in scalar code.
+//
+// The vector loads read up to 16 bytes past the digits. That is only done when those bytes are in
+// the same page, so parsing the last number of a mapped file never faults.
+//
+// Include nob.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before fast_parse.h"
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#if defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+
+typedef struct {
+    int64_t* items;
+    size_t count;
+    size_t capacity;
+} Int64s;
+
+#define FP_PAGE_SIZE 4096
+
+static inline bool fp__can_load(const char* p, size_t width) {
+    return ((uintptr_t)p & (FP_PAGE_SIZE - 1)) <= FP_PAGE_SIZE - width;
+}
+
+static inline bool fp__is_digit(char c) {
+    return (unsigned char)(c - '0') <= 9;
+}
+
+static inline size_t fp__scalar(const char* p, size_t n, uint64_t* out) {
+    uint64_t value = 0;
+    size_t i = 0;
+    while (i < n && fp__is_digit(p[i])) {
+        value = value * 10 + (uint64_t)(p[i] - '0');
+        i++;
+    }
+    *out = value;
+    return i;
+}
+
+#if defined(__SSE4_1__)
+
+// Converts exactly len (1..16) digits starting at p, the 16 bytes at p must be loadable.
+static inline uint64_t fp__sse_16(const char* p, size_t len) {
+    __m128i digits = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)p), _mm_set1_epi8('0'));
+
+    // Right align the digits, lanes with a negative index are zeroed by pshufb
+    const __m128i iota = _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    __m128i shift = _mm_add_epi8(iota, _mm_set1_epi8((char)((int)len - 16)));
+    digits = _mm_shuffle_epi8(digits, shift);
+
+    const __m128i mul_10 = _mm_setr_epi8(10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1, 10, 1);
+    const __m128i mul_100 = _mm_setr_epi16(100, 1, 100, 1, 100, 1, 100, 1);
+    const __m128i mul_10000 = _mm_setr_epi16(10000, 1, 10000, 1, 10000, 1, 10000, 1);
+
+    __m128i pairs = _mm_maddubs_epi16(digits, mul_10);  // 8 x 2 digits
+    __m128i quads = _mm_madd_epi16(pairs, mul_100);     // 4 x 4 digits
+    quads = _mm_packus_epi32(quads, quads);             // back to 16 bit lanes
+    __m128i octets = _mm_madd_epi16(quads, mul_10000);  // 2 x 8 digits
+
+    uint64_t high = (uint32_t)_mm_cvtsi128_si32(octets);
+    uint64_t low = (uint32_t)_mm_extract_epi32(octets, 1);
+    return high * 100000000ull + low;
+}
+
+// Length of the digit run at p (at most 16), the 16 bytes at p must be loadable.
+static inline size_t fp__sse_run(const char* p) {
+    __m128i shifted = _mm_sub_epi8(_mm_loadu_si128((const __m128i*)p), _mm_set1_epi8('0'));
+    __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(9)), shifted);
+    unsigned non_digits = ~(unsigned)_mm_movemask_epi8(is_digit) & 0xFFFF;
+    return non_digits ? (size_t)__builtin_ctz(non_digits) : 16;
+}
+
+#else
+
+// Converts exactly len (1..8) digits starting at p, the 8 bytes at p must be loadable.
+static inline uint64_t fp__swar_8(const char* p, size_t len) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    // Little endian: the first digit is the lowest byte, shifting pushes the garbage past the
+    // digits out and pads the front with zero digits.
+    v <<= 8 * (8 - len);
+    v = ((v & 0x0F0F0F0F0F0F0F0Full) * 2561) >> 8;
+    v = ((v & 0x00FF00FF00FF00FFull) * 6553601) >> 16;
+    v = ((v & 0x0000FFFF0000FFFFull) * 42949672960001ull) >> 32;
+    return v;
+}
+
+#endif  // __SSE4_1__
+
+// Parses the run of digits at the start of p[0..n). Returns how many bytes were consumed, 0 when
+// p does not start with a digit. Values that do not fit in 64 bits overflow silently.
+static inline size_t parse_digits(const char* p, size_t n, uint64_t* out) {
+#if defined(__SSE4_1__)
+    if (n >= 16 || fp__can_load(p, 16)) {
+        size_t len = fp__sse_run(p);
+        if (len > n) len = n;
+        if (len == 0) {
+            *out = 0;
+            return 0;
+        }
+
+        uint64_t value = fp__sse_16(p, len);
+        if (len < 16) {
+            *out = value;
+            return len;
+        }
+
+        uint64_t rest;
+        size_t rest_len = fp__scalar(p + 16, n - 16, &rest);
+        for (size_t i = 0; i < rest_len; ++i) value *= 10;
+        *out = value + rest;
+        return 16 + rest_len;
+    }
+#else
+    if (n >= 8 || fp__can_load(p, 8)) {
+        size_t len = 0;
+        while (len < 8 && len < n && fp__is_digit(p[len])) len++;
+        if (len == 0) {
+            *out = 0;
+            return 0;
+        }
+
+        uint64_t value = fp__swar_8(p, len);
+        if (len < 8) {
+            *out = value;
+            return len;
+        }
+
+        uint64_t rest;
+        size_t rest_len = fp__scalar(p + 8, n - 8, &rest);
+        for (size_t i = 0; i < rest_len; ++i) value *= 10;
+        *out = value + rest;
+        return 8 + rest_len;
+    }
+#endif
+    return fp__scalar(p, n, out);
+}
+
+// Like strtoull() on a view: leading spaces are skipped and parsing stops at the first non-digit.
+// Returns 0 when there is no number.
+static inline uint64_t sv_to_u64(Nob_String_View sv) {
+    while (sv.count > 0 && sv.data[0] == ' ') nob_sv_chop_left(&sv, 1);
+    if (sv.count > 0 && sv.data[0] == '+') nob_sv_chop_left(&sv, 1);
+
+    uint64_t value = 0;
+    parse_digits(sv.data, sv.count, &value);
+    return value;
+}
+
+// Like strtoll() on a view, accepts a leading '-' or '+'.
+static inline int64_t sv_to_i64(Nob_String_View sv) {
+    while (sv.count > 0 && sv.data[0] == ' ') nob_sv_chop_left(&sv, 1);
+
+    bool negative = false;
+    if (sv.count > 0 && (sv.data[0] == '-' || sv.data[0] == '+')) {
+        negative = sv.data[0] == '-';
+        nob_sv_chop_left(&sv, 1);
+    }
+
+    uint64_t value = 0;
+    parse_digits(sv.data, sv.count, &value);
+    return negative ? -(int64_t)value : (int64_t)value;
+}
+
+// Parses the fields of a delimited line such as "162,817,812" into out. Stops after max fields
+// and returns how many were written.
+static inline size_t parse_i64_fields(Nob_String_View line, char delim, int64_t* out, size_t max) {
+    size_t count = 0;
+    while (line.count > 0 && count < max) {
+        Nob_String_View field = nob_sv_chop_by_delim(&line, delim);
+        if (field.count == 0) continue;
+        out[count++] = sv_to_i64(field);
+    }
+    return count;
+}
+
+// Appends every field of a delimited line to out and returns how many were appended.
+static inline size_t parse_i64_line(Nob_String_View line, char delim, Int64s* out) {
+    size_t before = out->count;
+    while (line.count > 0) {
+        Nob_String_View field = nob_sv_chop_by_delim(&line, delim);
+        if (field.count == 0) continue;
+        nob_da_append(out, sv_to_i64(field));
+    }
+    return out->count - before;
+}
+
+#endif  // AOC_FAST_PARSE_H
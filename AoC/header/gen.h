@@ -0,0 +1,608 @@
+#ifndef AOC_GEN_H
+#define AOC_GEN_H
+
+// Synthetic inputs in the exact format of every day, at any size and reproducible from a seed.
+//
+//     Gen_Params params = {.day = 8, .size = 100000, .seed = 1};
+//     Nob_String_Builder sb = {0};
+//     if (gen_input(&params, &sb)) nob_write_entire_file("q8_100k.txt", sb.items, sb.count);
+//
+// size counts the elements the solvers scale with (gen_days lists the unit of every day), the other
+// parameters are optional and fall back to the shape of the real inputs when 0:
+//
+//     day  size                      width / height            degree / buttons
+//     1    rotations                 -                         -
+//     2    id ranges                 -                         -
+//     3    battery banks             digits per bank (100)     -
+//     4    grid cells                grid sides (square)       -
+//     5    fresh ranges (+ as many ingredient ids)             -
+//     6    problems                  - / operand rows (4)      -
+//     7    grid cells                grid sides (square)       -
+//     8    junction boxes            -                         -
+//     9    polygon vertices          -                         -
+//     10   machines                  lights (4..10)            - / buttons (3..13)
+//     11   devices                   -                         average outputs (3)
+//     12   regions                   -                         -
+//
+// The same params always produce the same bytes. Include nob.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before gen.h"
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+typedef struct {
+    int day;
+    size_t size;       // 0 means the size of the real input
+    uint64_t seed;
+    size_t width;
+    size_t height;
+    size_t degree;
+    size_t buttons;
+} Gen_Params;
+
+typedef struct {
+    uint64_t state;
+} Gen_Rng;
+
+// splitmix64, tiny and good enough to make inputs with
+static inline uint64_t gen_next(Gen_Rng* rng) {
+    uint64_t z = (rng->state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Uniform in [lo, hi], the modulo bias does not matter at these ranges
+static inline uint64_t gen_range(Gen_Rng* rng, uint64_t lo, uint64_t hi) {
+    return lo + gen_next(rng) % (hi - lo + 1);
+}
+
+static inline bool gen_chance(Gen_Rng* rng, unsigned percent) {
+    return gen_next(rng) % 100 < percent;
+}
+
+// snprintf is the bottleneck at 10^7 numbers, so the digits are written by hand
+static inline void gen_append_u64(Nob_String_Builder* sb, uint64_t value) {
+    char digits[20];
+    size_t count = 0;
+    do {
+        digits[count++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value);
+
+    nob_da_reserve(sb, sb->count + count);
+    while (count) sb->items[sb->count++] = digits[--count];
+}
+
+static inline void gen_append_char(Nob_String_Builder* sb, char c) {
+    nob_da_append(sb, c);
+}
+
+static inline void gen_append_repeat(Nob_String_Builder* sb, char c, size_t count) {
+    nob_da_reserve(sb, sb->count + count);
+    memset(sb->items + sb->count, c, count);
+    sb->count += count;
+}
+
+static inline size_t gen__digit_count(uint64_t value) {
+    size_t count = 1;
+    while (value >= 10) {
+        value /= 10;
+        count++;
+    }
+    return count;
+}
+
+// Sides of a grid with about cells cells, width and height win when they are given
+static inline void gen__grid_sides(const Gen_Params* params, size_t* width, size_t* height) {
+    *width = params->width;
+    *height = params->height;
+    if (*width == 0 && *height == 0) {
+        size_t side = 1;
+        while (side * side < params->size) side++;
+        *width = *height = side;
+    } else if (*width == 0) {
+        *width = (params->size + *height - 1) / *height;
+    } else if (*height == 0) {
+        *height = (params->size + *width - 1) / *width;
+    }
+    if (*width < 3) *width = 3;
+    if (*height < 3) *height = 3;
+}
+
+static inline bool gen_q1(Gen_Rng* rng, const Gen_Params* params, Nob_String_Builder* sb) {
+    for (size_t i = 0; i < params->size; ++i) {
+        gen_append_char(sb, gen_chance(rng, 50) ? 'L' : 'R');
+        gen_append_u64(sb, gen_range(rng, 1, 999));
+        gen_append_char(sb, '\n');
+    }
+    return true;
+}
+
+static inline bool gen_q2(Gen_Rng* rng, const Gen_Params* params, Nob_String_Builder* sb) {
+    // Ranges are disjoint and increasing, the real input lists them shuffled but nothing cares
+    uint64_t next = 10;
+    for (size_t i = 0; i < params->size; ++i) {
+        uint64_t start = next + gen_range(rng, 0, 100000000);
+        uint64_t end = start + gen_range(rng, 0, 100000);
+        next = end + 1;
+
+        if (i > 0) gen_append_char(sb, ',');
+        gen_append_u64(sb, start);
+        gen_append_char(sb, '-');
+        gen_append_u64(sb, end);
+    }
+    gen_append_char(sb, '\n');
+    return true;
+}
+
+static inline bool gen_q3(Gen_Rng* rng, const Gen_Params* params, Nob_String_Builder* sb) {
+    size_t width = params->width ? params->width : 100;
+    if (width < 12) {
+        nob_log(NOB_ERROR, "day 3 needs banks of at least 12 batteries");
+        return false;
+    }
+    for (size_t i = 0; i < params->size; ++i) {
+        for (size_t j = 0; j < width; ++j) gen_append_char(sb, (char)('1' + gen_range(rng, 0, 8)));
+        gen_append_char(sb, '\n');
+    }
+    return true;
+}
+
+static inline bool gen_q4(Gen_Rng* rng, const Gen_Params* params, Nob_String_Builder* sb) {
+    size_t width, height;
+    gen__grid_sides(params, &width, &height);
+    for (size_t row = 0; row < height; ++row) {
+        for (size_t col = 0; col < width; ++col) gen_append_char(sb, gen_chance(rng, 65) ? '@' : '.');
+        gen_append_char(sb, '\n');
+    }
+    return true;
+}
+
+static inline bool gen_q5(Gen_Rng* rng, const Gen_Params* params, Nob_String_Builder* sb) {
+    // Overlapping ranges over 15 digit ids like the real input, then ingredients drawn from the same span
+    const uint64_t span = 560000000000000ull;
+    for (size_t i = 0; i < params->size; ++i) {
+        uint64_t start = gen_range(rng, 1, span);
+        gen_append_u64(sb, start);
+        gen_append_char(sb, '-');
+        gen_append_u64(sb, start + gen_range(rng, 0, 5000000000000ull));
+        gen_append_char(sb, '\n');
+    }
+    gen_append_char(sb, '\n');
+    for (size_t i = 0; i < params->size; ++i) {
+        gen_append_u64(sb, gen_range(rng, 1, span));
+        gen_append_char(sb, '\n');
+    }
+    return true;
+}
+
+static inline bool gen_q6(Gen_Rng* rng, const Gen_Params* params, Nob_String_Builder* sb) {
+    size_t rows = params->height ? params->height : 4;
+    if (rows > 16) {
+        nob_log(NOB_ERROR, "day 6 supports at most 16 operand rows");
+        return false;
+    }
+
+    // Columns are as wide as their longest number, the shorter ones are left or right aligned in it
+    uint64_t* values = malloc(params->size * rows * sizeof(*values));
+    size_t* widths = malloc(params->size * sizeof(*widths));
+    bool* left = malloc(params->size * sizeof(*left));
+    NOB_ASSERT(values && widths && left && "Buy more RAM lol");
+
+    for (size_t col = 0; col < params->size; ++col) {
+        widths[col] = 1;
+        left[col] = gen_chance(rng, 50);
+        for (size_t row = 0; row < rows; ++row) {
+            uint64_t value = gen_range(rng, 1, 9999) / (uint64_t)(gen_range(rng, 0, 3) == 0 ? 1 : 10);
+            if (value == 0) value = 1;
+            values[row * params->size + col] = value;
+            size_t digits = gen__digit_count(value);
+            if (digits > widths[col]) widths[col] = digits;
+        }
+    }
+
+    for (size_t row = 0; row < rows; ++row) {
+        for (size_t col = 0; col < params->size; ++col) {
+            uint64_t value = values[row * params->size + col];
+            size_t pad = widths[col] - gen__digit_count(value);
+            if (col > 0) gen_append_char(sb, ' ');
+            if (!left[col]) gen_append_repeat(sb, ' ', pad);
+            gen_append_u64(sb, value);
+            if (left[col]) gen_append_repeat(sb, ' ', pad);
+        }
+        gen_append_char(sb, '\n');
+    }
+    for (size_t col = 0; col < params->size; ++col) {
+        if (col > 0) gen_append_char(sb, ' ');
+        gen_append_char(sb, gen_chance(rng, 50) ? '+' : '*');
+        gen_append_repeat(sb, ' ', widths[col] - 1);
+    }
+    gen_append_char(sb, '\n');
+
+    free(values);
+    free(widths);
+    free(left);
+    return true;
+}
+
+static inline bool gen_q7(Gen_Rng* rng, const Gen_Params* params, Nob_String_Builder* sb) {
+    size_t width, height;
+    gen__grid_sides(params, &width, &height);
+    size_t start = width / 2;
+
+    // Splitters sit on every other row, on the checkerboard of cells the beams below S can reach
+    for (size_t row = 0; row < height; ++row) {
+        for (size_t col = 0; col < width; ++col) {
+            char c = '.';
+            if (row == 0 && col == start) {
+                c = 'S';
+            } else if (row >= 2 && row % 2 == 0 && col > 0 && col + 1 < width) {
+                size_t reach = row / 2 - 1;
+                size_t offset = col > start ? col - start : start - col;
+                if (offset <= reach && (reach - offset) % 2 == 0 && gen_chance(rng, 80)) c = '^';
+            }
+            gen_append_char(sb, c);
+        }
+        gen_append_char(sb, '\n');
+    }
+    return true;
+}
+
+static inline bool gen_q8(Gen_Rng* rng, const Gen_Params* params, Nob_String_Builder* sb) {
+    for (size_t i = 0; i < params->size; ++i) {
+        for (size_t axis = 0; axis < 3; ++axis) {
+            if (axis > 0) gen_append_char(sb, ',');
+            gen_append_u64(sb, gen_range(rng, 0, 99999));
+        }
+        gen_append_char(sb, '\n');
+    }
+    return true;
+}
+
+static inline void gen__append_point(Nob_String_Builder* sb, uint64_t x, uint64_t y) {
+    gen_append_u64(sb, x);
+    gen_append_char(sb, ',');
+    gen_append_u64(sb, y);
+    gen_append_char(sb, '\n');
+}
+
+static inline bool gen_q9(Gen_Rng* rng, const Gen_Params* params, Nob_String_Builder* sb) {
+    size_t n = params->size;
+    if (n < 4 || n % 2 != 0) {
+        nob_log(NOB_ERROR, "day 9 needs an even number of at least 4 vertices");
+        return false;
+    }
+
+    // An x-monotone rectilinear polygon: m columns, each spanning [bottom, top]. Bottoms stay below
+    // the middle and tops above it, so neighbouring columns always overlap and the outline never
+    // touches itself. Every column adds 4 corners, a shared bottom between the first two columns
+    // takes 2 away when n is not a multiple of 4.
+    size_t m = (n + 2) / 4;
+    bool merge = n % 4 != 0;
+    uint64_t span = m * 4 > 100000 ? m * 4 : 100000;
+    uint64_t half = span / 2;
+    uint64_t max_gap = 2 * span / m;
+
+    uint64_t* xs = malloc((m + 1) * sizeof(*xs));
+    uint64_t* bottoms = malloc(m * sizeof(*bottoms));
+    uint64_t* tops = malloc(m * sizeof(*tops));
+    NOB_ASSERT(xs && bottoms && tops && "Buy more RAM lol");
+
+    xs[0] = gen_range(rng, 0, max_gap);
+    for (size_t i = 0; i < m; ++i) {
+        xs[i + 1] = xs[i] + gen_range(rng, 1, max_gap);
+        do {
+            bottoms[i] = gen_range(rng, 0, half - 1);
+        } while (i > 0 && bottoms[i] == bottoms[i - 1]);
+        do {
+            tops[i] = gen_range(rng, half + 1, span);
+        } while (i > 0 && tops[i] == tops[i - 1]);
+    }
+    if (merge) bottoms[1] = bottoms[0];
+
+    for (size_t i = 0; i < m; ++i) {
+        if (!(merge && i == 1)) gen__append_point(sb, xs[i], bottoms[i]);
+        if (!(merge && i == 0)) gen__append_point(sb, xs[i + 1], bottoms[i]);
+    }
+    for (size_t i = m; i-- > 0;) {
+        gen__append_point(sb, xs[i + 1], tops[i]);
+        gen__append_point(sb, xs[i], tops[i]);
+    }
+
+    free(xs);
+    free(bottoms);
+    free(tops);
+    return true;
+}
+
+static inline bool gen_q10(Gen_Rng* rng, const Gen_Params* params, Nob_String_Builder* sb) {
+    // The solver enumerates button subsets in an int and lights as bits of an int
+    if (params->buttons > 30 || params->width > 30) {
+        nob_log(NOB_ERROR, "day 10 supports at most 30 buttons and 30 lights");
+        return false;
+    }
+
+    for (size_t i = 0; i < params->size; ++i) {
+        size_t lights = params->width ? params->width : gen_range(rng, 4, 10);
+        size_t buttons = params->buttons ? params->buttons : gen_range(rng, 3, 13);
+        uint32_t masks[30];
+        uint64_t presses[30];
+
+        for (size_t b = 0; b < buttons; ++b) {
+            do {
+                masks[b] = (uint32_t)gen_range(rng, 1, (1ull << lights) - 1);
+            } while (__builtin_popcount(masks[b]) > 5);
+            presses[b] = gen_range(rng, 0, 20);
+        }
+
+        // The target is a nonempty combination of the buttons so part 1 always has an answer, and the
+        // joltages are what pressing every button presses[b] times gives
+        uint32_t target = 0;
+        while (target == 0) {
+            for (size_t b = 0; b < buttons; ++b) {
+                if (gen_chance(rng, 50)) target ^= masks[b];
+            }
+        }
+
+        gen_append_char(sb, '[');
+        for (size_t l = 0; l < lights; ++l) gen_append_char(sb, (target >> l) & 1 ? '#' : '.');
+        gen_append_char(sb, ']');
+
+        for (size_t b = 0; b < buttons; ++b) {
+            gen_append_char(sb, ' ');
+            gen_append_char(sb, '(');
+            bool first = true;
+            for (size_t l = 0; l < lights; ++l) {
+                if (!((masks[b] >> l) & 1)) continue;
+                if (!first) gen_append_char(sb, ',');
+                gen_append_u64(sb, l);
+                first = false;
+            }
+            gen_append_char(sb, ')');
+        }
+
+        gen_append_char(sb, ' ');
+        gen_append_char(sb, '{');
+        for (size_t l = 0; l < lights; ++l) {
+            uint64_t joltage = 0;
+            for (size_t b = 0; b < buttons; ++b) {
+                if ((masks[b] >> l) & 1) joltage += presses[b];
+            }
+            if (l > 0) gen_append_char(sb, ',');
+            gen_append_u64(sb, joltage);
+        }
+        gen_append_char(sb, '}');
+        gen_append_char(sb, '\n');
+    }
+    return true;
+}
+
+// How many devices before out day 11 puts you
+#define GEN_YOU_DISTANCE 16
+// Most paths from any day 11 device to out, so the part 2 answer fits a uint64_t like the real one does
+#define GEN_MAX_PATHS (1ULL << 50)
+
+static const char* const gen__devices[] = {"svr", "you", "fft", "dac", "out"};
+
+// Whether the 3 letter name number value spells one of the named devices
+static inline bool gen__is_named_device(size_t value) {
+    for (size_t i = 0; i < NOB_ARRAY_LEN(gen__devices); ++i) {
+        const char* name = gen__devices[i];
+        if (value == (size_t)((name[0] - 'a') * 26 * 26 + (name[1] - 'a') * 26 + (name[2] - 'a'))) return true;
+    }
+    return false;
+}
+
+// Three letter names like the real input as long as they last, longer ones after that
+static inline void gen__append_device(Nob_String_Builder* sb, const size_t* ids, size_t index, size_t letters) {
+    const size_t named = NOB_ARRAY_LEN(gen__devices);
+    if (ids[index] < named) {
+        nob_sb_append_cstr(sb, gen__devices[ids[index]]);
+        return;
+    }
+
+    size_t value = ids[index] - named;
+    nob_da_reserve(sb, sb->count + letters);
+    for (size_t i = letters; i-- > 0;) {
+        sb->items[sb->count + i] = (char)('a' + value % 26);
+        value /= 26;
+    }
+    sb->count += letters;
+}
+
+static inline bool gen_q11(Gen_Rng* rng, const Gen_Params* params, Nob_String_Builder* sb) {
+    size_t n = params->size;
+    size_t degree = params->degree ? params->degree : 3;
+    if (n < 8) {
+        nob_log(NOB_ERROR, "day 11 needs at least 8 devices");
+        return false;
+    }
+
+    // Devices are laid out in topological order, outputs only point forward so the graph is a DAG.
+    // svr comes first and out last, fft and dac sit in between in the order part 2 expects. Part 1
+    // walks every path from you without memoization, so you stays a few devices before out (the path
+    // count grows exponentially with that distance) and only part 2 scales with the graph. The outputs
+    // are picked from out backwards, counting the paths to out of every device, and an output that
+    // would take a device past GEN_MAX_PATHS is left out. Every part 2 path is a path from svr to out,
+    // so the answer stays below it too.
+    // ids[i] is the name of the device at position i: 0..4 the named ones, the rest a generated name
+    // (skipping the 3 letter ones that spell a named device).
+    size_t letters = 3;
+    size_t capacity = 26 * 26 * 26;
+    while (capacity < n + 5) {
+        capacity *= 26;
+        letters++;
+    }
+
+    size_t* ids = malloc(n * sizeof(*ids));
+    NOB_ASSERT(ids && "Buy more RAM lol");
+    size_t next_name = 5;
+    for (size_t i = 0; i < n; ++i) {
+        while (letters == 3 && gen__is_named_device(next_name - 5)) next_name++;
+        ids[i] = next_name++;
+    }
+    size_t you = 2 * n / 3 + 1;
+    if (n > GEN_YOU_DISTANCE + 1 && n - 1 - GEN_YOU_DISTANCE > you) you = n - 1 - GEN_YOU_DISTANCE;
+    ids[0] = 0;
+    ids[n / 3] = 2;
+    ids[2 * n / 3] = 3;
+    ids[you] = 1;
+    ids[n - 1] = 4;
+
+    // Outputs land within a window ahead, always including the next device so every device reaches out
+    size_t window = 4 * degree + 1;
+    size_t max_outputs = 2 * degree - 1;
+    size_t* outputs = malloc(n * max_outputs * sizeof(*outputs));
+    size_t* output_counts = malloc(n * sizeof(*output_counts));
+    uint64_t* paths = malloc(n * sizeof(*paths));  // to out
+    NOB_ASSERT(outputs && output_counts && paths && "Buy more RAM lol");
+
+    paths[n - 1] = 1;
+    for (size_t i = n - 1; i-- > 0;) {
+        size_t* device_outputs = outputs + i * max_outputs;
+        size_t ahead = n - 1 - i < window ? n - 1 - i : window;
+        size_t count = gen_range(rng, 1, max_outputs);
+        if (count > ahead) count = ahead;
+
+        device_outputs[0] = i + 1;
+        paths[i] = paths[i + 1];
+        size_t found = 1;
+        while (found < count) {
+            size_t target = i + gen_range(rng, 1, ahead);
+            bool duplicate = false;
+            for (size_t k = 0; k < found && !duplicate; ++k) duplicate = device_outputs[k] == target;
+            if (duplicate) continue;
+            if (paths[target] > GEN_MAX_PATHS - paths[i]) {
+                count--;
+                continue;
+            }
+            device_outputs[found++] = target;
+            paths[i] += paths[target];
+        }
+        output_counts[i] = found;
+    }
+
+    for (size_t i = 0; i + 1 < n; ++i) {
+        gen__append_device(sb, ids, i, letters);
+        gen_append_char(sb, ':');
+        for (size_t k = 0; k < output_counts[i]; ++k) {
+            gen_append_char(sb, ' ');
+            gen__append_device(sb, ids, outputs[i * max_outputs + k], letters);
+        }
+        gen_append_char(sb, '\n');
+    }
+
+    free(ids);
+    free(outputs);
+    free(output_counts);
+    free(paths);
+    return true;
+}
+
+static inline bool gen_q12(Gen_Rng* rng, const Gen_Params* params, Nob_String_Builder* sb) {
+    // Six 3x3 presents with 5 to 8 cells, then regions that are between 70% and 110% full by area
+    size_t areas[6];
+    for (size_t shape = 0; shape < 6; ++shape) {
+        uint32_t cells = 0;
+        do {
+            cells = (uint32_t)gen_range(rng, 1, 511);
+        } while (__builtin_popcount(cells) < 5 || __builtin_popcount(cells) > 8);
+        areas[shape] = (size_t)__builtin_popcount(cells);
+
+        gen_append_u64(sb, shape);
+        nob_sb_append_cstr(sb, ":\n");
+        for (size_t row = 0; row < 3; ++row) {
+            for (size_t col = 0; col < 3; ++col) gen_append_char(sb, (cells >> (row * 3 + col)) & 1 ? '#' : '.');
+            gen_append_char(sb, '\n');
+        }
+        gen_append_char(sb, '\n');
+    }
+
+    for (size_t i = 0; i < params->size; ++i) {
+        uint64_t width = gen_range(rng, 35, 50);
+        uint64_t height = gen_range(rng, 35, 50);
+        uint64_t budget = width * height * gen_range(rng, 70, 110) / 100;
+
+        uint64_t requests[6] = {0};
+        for (uint64_t used = 0;;) {
+            size_t shape = (size_t)gen_range(rng, 0, 5);
+            if (used + areas[shape] > budget) break;
+            requests[shape]++;
+            used += areas[shape];
+        }
+
+        gen_append_u64(sb, width);
+        gen_append_char(sb, 'x');
+        gen_append_u64(sb, height);
+        gen_append_char(sb, ':');
+        for (size_t shape = 0; shape < 6; ++shape) {
+            gen_append_char(sb, ' ');
+            gen_append_u64(sb, requests[shape]);
+        }
+        gen_append_char(sb, '\n');
+    }
+    return true;
+}
+
+typedef struct {
+    int number;
+    const char* unit;     // what size counts
+    size_t default_size;  // about the size of the real input
+    size_t min_size;      // the smallest size the generator takes
+    size_t size_step;     // the sizes it takes are multiples of this
+    bool (*generate)(Gen_Rng* rng, const Gen_Params* params, Nob_String_Builder* sb);
+} Gen_Day;
+
+static const Gen_Day gen_days[] = {
+    {1, "rotations", 4445, 1, 1, gen_q1},
+    {2, "id ranges", 38, 1, 1, gen_q2},
+    {3, "battery banks", 200, 1, 1, gen_q3},
+    {4, "grid cells", 139 * 139, 1, 1, gen_q4},
+    {5, "fresh ranges", 187, 1, 1, gen_q5},
+    {6, "problems", 1000, 1, 1, gen_q6},
+    {7, "grid cells", 141 * 141, 1, 1, gen_q7},
+    {8, "junction boxes", 1000, 3, 1, gen_q8},
+    {9, "polygon vertices", 496, 4, 2, gen_q9},
+    {10, "machines", 171, 1, 1, gen_q10},
+    {11, "devices", 568, 8, 1, gen_q11},
+    {12, "regions", 1000, 1, 1, gen_q12},
+};
+
+static inline const Gen_Day* gen_find_day(int number) {
+    for (size_t i = 0; i < NOB_ARRAY_LEN(gen_days); ++i) {
+        if (gen_days[i].number == number) return &gen_days[i];
+    }
+    return NULL;
+}
+
+// The smallest size at or above size that the generator of the day takes
+static inline size_t gen_valid_size(const Gen_Day* day, size_t size) {
+    if (size < day->min_size) size = day->min_size;
+    return (size + day->size_step - 1) / day->size_step * day->size_step;
+}
+
+// Appends the generated input to sb. Returns false (and logs why) when the day has no generator or
+// the parameters do not make a valid input.
+static inline bool gen_input(const Gen_Params* params, Nob_String_Builder* sb) {
+    const Gen_Day* day = gen_find_day(params->day);
+    if (day == NULL) {
+        nob_log(NOB_ERROR, "There is no generator for day %d", params->day);
+        return false;
+    }
+
+    Gen_Params resolved = *params;
+    if (resolved.size == 0) resolved.size = day->default_size;
+
+    // Mixing the day into the seed keeps the days independent of each other for the same seed
+    Gen_Rng rng = {.state = params->seed ^ ((uint64_t)params->day * 0xD1B54A32D192ED03ull)};
+    return day->generate(&rng, &resolved, sb);
+}
+
+#endif  // AOC_GEN_H
@@ -0,0 +1,266 @@
+#ifndef AOC_INPUT_H
+#define AOC_INPUT_H
+
+// Zero-copy input loader shared by every solver.
+//
+// The file is mapped read-only and split into lines once. Every line is a Nob_String_View pointing
+// straight into the mapping (without the trailing '\n'), so nothing is copied and there is no line
+// length limit. Views stay valid until input_free(). lines.text is the whole input, for parsers that
+// go over the bytes themselves (parallel_parse.h), and is set even before the lines are indexed.
+//
+// A path of "-" reads stdin. Pipes, sockets and terminals cannot be mapped, they are read to their end
+// into a buffer instead. Days that get by with one look at every line read those with a Line_Stream,
+// through a fixed buffer, as the input comes in.
+//
+// Include nob.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before input.h"
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+typedef struct {
+    Nob_String_View* items;
+    size_t count;
+    size_t capacity;
+    Nob_String_View text;  // all of the input, the lines point into it
+} Lines;
+
+typedef struct {
+    const char* data;  // start of the mapping
+    size_t size;       // size of the file in bytes
+    bool mapped;       // false for empty files, nothing to unmap
+    bool owned;        // read from a pipe into a malloc()ed buffer
+    Lines lines;       // one view per line, pointing into data
+} Input;
+
+// Returns the offset of the next '\n' in [from, size) or size if there is none.
+static inline size_t input_find_newline(const char* data, size_t from, size_t size) {
+    size_t i = from;
+
+#if defined(__AVX2__)
+    const __m256i nl = _mm256_set1_epi8('\n');
+    for (; i + 32 <= size; i += 32) {
+        __m256i chunk = _mm256_loadu_si256((const __m256i*)(data + i));
+        unsigned mask = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(chunk, nl));
+        if (mask) return i + (size_t)__builtin_ctz(mask);
+    }
+#endif
+
+#if defined(__SSE2__)
+    const __m128i nl16 = _mm_set1_epi8('\n');
+    for (; i + 16 <= size; i += 16) {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(data + i));
+        unsigned mask = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, nl16));
+        if (mask) return i + (size_t)__builtin_ctz(mask);
+    }
+#endif
+
+    const char* hit = memchr(data + i, '\n', size - i);
+    return hit ? (size_t)(hit - data) : size;
+}
+
+// Builds the line index of input->data. A trailing '\n' does not start an extra empty line,
+// which matches what the old fgets() loops produced.
+static inline void input_index_lines(Input* input) {
+    input->lines.count = 0;
+    input->lines.text = nob_sv_from_parts(input->data, input->size);
+
+    size_t start = 0;
+    while (start < input->size) {
+        size_t end = input_find_newline(input->data, start, input->size);
+        nob_da_append(&input->lines, nob_sv_from_parts(input->data + start, end - start));
+        start = end + 1;
+    }
+}
+
+// Opens path for reading, "-" is stdin. The descriptor is the caller's to close either way.
+static inline int input_open(const char* path) {
+    int fd = strcmp(path, "-") == 0 ? dup(STDIN_FILENO) : open(path, O_RDONLY);
+    if (fd < 0) nob_log(NOB_ERROR, "Could not open %s: %s", path, strerror(errno));
+    return fd;
+}
+
+// Whether fd is a regular file, which can be mapped and read more than once
+static inline bool input_is_file(int fd) {
+    struct stat st;
+    return fstat(fd, &st) == 0 && S_ISREG(st.st_mode);
+}
+
+// Reads a pipe to its end, mmap() does not take them
+static inline bool input__read_all(int fd, const char* path, Input* input) {
+    Nob_String_Builder bytes = {0};
+    for (;;) {
+        nob_da_reserve(&bytes, bytes.count + 64 * 1024);
+        ssize_t n = read(fd, bytes.items + bytes.count, bytes.capacity - bytes.count);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            nob_log(NOB_ERROR, "Could not read %s: %s", path, strerror(errno));
+            nob_sb_free(bytes);
+            return false;
+        }
+        if (n == 0) break;
+        bytes.count += (size_t)n;
+    }
+
+    input->data = bytes.items ? bytes.items : "";
+    input->size = bytes.count;
+    input->owned = bytes.items != NULL;
+    input->lines.text = nob_sv_from_parts(input->data, input->size);
+    return true;
+}
+
+// Maps the file without indexing its lines, input_index_lines() does that once they are needed.
+// Takes over fd, path only names it in errors.
+static inline bool input_map_fd(int fd, const char* path, Input* input) {
+    memset(input, 0, sizeof(*input));
+
+    struct stat st;
+    if (fstat(fd, &st) < 0) {
+        nob_log(NOB_ERROR, "Could not stat %s: %s", path, strerror(errno));
+        close(fd);
+        return false;
+    }
+    if (!S_ISREG(st.st_mode)) {
+        bool ok = input__read_all(fd, path, input);
+        close(fd);
+        return ok;
+    }
+
+    input->size = (size_t)st.st_size;
+    if (input->size == 0) {
+        // mmap() refuses zero-length mappings, an empty file simply has no lines.
+        close(fd);
+        input->data = "";
+        input->lines.text = nob_sv_from_parts(input->data, 0);
+        return true;
+    }
+
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    void* data = mmap(NULL, input->size, PROT_READ, flags, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        nob_log(NOB_ERROR, "Could not map %s: %s", path, strerror(errno));
+        return false;
+    }
+    madvise(data, input->size, MADV_SEQUENTIAL);
+
+    input->data = data;
+    input->mapped = true;
+    input->lines.text = nob_sv_from_parts(input->data, input->size);
+    return true;
+}
+
+static inline bool input_map(const char* path, Input* input) {
+    memset(input, 0, sizeof(*input));
+    int fd = input_open(path);
+    if (fd < 0) return false;
+    return input_map_fd(fd, path, input);
+}
+
+static inline bool input_load(const char* path, Input* input) {
+    if (!input_map(path, input)) return false;
+    input_index_lines(input);
+    return true;
+}
+
+// Indexes a buffer that is already in memory (a generated input for example). The buffer is not
+// copied and must outlive the lines, input_free() only frees the index.
+static inline void input_from_memory(const char* data, size_t size, Input* input) {
+    memset(input, 0, sizeof(*input));
+    input->data = size ? data : "";
+    input->size = size;
+    input_index_lines(input);
+}
+
+static inline void input_free(Input* input) {
+    if (input->mapped) munmap((void*)input->data, input->size);
+    if (input->owned) free((void*)input->data);
+    nob_da_free(input->lines);
+    memset(input, 0, sizeof(*input));
+}
+
+#define LINE_STREAM_BUFFER_SIZE (64 * 1024)
+
+// Lines of a descriptor one at a time, read into a buffer of LINE_STREAM_BUFFER_SIZE bytes as they
+// are needed. The unfinished line is moved to the front of the buffer before every read, so it only
+// grows for a line longer than itself. A line stays valid until the next call.
+typedef struct {
+    int fd;
+    char* data;
+    size_t capacity;
+    size_t start;    // of the next line
+    size_t end;      // of the bytes read so far
+    size_t scanned;  // bytes after start known to hold no '\n'
+    bool eof;
+    bool failed;     // a read failed, the lines stopped early
+} Line_Stream;
+
+static inline void line_stream_init(Line_Stream* stream, int fd) {
+    *stream = (Line_Stream){.fd = fd, .capacity = LINE_STREAM_BUFFER_SIZE};
+    stream->data = malloc(stream->capacity);
+    NOB_ASSERT(stream->data != NULL && "Buy more RAM lol");
+}
+
+// The next line without its '\n', false once the input is done. Like input_index_lines(), a trailing
+// '\n' does not make an extra empty line.
+static inline bool line_stream_next(Line_Stream* stream, Nob_String_View* line) {
+    for (;;) {
+        size_t end = input_find_newline(stream->data, stream->start + stream->scanned, stream->end);
+        if (end < stream->end || (stream->eof && stream->start < stream->end)) {
+            *line = nob_sv_from_parts(stream->data + stream->start, end - stream->start);
+            stream->start = end < stream->end ? end + 1 : end;
+            stream->scanned = 0;
+            return true;
+        }
+        if (stream->eof) return false;
+        stream->scanned = stream->end - stream->start;
+
+        if (stream->start > 0) {
+            memmove(stream->data, stream->data + stream->start, stream->end - stream->start);
+            stream->end -= stream->start;
+            stream->start = 0;
+        }
+        if (stream->end == stream->capacity) {
+            stream->capacity *= 2;
+            stream->data = realloc(stream->data, stream->capacity);
+            NOB_ASSERT(stream->data != NULL && "Buy more RAM lol");
+        }
+
+        ssize_t n = read(stream->fd, stream->data + stream->end, stream->capacity - stream->end);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            nob_log(NOB_ERROR, "Could not read the input: %s", strerror(errno));
+            stream->failed = true;
+        }
+        if (n <= 0) {
+            stream->eof = true;
+            continue;
+        }
+        stream->end += (size_t)n;
+    }
+}
+
+// Frees the buffer, the descriptor stays open
+static inline void line_stream_free(Line_Stream* stream) {
+    free(stream->data);
+    *stream = (Line_Stream){0};
+}
+
+#endif  // AOC_INPUT_H
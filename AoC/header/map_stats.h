@@ -0,0 +1,155 @@
+#ifndef AOC_MAP_STATS_H
+#define AOC_MAP_STATS_H
+
+// How well the stb_ds hash maps of a solver are sized and hashed.
+//
+//     MAP_STATS("visited", visited);  // right before shfree(visited)
+//     shfree(visited);
+//
+// Only builds with -DSTBDS_STATISTICS (./nob trace) count anything, everywhere else MAP_STATS() is a
+// no-op. std_ds.h then keeps lookups, probes, grows, shrinks, tombstone rebuilds and rehashes per
+// table, and MAP_STATS() adds a snapshot of them to the running day under the given name. Maps that
+// are built again on every run or every leg add up into one row.
+//
+// The runner prints a table per day and map to stderr after the benchmark report. Probes per lookup
+// far above 1 mean a weak hash for the keys or a too full table, high tombstones a map that wants to be
+// rebuilt or cleared instead of deleted from. In trace builds every snapshot is also a counter event.
+//
+// Like stb_ds, the aoc runner links every day together and src/aoc.c carries the one copy of the
+// table, days built on their own carry their own.
+//
+// Include nob.h and perf.h before this header, std_ds.h before using MAP_STATS().
+
+#ifndef NOB_H_
+#error "include nob.h before map_stats.h"
+#endif
+#ifndef AOC_PERF_H
+#error "include perf.h before map_stats.h"
+#endif
+
+#ifdef STBDS_STATISTICS
+
+#ifndef AOC_RUNNER
+#define AOC_MAP_STATS_IMPLEMENTATION
+#endif
+
+#include <stddef.h>
+#include <stdio.h>
+
+// Mirrors stbds_hash_statistics, this header does not depend on std_ds.h
+typedef struct {
+    size_t slots;
+    size_t used;
+    size_t tombstones;
+    size_t lookups;
+    size_t probes;
+    size_t grows;
+    size_t shrinks;
+    size_t rebuilds;
+    size_t rehash_items;
+    size_t rehash_probes;
+} Map_Sample;
+
+typedef struct {
+    int day;
+    const char* name;
+    size_t maps;        // snapshots taken
+    Map_Sample max;     // slots, used and tombstones of the fullest snapshot
+    Map_Sample totals;  // everything else summed over the snapshots
+} Map_Stats;
+
+typedef struct {
+    Map_Stats* items;
+    size_t count;
+    size_t capacity;
+} Map_Stats_Table;
+
+void map_stats_record(const char* name, Map_Sample sample);
+void map_stats_print(FILE* out);
+
+#define MAP_STATS(name, map)                                                                          \
+    do {                                                                                              \
+        stbds_hash_statistics map_stats__;                                                            \
+        stbds_hmstats((map), &map_stats__);                                                           \
+        map_stats_record((name), (Map_Sample){                                                        \
+                                     .slots = map_stats__.slots,                                      \
+                                     .used = map_stats__.used,                                        \
+                                     .tombstones = map_stats__.tombstones,                            \
+                                     .lookups = map_stats__.lookups,                                  \
+                                     .probes = map_stats__.probes,                                    \
+                                     .grows = map_stats__.grows,                                      \
+                                     .shrinks = map_stats__.shrinks,                                  \
+                                     .rebuilds = map_stats__.rebuilds,                                \
+                                     .rehash_items = map_stats__.rehash_items,                        \
+                                     .rehash_probes = map_stats__.rehash_probes,                      \
+                                 });                                                                  \
+    } while (0)
+
+#ifdef AOC_MAP_STATS_IMPLEMENTATION
+
+#include <string.h>
+
+static Map_Stats_Table map_stats__table = {0};
+
+static double map_stats__ratio(size_t a, size_t b) {
+    return b ? (double)a / (double)b : 0.0;
+}
+
+void map_stats_record(const char* name, Map_Sample sample) {
+    Map_Stats* stats = NULL;
+    for (size_t i = 0; i < map_stats__table.count; ++i) {
+        Map_Stats* it = &map_stats__table.items[i];
+        if (it->day == perf_state.day && strcmp(it->name, name) == 0) stats = it;
+    }
+    if (stats == NULL) {
+        Map_Stats fresh = {.day = perf_state.day, .name = name};
+        nob_da_append(&map_stats__table, fresh);
+        stats = &map_stats__table.items[map_stats__table.count - 1];
+    }
+
+    stats->maps++;
+    if (sample.used >= stats->max.used) {
+        stats->max.slots = sample.slots;
+        stats->max.used = sample.used;
+    }
+    if (sample.tombstones > stats->max.tombstones) stats->max.tombstones = sample.tombstones;
+    stats->totals.lookups += sample.lookups;
+    stats->totals.probes += sample.probes;
+    stats->totals.grows += sample.grows;
+    stats->totals.shrinks += sample.shrinks;
+    stats->totals.rebuilds += sample.rebuilds;
+    stats->totals.rehash_items += sample.rehash_items;
+    stats->totals.rehash_probes += sample.rehash_probes;
+
+    TRACE_COUNTER(name, "load", map_stats__ratio(sample.used, sample.slots));
+    TRACE_COUNTER(name, "probes/lookup", map_stats__ratio(sample.probes, sample.lookups));
+    TRACE_COUNTER(name, "tombstones", (double)sample.tombstones);
+}
+
+void map_stats_print(FILE* out) {
+    if (map_stats__table.count == 0) return;
+
+    fprintf(out, "\n%-4s %-18s %6s %10s %10s %6s %10s %12s %8s %6s %7s %8s %10s\n", "day", "map", "maps", "slots", "used",
+            "load", "tombstones", "lookups", "probes/l", "grows", "shrinks", "rebuilds", "rehashed");
+    for (size_t i = 0; i < map_stats__table.count; ++i) {
+        const Map_Stats* stats = &map_stats__table.items[i];
+        fprintf(out, "%-4d %-18s %6zu %10zu %10zu %6.2f %10zu %12zu %8.2f %6zu %7zu %8zu %10zu\n", stats->day,
+                stats->name, stats->maps, stats->max.slots, stats->max.used,
+                map_stats__ratio(stats->max.used, stats->max.slots), stats->max.tombstones, stats->totals.lookups,
+                map_stats__ratio(stats->totals.probes, stats->totals.lookups), stats->totals.grows,
+                stats->totals.shrinks, stats->totals.rebuilds, stats->totals.rehash_items);
+    }
+    nob_da_free(map_stats__table);
+    map_stats__table = (Map_Stats_Table){0};
+}
+
+#endif  // AOC_MAP_STATS_IMPLEMENTATION
+
+#else
+
+#define MAP_STATS(name, map) ((void)0)
+#define map_stats_print(out) ((void)0)
+
+#endif  // STBDS_STATISTICS
+
+#endif  // AOC_MAP_STATS_H
@@ -0,0 +1,189 @@
+#ifndef AOC_PARALLEL_PARSE_H
+#define AOC_PARALLEL_PARSE_H
+
+// Line by line parsing of a whole text on the thread pool of pool.h.
+//
+//     static Parse_Result parse_point(Nob_String_View line, const void* ctx, Arena* arena, void* record) {
+//         if (line.count == 0) return PARSE_SKIP;  // no record in this line
+//         parse_i64_fields(line, ',', ((Point*)record)->coordinates, 3);
+//         return PARSE_RECORD;
+//     }
+//     size_t count = 0;
+//     Point* points = parallel_parse_lines(lines->text, sizeof(Point), parse_point, NULL, NULL, &count, NULL);
+//
+// The text is cut into chunks of about the same size, every cut moved forward past the next '\n' so
+// no line is split. Every chunk is parsed by one worker into an array of its own, then the prefix sum
+// of the chunk counts tells every chunk where its records go and the arrays are copied into one
+// malloc()ed array, the records in the order of their lines. The lines are the ones of
+// input_index_lines(), without their '\n' and without an empty one after a trailing '\n'.
+//
+// The callback is a Parse_Line_Fn (record.h), the one a Pipeline_Stream takes, and runs on the pool
+// workers, so it must only write the record and worker local state. Given an arena, every chunk
+// parses with an arena of its own, moved into the given one at the end, so records may allocate.
+// Texts below PARALLEL_PARSE_MIN_CHUNK bytes and pools of one worker make a single chunk, parsed by
+// the calling thread straight into the result.
+//
+// Include nob.h, input.h, arena.h and pool.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before parallel_parse.h"
+#endif
+#ifndef AOC_INPUT_H
+#error "include input.h before parallel_parse.h"
+#endif
+#ifndef AOC_POOL_H
+#error "include pool.h before parallel_parse.h"
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "record.h"
+
+#define PARALLEL_PARSE_MIN_CHUNK (256 * 1024)
+#define PARALLEL_PARSE_CHUNKS_PER_WORKER 4  // spare chunks for the workers that finish early to steal
+
+// One chunk of the text and the records of its lines, padded so neighbours do not share a cache line
+typedef struct {
+    size_t begin, end;  // byte offsets, begin is the start of a line
+    char* items;
+    size_t count;
+    size_t capacity;
+    size_t offset;  // of the first record in the joined array
+    Arena arena;
+} __attribute__((aligned(64))) Parallel_Parse__Chunk;
+
+typedef struct {
+    const char* data;
+    size_t size;
+    size_t record_size;
+    Parse_Line_Fn parse;
+    const void* ctx;
+    bool with_arena;
+    Parallel_Parse__Chunk* chunks;
+    char* records;
+    bool failed;  // set atomically by the chunk that found a PARSE_BAD line
+} Parallel_Parse;
+
+static inline void parallel_parse__chunks(size_t begin, size_t end, Pool_Worker* worker, void* ctx) {
+    (void)worker;
+    Parallel_Parse* parse = ctx;
+
+    for (size_t i = begin; i < end; ++i) {
+        Parallel_Parse__Chunk* chunk = &parse->chunks[i];
+        TRACE_BEGIN("parse chunk");
+        size_t start = chunk->begin;
+        while (start < chunk->end) {
+            size_t stop = input_find_newline(parse->data, start, chunk->end);
+            if (chunk->count == chunk->capacity) {
+                chunk->capacity = chunk->capacity ? 2 * chunk->capacity : 256;
+                chunk->items = realloc(chunk->items, chunk->capacity * parse->record_size);
+                NOB_ASSERT(chunk->items != NULL && "Buy more RAM lol");
+            }
+            Nob_String_View line = nob_sv_from_parts(parse->data + start, stop - start);
+            void* record = chunk->items + chunk->count * parse->record_size;
+            Arena* arena = parse->with_arena ? &chunk->arena : NULL;
+            Parse_Result parsed = parse->parse(line, parse->ctx, arena, record);
+            if (parsed == PARSE_RECORD) chunk->count++;
+            if (parsed == PARSE_BAD) {
+                __atomic_store_n(&parse->failed, true, __ATOMIC_RELAXED);
+                break;
+            }
+            start = stop + 1;
+        }
+        TRACE_END();
+    }
+}
+
+static inline void parallel_parse__join(size_t begin, size_t end, Pool_Worker* worker, void* ctx) {
+    (void)worker;
+    Parallel_Parse* parse = ctx;
+
+    for (size_t i = begin; i < end; ++i) {
+        Parallel_Parse__Chunk* chunk = &parse->chunks[i];
+        if (chunk->count) {
+            memcpy(parse->records + chunk->offset * parse->record_size, chunk->items,
+                   chunk->count * parse->record_size);
+        }
+        free(chunk->items);
+        chunk->items = NULL;
+    }
+}
+
+// The records of every line of text that parse accepted, in line order, as one array to free() (NULL
+// when there are none). *count is set to the number of records. What the records allocate goes to
+// arena, NULL when they allocate nothing. A PARSE_BAD line sets *failed, NULL when the callback never
+// returns it, and makes the result NULL.
+static inline void* parallel_parse_lines(Nob_String_View text, size_t record_size, Parse_Line_Fn parse_line,
+                                         const void* ctx, Arena* arena, size_t* count, bool* failed) {
+    *count = 0;
+    if (failed) *failed = false;
+    if (text.count == 0) return NULL;
+
+    size_t workers = pool_worker_count();
+    size_t chunk_count = workers > 1 ? workers * PARALLEL_PARSE_CHUNKS_PER_WORKER : 1;
+    if (chunk_count > text.count / PARALLEL_PARSE_MIN_CHUNK) chunk_count = text.count / PARALLEL_PARSE_MIN_CHUNK;
+    if (chunk_count == 0) chunk_count = 1;
+
+    Parallel_Parse parse = {
+        .data = text.data,
+        .size = text.count,
+        .record_size = record_size,
+        .parse = parse_line,
+        .ctx = ctx,
+        .with_arena = arena != NULL,
+        .chunks = aligned_alloc(64, chunk_count * sizeof(Parallel_Parse__Chunk)),
+    };
+    NOB_ASSERT(parse.chunks != NULL && "Buy more RAM lol");
+
+    // Every cut goes right after the first '\n' at or past the even split, so it starts a line. Long
+    // lines can swallow the next cuts, those chunks are left empty.
+    size_t begin = 0;
+    for (size_t i = 0; i < chunk_count; ++i) {
+        size_t end = text.count;
+        if (i + 1 < chunk_count) {
+            size_t cut = text.count / chunk_count * (i + 1);
+            if (cut < begin) cut = begin;
+            end = cut < text.count ? input_find_newline(text.data, cut, text.count) + 1 : text.count;
+            if (end > text.count) end = text.count;
+        }
+        parse.chunks[i] = (Parallel_Parse__Chunk){.begin = begin, .end = end};
+        if (arena) parse.chunks[i].arena = (Arena){.block_size = arena->block_size, .huge_pages = arena->huge_pages};
+        begin = end;
+    }
+
+    parallel_for(0, chunk_count, 1, parallel_parse__chunks, &parse);
+    if (arena) {
+        for (size_t i = 0; i < chunk_count; ++i) arena_adopt(arena, &parse.chunks[i].arena);
+    }
+
+    if (parse.failed) {
+        for (size_t i = 0; i < chunk_count; ++i) free(parse.chunks[i].items);
+        free(parse.chunks);
+        if (failed) *failed = true;
+        return NULL;
+    }
+
+    for (size_t i = 0; i < chunk_count; ++i) {
+        parse.chunks[i].offset = *count;
+        *count += parse.chunks[i].count;
+    }
+
+    if (chunk_count == 1 && *count) {
+        // Nothing to join, the one array is the result
+        parse.records = parse.chunks[0].items;
+    } else {
+        if (*count) {
+            parse.records = malloc(*count * record_size);
+            NOB_ASSERT(parse.records != NULL && "Buy more RAM lol");
+        }
+        parallel_for(0, chunk_count, 1, parallel_parse__join, &parse);
+    }
+
+    free(parse.chunks);
+    return parse.records;
+}
+
+#endif  // AOC_PARALLEL_PARSE_H
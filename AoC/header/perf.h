@@ -0,0 +1,258 @@
+#ifndef AOC_PERF_H
+#define AOC_PERF_H
+
+// Hardware performance counters around named phases of a solver.
+//
+//     perf_begin("edge build");
+//     ...
+//     perf_end(edges->count);  // elements processed, for the misses per element columns
+//
+// Phases nest and are accumulated per day and name. The runner wraps parse, part1 and part2 itself,
+// solvers only mark the interesting steps inside them. Nothing is measured until perf_start() is
+// called (aoc --perf), before that perf_begin()/perf_end() are a single branch.
+//
+// Cycles, instructions, L1D read misses, LLC misses and branch misses are read as one
+// perf_event_open() group of the calling thread, user space only. Counters the CPU or the kernel do
+// not offer are left out, and when none can be opened at all (containers, perf_event_paranoid) the
+// phases are still timed.
+//
+// Only the calling thread is counted. Work a phase hands to the pool of pool.h (the parallel loops of
+// days 8, 9 and 10) or to the pipeline threads is in its time but not in its counters. Inherited
+// counters would not help: the kernel adds a thread's counts to its parent only when it exits, and
+// the pool threads never do. perf_start() says so in its output.
+//
+// Like stb_ds, the aoc runner links every day together and src/aoc.c carries the one copy of the
+// phase table, days built on their own carry their own.
+//
+// Include nob.h and bench.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before perf.h"
+#endif
+#ifndef AOC_BENCH_H
+#error "include bench.h before perf.h"
+#endif
+
+#ifndef AOC_RUNNER
+#define AOC_PERF_IMPLEMENTATION
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "alloc.h"
+#include "trace.h"
+
+typedef struct {
+    int day;
+    const char* name;
+    size_t runs;
+    uint64_t elements;                       // summed over the runs
+    uint64_t counters[BENCH_COUNTER_COUNT];  // summed over the runs
+    Bench_Samples samples;                   // wall time of every run
+} Perf_Phase;
+
+typedef struct {
+    Perf_Phase* items;
+    size_t count;
+    size_t capacity;
+} Perf_Phases;
+
+typedef struct {
+    bool active;
+    int day;
+    unsigned counter_mask;  // bit per Bench_Counter that could be opened
+} Perf_State;
+
+extern Perf_State perf_state;
+
+// Opens the counters and starts recording. Returns false when only timers are available.
+bool perf_start(void);
+void perf_stop(void);
+void perf__begin(const char* name);
+void perf__end(uint64_t elements);
+const Perf_Phases* perf_phases(void);
+const Perf_Phase* perf_find(int day, const char* name);
+
+static inline void perf_set_day(int day) {
+    perf_state.day = day;
+    ALLOC_DAY(day);
+}
+
+// Phases are also trace events in -DAOC_TRACE builds and allocation phases in -DAOC_ALLOC builds
+static inline void perf_begin(const char* name) {
+    TRACE_BEGIN(name);
+    ALLOC_BEGIN(name);
+    if (perf_state.active) perf__begin(name);
+}
+
+static inline void perf_end(uint64_t elements) {
+    if (perf_state.active) perf__end(elements);
+    ALLOC_END();
+    TRACE_END();
+}
+
+// Turns a phase into a report row with per run averages
+static inline Bench_Row perf_row(const Perf_Phase* phase) {
+    Bench_Samples samples = phase->samples;
+    Bench_Row row = {
+        .day = phase->day,
+        .phase = phase->name,
+        .stats = bench_stats(&samples),
+        .counter_mask = perf_state.counter_mask,
+    };
+    double runs = phase->runs ? (double)phase->runs : 1.0;
+    row.elements = (uint64_t)((double)phase->elements / runs);
+    for (size_t c = 0; c < BENCH_COUNTER_COUNT; ++c) row.counters[c] = (double)phase->counters[c] / runs;
+    return row;
+}
+
+#ifdef AOC_PERF_IMPLEMENTATION
+
+#include <errno.h>
+#include <linux/perf_event.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#define PERF_MAX_DEPTH 16
+
+typedef struct {
+    const char* name;
+    uint64_t start_ns;
+    uint64_t values[BENCH_COUNTER_COUNT];
+} Perf_Frame;
+
+Perf_State perf_state = {0};
+
+static Perf_Phases perf__phases = {0};
+static Perf_Frame perf__stack[PERF_MAX_DEPTH];
+static size_t perf__depth = 0;
+static int perf__fds[BENCH_COUNTER_COUNT];
+static int perf__leader = -1;
+static Bench_Counter perf__order[BENCH_COUNTER_COUNT];  // counter of each value in a group read
+static size_t perf__opened = 0;
+
+static int perf__open(uint32_t type, uint64_t config, int group) {
+    struct perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.size = sizeof(attr);
+    attr.type = type;
+    attr.config = config;
+    attr.disabled = group == -1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    attr.read_format = PERF_FORMAT_GROUP;
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, group, 0);
+}
+
+bool perf_start(void) {
+    static const struct {
+        uint32_t type;
+        uint64_t config;
+    } events[BENCH_COUNTER_COUNT] = {
+        [BENCH_CYCLES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        [BENCH_INSTRUCTIONS] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        [BENCH_L1D_MISSES] = {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                                      (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        [BENCH_LLC_MISSES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        [BENCH_BRANCH_MISSES] = {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    };
+
+    perf_state.active = true;
+    perf_state.counter_mask = 0;
+    perf__opened = 0;
+
+    int error = 0;
+    for (size_t c = 0; c < BENCH_COUNTER_COUNT; ++c) {
+        perf__fds[c] = perf__open(events[c].type, events[c].config, perf__leader);
+        if (perf__fds[c] < 0) {
+            if (error == 0) error = errno;
+            continue;
+        }
+        if (perf__leader < 0) perf__leader = perf__fds[c];
+        perf__order[perf__opened++] = (Bench_Counter)c;
+        perf_state.counter_mask |= 1u << c;
+    }
+
+    if (perf__leader < 0) {
+        nob_log(NOB_WARNING, "Hardware counters are not available (%s), phases are only timed", strerror(error));
+        return false;
+    }
+    ioctl(perf__leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(perf__leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    nob_log(NOB_INFO, "Counting the main thread only, work on pool and pipeline threads is timed but not counted");
+    return true;
+}
+
+void perf_stop(void) {
+    for (size_t c = 0; c < BENCH_COUNTER_COUNT; ++c) {
+        if (perf_state.counter_mask >> c & 1) close(perf__fds[c]);
+    }
+    for (size_t i = 0; i < perf__phases.count; ++i) nob_da_free(perf__phases.items[i].samples);
+    nob_da_free(perf__phases);
+    perf__leader = -1;
+    perf__depth = 0;
+    perf_state = (Perf_State){0};
+}
+
+static void perf__read(uint64_t* values) {
+    if (perf__leader < 0) return;
+
+    uint64_t buffer[1 + BENCH_COUNTER_COUNT];
+    ssize_t got = read(perf__leader, buffer, sizeof(buffer));
+    if (got < (ssize_t)sizeof(uint64_t)) return;
+    for (size_t i = 0; i < buffer[0] && i < perf__opened; ++i) values[perf__order[i]] = buffer[1 + i];
+}
+
+void perf__begin(const char* name) {
+    NOB_ASSERT(perf__depth < PERF_MAX_DEPTH && "perf phases nest too deep");
+    Perf_Frame* frame = &perf__stack[perf__depth++];
+    frame->name = name;
+    memset(frame->values, 0, sizeof(frame->values));
+    // Counters first and the clock last, so reading the counters is not part of the phase
+    perf__read(frame->values);
+    frame->start_ns = bench_now_ns();
+}
+
+static Perf_Phase* perf__phase(int day, const char* name) {
+    Perf_Phase* found = (Perf_Phase*)perf_find(day, name);
+    if (found) return found;
+
+    Perf_Phase phase = {.day = day, .name = name};
+    nob_da_append(&perf__phases, phase);
+    return &perf__phases.items[perf__phases.count - 1];
+}
+
+void perf__end(uint64_t elements) {
+    uint64_t end_ns = bench_now_ns();
+    uint64_t values[BENCH_COUNTER_COUNT] = {0};
+    perf__read(values);
+
+    NOB_ASSERT(perf__depth > 0 && "perf_end() without perf_begin()");
+    Perf_Frame* frame = &perf__stack[--perf__depth];
+
+    Perf_Phase* phase = perf__phase(perf_state.day, frame->name);
+    phase->runs++;
+    phase->elements += elements;
+    for (size_t c = 0; c < BENCH_COUNTER_COUNT; ++c) phase->counters[c] += values[c] - frame->values[c];
+    nob_da_append(&phase->samples, end_ns - frame->start_ns);
+}
+
+const Perf_Phases* perf_phases(void) {
+    return &perf__phases;
+}
+
+const Perf_Phase* perf_find(int day, const char* name) {
+    for (size_t i = 0; i < perf__phases.count; ++i) {
+        const Perf_Phase* phase = &perf__phases.items[i];
+        if (phase->day == day && strcmp(phase->name, name) == 0) return phase;
+    }
+    return NULL;
+}
+
+#endif  // AOC_PERF_IMPLEMENTATION
+
+#endif  // AOC_PERF_H
@@ -0,0 +1,434 @@
+#ifndef AOC_PIPELINE_H
+#define AOC_PIPELINE_H
+
+// Streaming solver for days whose records do not depend on each other, `aoc --pipeline` in the runner.
+//
+//     static Parse_Result parse_bank(Nob_String_View text, const void* shared, Arena* arena, void* record) {
+//         if (text.count == 0) return PARSE_SKIP;  // no record in this text
+//         *(Nob_String_View*)record = text;       // records may point into their chunk
+//         return PARSE_RECORD;                    // PARSE_BAD fails the whole run
+//     }
+//     static void solve_bank(const void* record, const void* shared, uint64_t answers[2]) {
+//         answers[0] += ...;  // the answers of both parts are sums over the records
+//     }
+//     static const Pipeline_Stream stream = {.record_size = sizeof(Nob_String_View), .parse = parse_bank,
+//                                            .solve = solve_bank};
+//
+// Reading, parsing and solving overlap instead of running one after the other:
+//
+//   - the calling thread read()s the input into chunks of PIPELINE_CHUNK_SIZE cut after the last delimiter,
+//   - parser threads split the chunks into records, PIPELINE_BATCH_SIZE records per batch,
+//   - solver threads fold the batches into answers of their own, summed up once the input is done.
+//
+// A fixed set of chunk buffers goes around the stages and back to the reader once every batch cut from
+// it is solved, and the queue of batches is bounded, so a slow stage holds the ones before it back and
+// the memory does not grow with the input. A record lives until its batch is solved, it may point into
+// its chunk and allocate from the arena of its batch. .parse is a Parse_Line_Fn (record.h) with the
+// shared state as its ctx, the same callback can parse the lines of a whole text with parallel_parse.h.
+//
+// Days whose first lines are not records (the gift shapes of day 12) read them with .header before
+// the stages start, what it returns is the shared state every record is parsed and solved against.
+// There are $AOC_THREADS (or one per online CPU) parsers and as many solvers, halved, at least one each.
+// Should any of their threads not start, pipeline_run() stops the others and returns before reading, so
+// the caller can still parse the input in one piece.
+//
+// Include nob.h, input.h and arena.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before pipeline.h"
+#endif
+#ifndef AOC_INPUT_H
+#error "include input.h before pipeline.h"
+#endif
+#ifndef AOC_ARENA_H
+#error "include arena.h before pipeline.h"
+#endif
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "record.h"
+#include "trace.h"
+
+#define PIPELINE_CHUNK_SIZE (1024 * 1024)
+#define PIPELINE_BATCH_SIZE 1024
+#define PIPELINE_BATCH_ARENA_SIZE (64 * 1024)
+
+typedef struct {
+    char delimiter;      // between records, '\n' when 0
+    size_t record_size;
+    size_t header_lines;                         // lines read by .header before the first record
+    void* (*header)(const Lines* lines);         // NULL result means the header was malformed
+    void (*free_header)(void* shared);
+    Parse_Line_Fn parse;  // called with the shared state as ctx, PARSE_BAD fails the run
+    void (*solve)(const void* record, const void* shared, uint64_t answers[2]);
+} Pipeline_Stream;
+
+typedef enum {
+    PIPELINE_OK,
+    PIPELINE_FAILED,
+    PIPELINE_NO_THREADS,  // nothing was read, the input can still be parsed without the pipeline
+} Pipeline_Result;
+
+// Blocking queue of pointers with a fixed capacity
+typedef struct {
+    void** items;
+    size_t capacity;
+    size_t head;
+    size_t count;
+    bool closed;
+    pthread_mutex_t lock;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+} Pipeline__Queue;
+
+typedef struct {
+    char* data;
+    size_t size;
+    size_t capacity;
+    size_t pending;  // batches not solved yet, plus one while a parser still cuts it
+} Pipeline__Chunk;
+
+typedef struct {
+    Pipeline__Chunk* chunk;
+    Arena arena;
+    size_t count;
+    char records[];
+} Pipeline__Batch;
+
+typedef struct Pipeline Pipeline;
+
+typedef struct {
+    Pipeline* pipeline;
+    pthread_t thread;
+    uint64_t answers[2];  // of a solver
+} __attribute__((aligned(64))) Pipeline__Thread;
+
+struct Pipeline {
+    const Pipeline_Stream* stream;
+    const void* shared;
+    char delimiter;
+    int fd;
+    Nob_String_Builder carry;  // the unfinished record at the end of the last chunk, reader only
+
+    Pipeline__Chunk* chunks;
+    size_t chunk_count;
+    Pipeline__Queue free_chunks;
+    Pipeline__Queue chunk_queue;
+    Pipeline__Queue batch_queue;
+    bool failed;  // set atomically, by the reader and by the parsers
+};
+
+static inline void pipeline__queue_init(Pipeline__Queue* queue, size_t capacity) {
+    *queue = (Pipeline__Queue){.capacity = capacity, .items = malloc(capacity * sizeof(void*))};
+    NOB_ASSERT(queue->items != NULL && "Buy more RAM lol");
+    pthread_mutex_init(&queue->lock, NULL);
+    pthread_cond_init(&queue->not_empty, NULL);
+    pthread_cond_init(&queue->not_full, NULL);
+}
+
+static inline void pipeline__queue_destroy(Pipeline__Queue* queue) {
+    pthread_mutex_destroy(&queue->lock);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_cond_destroy(&queue->not_full);
+    free(queue->items);
+}
+
+static inline void pipeline__push(Pipeline__Queue* queue, void* item) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == queue->capacity) pthread_cond_wait(&queue->not_full, &queue->lock);
+    queue->items[(queue->head + queue->count++) % queue->capacity] = item;
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+// NULL once the queue is closed and empty
+static inline void* pipeline__pop(Pipeline__Queue* queue) {
+    pthread_mutex_lock(&queue->lock);
+    while (queue->count == 0 && !queue->closed) pthread_cond_wait(&queue->not_empty, &queue->lock);
+    void* item = NULL;
+    if (queue->count > 0) {
+        item = queue->items[queue->head];
+        queue->head = (queue->head + 1) % queue->capacity;
+        queue->count--;
+        pthread_cond_signal(&queue->not_full);
+    }
+    pthread_mutex_unlock(&queue->lock);
+    return item;
+}
+
+static inline void pipeline__close(Pipeline__Queue* queue) {
+    pthread_mutex_lock(&queue->lock);
+    queue->closed = true;
+    pthread_cond_broadcast(&queue->not_empty);
+    pthread_mutex_unlock(&queue->lock);
+}
+
+static inline size_t pipeline__find(const char* data, size_t from, size_t size, char delimiter) {
+    if (delimiter == '\n') return input_find_newline(data, from, size);
+    const char* hit = memchr(data + from, delimiter, size - from);
+    return hit ? (size_t)(hit - data) : size;
+}
+
+// Offset one past the last delimiter, 0 when there is none
+static inline size_t pipeline__cut(const char* data, size_t size, char delimiter) {
+    for (size_t i = size; i > 0; --i) {
+        if (data[i - 1] == delimiter) return i;
+    }
+    return 0;
+}
+
+static inline void pipeline__release(Pipeline* pipeline, Pipeline__Chunk* chunk) {
+    if (__atomic_sub_fetch(&chunk->pending, 1, __ATOMIC_ACQ_REL) == 0) {
+        pipeline__push(&pipeline->free_chunks, chunk);
+    }
+}
+
+static inline void pipeline__reader(Pipeline* pipeline) {
+    TRACE_BEGIN("pipeline reader");
+
+    // A malformed record fails the run, the rest of the input is not worth reading
+    bool eof = false;
+    while (!eof && !__atomic_load_n(&pipeline->failed, __ATOMIC_RELAXED)) {
+        Pipeline__Chunk* chunk = pipeline__pop(&pipeline->free_chunks);
+        if (chunk->capacity < pipeline->carry.count + PIPELINE_CHUNK_SIZE / 2) {
+            chunk->capacity = pipeline->carry.count + PIPELINE_CHUNK_SIZE;
+            chunk->data = realloc(chunk->data, chunk->capacity);
+            NOB_ASSERT(chunk->data != NULL && "Buy more RAM lol");
+        }
+        if (pipeline->carry.count) memcpy(chunk->data, pipeline->carry.items, pipeline->carry.count);
+        chunk->size = pipeline->carry.count;
+        pipeline->carry.count = 0;
+
+        // Fill the chunk, a record longer than the whole chunk makes it grow
+        for (;;) {
+            if (chunk->size == chunk->capacity) {
+                if (pipeline__cut(chunk->data, chunk->size, pipeline->delimiter) > 0) break;
+                chunk->capacity *= 2;
+                chunk->data = realloc(chunk->data, chunk->capacity);
+                NOB_ASSERT(chunk->data != NULL && "Buy more RAM lol");
+            }
+            ssize_t n = read(pipeline->fd, chunk->data + chunk->size, chunk->capacity - chunk->size);
+            if (n < 0 && errno == EINTR) continue;
+            if (n < 0) {
+                nob_log(NOB_ERROR, "Could not read the input: %s", strerror(errno));
+                __atomic_store_n(&pipeline->failed, true, __ATOMIC_RELAXED);
+            }
+            if (n <= 0) {
+                eof = true;
+                break;
+            }
+            chunk->size += (size_t)n;
+        }
+
+        if (!eof) {
+            size_t cut = pipeline__cut(chunk->data, chunk->size, pipeline->delimiter);
+            nob_sb_append_buf(&pipeline->carry, chunk->data + cut, chunk->size - cut);
+            chunk->size = cut;
+        }
+        if (chunk->size == 0) {
+            pipeline__push(&pipeline->free_chunks, chunk);
+            continue;
+        }
+        chunk->pending = 1;
+        pipeline__push(&pipeline->chunk_queue, chunk);
+    }
+    TRACE_END();
+}
+
+static inline Pipeline__Batch* pipeline__new_batch(const Pipeline* pipeline, Pipeline__Chunk* chunk) {
+    Pipeline__Batch* batch = malloc(sizeof(Pipeline__Batch) + PIPELINE_BATCH_SIZE * pipeline->stream->record_size);
+    NOB_ASSERT(batch != NULL && "Buy more RAM lol");
+    *batch = (Pipeline__Batch){.chunk = chunk, .arena = {.block_size = PIPELINE_BATCH_ARENA_SIZE}};
+    return batch;
+}
+
+static inline void pipeline__free_batch(Pipeline__Batch* batch) {
+    arena_free(&batch->arena);
+    free(batch);
+}
+
+static inline void* pipeline__parser(void* arg) {
+    Pipeline* pipeline = ((Pipeline__Thread*)arg)->pipeline;
+    const Pipeline_Stream* stream = pipeline->stream;
+    TRACE_BEGIN("pipeline parser");
+
+    Pipeline__Chunk* chunk;
+    while ((chunk = pipeline__pop(&pipeline->chunk_queue))) {
+        Pipeline__Batch* batch = pipeline__new_batch(pipeline, chunk);
+        size_t start = 0;
+        while (start < chunk->size) {
+            size_t end = pipeline__find(chunk->data, start, chunk->size, pipeline->delimiter);
+            Nob_String_View text = nob_sv_from_parts(chunk->data + start, end - start);
+            start = end + 1;
+
+            void* record = batch->records + batch->count * stream->record_size;
+            Parse_Result parsed = stream->parse(text, pipeline->shared, &batch->arena, record);
+            if (parsed == PARSE_BAD) __atomic_store_n(&pipeline->failed, true, __ATOMIC_RELAXED);
+            if (parsed != PARSE_RECORD) continue;
+            if (++batch->count == PIPELINE_BATCH_SIZE) {
+                __atomic_add_fetch(&chunk->pending, 1, __ATOMIC_ACQ_REL);
+                pipeline__push(&pipeline->batch_queue, batch);
+                batch = pipeline__new_batch(pipeline, chunk);
+            }
+        }
+
+        if (batch->count > 0) {
+            __atomic_add_fetch(&chunk->pending, 1, __ATOMIC_ACQ_REL);
+            pipeline__push(&pipeline->batch_queue, batch);
+        } else {
+            pipeline__free_batch(batch);
+        }
+        pipeline__release(pipeline, chunk);
+    }
+
+    TRACE_END();
+    return NULL;
+}
+
+static inline void* pipeline__solver(void* arg) {
+    Pipeline__Thread* self = arg;
+    Pipeline* pipeline = self->pipeline;
+    const Pipeline_Stream* stream = pipeline->stream;
+    TRACE_BEGIN("pipeline solver");
+
+    Pipeline__Batch* batch;
+    while ((batch = pipeline__pop(&pipeline->batch_queue))) {
+        for (size_t i = 0; i < batch->count; ++i) {
+            stream->solve(batch->records + i * stream->record_size, pipeline->shared, self->answers);
+        }
+        Pipeline__Chunk* chunk = batch->chunk;
+        pipeline__free_batch(batch);
+        pipeline__release(pipeline, chunk);
+    }
+
+    TRACE_END();
+    return NULL;
+}
+
+// Reads the header lines of the stream, whatever follows them is left in the carry for the reader
+static inline void* pipeline__header(Pipeline* pipeline) {
+    const Pipeline_Stream* stream = pipeline->stream;
+    Nob_String_Builder* carry = &pipeline->carry;
+    size_t lines = 0, scanned = 0;
+    char buffer[64 * 1024];
+
+    while (lines < stream->header_lines) {
+        size_t end = pipeline__find(carry->items, scanned, carry->count, '\n');
+        if (end < carry->count) {
+            lines++;
+            scanned = end + 1;
+            continue;
+        }
+        scanned = carry->count;
+        ssize_t n = read(pipeline->fd, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            nob_log(NOB_ERROR, "Could not read the input: %s", strerror(errno));
+            return NULL;
+        }
+        if (n == 0) break;
+        nob_sb_append_buf(carry, buffer, (size_t)n);
+    }
+
+    Input header = {0};
+    input_from_memory(carry->items, scanned, &header);
+    void* shared = stream->header(&header.lines);
+    input_free(&header);
+
+    memmove(carry->items, carry->items + scanned, carry->count - scanned);
+    carry->count -= scanned;
+    return shared;
+}
+
+static inline size_t pipeline__thread_count(void) {
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    const char* threads = getenv("AOC_THREADS");
+    if (threads && atol(threads) > 0) count = atol(threads);
+    return count / 2 > 1 ? (size_t)count / 2 : 1;
+}
+
+// Closes the queues behind the reader and joins the started threads of the parsers, threads[0, per_stage),
+// and of the solvers, threads[per_stage, 2 * per_stage). The answers of the solvers go to answers.
+static inline void pipeline__join(Pipeline* pipeline, Pipeline__Thread* threads, size_t per_stage, size_t started,
+                                  uint64_t answers[2]) {
+    // The batch queue is closed once no parser is left to fill it
+    pipeline__close(&pipeline->chunk_queue);
+    for (size_t i = 0; i < per_stage && i < started; ++i) pthread_join(threads[i].thread, NULL);
+    pipeline__close(&pipeline->batch_queue);
+    for (size_t i = per_stage; i < started; ++i) {
+        pthread_join(threads[i].thread, NULL);
+        answers[0] += threads[i].answers[0];
+        answers[1] += threads[i].answers[1];
+    }
+}
+
+// Streams fd through the stages and adds the answers of all records to answers. PIPELINE_FAILED when
+// the input could not be read, its header was malformed or .parse found a PARSE_BAD record,
+// PIPELINE_NO_THREADS when the threads could
+// not be started, fd is not read from then and can still be parsed without the pipeline.
+static inline Pipeline_Result pipeline_run(const Pipeline_Stream* stream, int fd, uint64_t answers[2]) {
+    Pipeline pipeline = {
+        .stream = stream,
+        .delimiter = stream->delimiter ? stream->delimiter : '\n',
+        .fd = fd,
+    };
+
+    // Every parser and solver can hold a chunk, the reader fills one more while they work
+    size_t per_stage = pipeline__thread_count();
+    pipeline.chunk_count = 2 * per_stage + 2;
+    pipeline.chunks = calloc(pipeline.chunk_count, sizeof(Pipeline__Chunk));
+    Pipeline__Thread* threads = aligned_alloc(64, 2 * per_stage * sizeof(Pipeline__Thread));
+    NOB_ASSERT(pipeline.chunks != NULL && threads != NULL && "Buy more RAM lol");
+    pipeline__queue_init(&pipeline.free_chunks, pipeline.chunk_count);
+    pipeline__queue_init(&pipeline.chunk_queue, pipeline.chunk_count);
+    pipeline__queue_init(&pipeline.batch_queue, 4 * per_stage);
+    for (size_t i = 0; i < pipeline.chunk_count; ++i) pipeline__push(&pipeline.free_chunks, &pipeline.chunks[i]);
+
+    // The parsers and solvers wait on their queues until the reader feeds them, so they are all started
+    // before the first read and a thread that does not start leaves fd untouched
+    Pipeline_Result result = PIPELINE_OK;
+    size_t started = 0;
+    for (; started < 2 * per_stage; ++started) {
+        threads[started] = (Pipeline__Thread){.pipeline = &pipeline};
+        void* (*body)(void*) = started < per_stage ? pipeline__parser : pipeline__solver;
+        int error = pthread_create(&threads[started].thread, NULL, body, &threads[started]);
+        if (error != 0) {
+            nob_log(NOB_WARNING, "Could not start the pipeline threads: %s", strerror(error));
+            result = PIPELINE_NO_THREADS;
+            break;
+        }
+    }
+
+    // The header is read before the reader starts, its shared state is published to the parsers and
+    // solvers by the queue locks along with the first chunk
+    void* shared = NULL;
+    if (result == PIPELINE_OK && stream->header) {
+        shared = pipeline__header(&pipeline);
+        if (shared == NULL) result = PIPELINE_FAILED;
+        pipeline.shared = shared;
+    }
+
+    // The calling thread reads, it would only wait for the reader otherwise
+    if (result == PIPELINE_OK) pipeline__reader(&pipeline);
+    pipeline__join(&pipeline, threads, per_stage, started, answers);
+    // Only read once the parsers are joined, they report malformed records too
+    if (result == PIPELINE_OK && pipeline.failed) result = PIPELINE_FAILED;
+
+    for (size_t i = 0; i < pipeline.chunk_count; ++i) free(pipeline.chunks[i].data);
+    free(pipeline.chunks);
+    free(threads);
+    pipeline__queue_destroy(&pipeline.free_chunks);
+    pipeline__queue_destroy(&pipeline.chunk_queue);
+    pipeline__queue_destroy(&pipeline.batch_queue);
+    nob_sb_free(pipeline.carry);
+    if (shared && stream->free_header) stream->free_header(shared);
+    return result;
+}
+
+#endif  // AOC_PIPELINE_H
@@ -0,0 +1,329 @@
+#ifndef AOC_POOL_H
+#define AOC_POOL_H
+
+// Work-stealing thread pool for the data parallel loops of the solvers.
+//
+//     static void edge_rows(size_t begin, size_t end, Pool_Worker* worker, void* ctx) {
+//         for (size_t i = begin; i < end; ++i) ...;  // worker->scratch for temporaries
+//     }
+//     parallel_for(0, points->count, 16, edge_rows, points);
+//
+//     uint64_t total = 0;  // the identity of the combiner
+//     parallel_reduce(0, machines->count, 4, &total, sizeof(total), sum_machines, pool_sum_u64, machines);
+//
+// The body gets half open index ranges of at most grain indices. Every worker starts with an even
+// share of the range and takes grain sized pieces from the front of it. A worker that runs dry
+// steals the back half of the largest share it finds, so uneven work still spreads out. The calling
+// thread is worker 0 and works along.
+//
+// parallel_reduce() gives every worker its own copy of the identity in *result, the body folds its
+// ranges into that partial, and the partials are combined into *result in worker order once all are
+// done. The combiner must be associative and commutative, which worker took which range changes
+// from run to run.
+//
+// Every worker has a scratch Arena (arena.h) that is reset before each parallel call, per worker
+// results go into arrays indexed by worker->index below pool_worker_count(), nob.h dynamic arrays
+// included. A parallel call from inside a body runs serially on the worker that made it.
+//
+// The pool starts with the first parallel call, with $AOC_THREADS workers or one per online CPU.
+// Parallel calls from different threads outside the pool take turns. Bodies must not call
+// perf_begin()/perf_end(), the phase stack belongs to the main thread, trace scopes are fine.
+//
+// Like stb_ds, the aoc runner links every day together and src/aoc.c carries the one pool, days
+// built on their own carry their own. Include nob.h and arena.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before pool.h"
+#endif
+#ifndef AOC_ARENA_H
+#error "include arena.h before pool.h"
+#endif
+
+#ifndef AOC_RUNNER
+#define AOC_POOL_IMPLEMENTATION
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "trace.h"
+
+#define POOL_MAX_WORKERS 256
+
+typedef struct {
+    size_t index;   // 0 is the thread that made the parallel call
+    Arena scratch;  // reset before every parallel call
+} Pool_Worker;
+
+typedef void (*Pool_For_Fn)(size_t begin, size_t end, Pool_Worker* worker, void* ctx);
+typedef void (*Pool_Reduce_Fn)(size_t begin, size_t end, Pool_Worker* worker, void* ctx, void* partial);
+typedef void (*Pool_Combine_Fn)(void* into, const void* from, void* ctx);
+
+size_t pool_worker_count(void);
+void parallel_for(size_t begin, size_t end, size_t grain, Pool_For_Fn body, void* ctx);
+void parallel_reduce(size_t begin, size_t end, size_t grain, void* result, size_t size, Pool_Reduce_Fn body,
+                     Pool_Combine_Fn combine, void* ctx);
+
+// Combiners for the common uint64_t reductions
+static inline void pool_sum_u64(void* into, const void* from, void* ctx) {
+    (void)ctx;
+    *(uint64_t*)into += *(const uint64_t*)from;
+}
+
+static inline void pool_max_u64(void* into, const void* from, void* ctx) {
+    (void)ctx;
+    if (*(const uint64_t*)from > *(uint64_t*)into) *(uint64_t*)into = *(const uint64_t*)from;
+}
+
+#ifdef AOC_POOL_IMPLEMENTATION
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+// A share of the current job, padded so the locks of neighbours do not share a cache line. Thieves
+// peek at next and end without the lock, so they are stored atomically.
+typedef struct {
+    pthread_mutex_t lock;
+    size_t next;
+    size_t end;
+} __attribute__((aligned(64))) Pool__Range;
+
+typedef struct {
+    Pool_For_Fn body;
+    void* ctx;
+    size_t grain;
+} Pool__Job;
+
+typedef struct {
+    size_t count;
+    Pool_Worker* workers;
+    Pool__Range* ranges;
+
+    pthread_mutex_t submit;  // one parallel call at a time
+    pthread_mutex_t lock;    // guards the fields below
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    uint64_t generation;     // bumped for every job
+    size_t finished;         // threads done with the current job
+    Pool__Job job;
+} Pool;
+
+static Pool pool__pool = {0};
+static pthread_once_t pool__once = PTHREAD_ONCE_INIT;
+static _Thread_local Pool_Worker* pool__current = NULL;
+
+static bool pool__take(Pool__Range* range, size_t grain, size_t* begin, size_t* end) {
+    pthread_mutex_lock(&range->lock);
+    bool found = range->next < range->end;
+    if (found) {
+        *begin = range->next;
+        *end = range->end - range->next > grain ? range->next + grain : range->end;
+        __atomic_store_n(&range->next, *end, __ATOMIC_RELAXED);
+    }
+    pthread_mutex_unlock(&range->lock);
+    return found;
+}
+
+// Moves the back half of the fullest other share into the own one, false when all are empty
+static bool pool__steal(Pool* pool, size_t self, size_t grain) {
+    size_t victim = 0, most = 0;
+    for (size_t k = 1; k < pool->count; ++k) {
+        size_t other = (self + k) % pool->count;
+        size_t left = __atomic_load_n(&pool->ranges[other].end, __ATOMIC_RELAXED) -
+                      __atomic_load_n(&pool->ranges[other].next, __ATOMIC_RELAXED);
+        if (left > most && left <= SIZE_MAX / 2) {
+            victim = other;
+            most = left;
+        }
+    }
+    if (most == 0) return false;
+
+    // The peek above was unlocked, the victim may have run dry since, then just look again
+    Pool__Range* range = &pool->ranges[victim];
+    pthread_mutex_lock(&range->lock);
+    size_t left = range->end > range->next ? range->end - range->next : 0;
+    size_t taken = left > grain ? left / 2 : left;
+    size_t from = range->end - taken;
+    __atomic_store_n(&range->end, from, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&range->lock);
+
+    Pool__Range* own = &pool->ranges[self];
+    pthread_mutex_lock(&own->lock);
+    __atomic_store_n(&own->next, from, __ATOMIC_RELAXED);
+    __atomic_store_n(&own->end, from + taken, __ATOMIC_RELAXED);
+    pthread_mutex_unlock(&own->lock);
+    return true;
+}
+
+static void pool__work(Pool* pool, size_t self) {
+    Pool_Worker* worker = &pool->workers[self];
+    Pool__Job job = pool->job;
+    pool__current = worker;
+
+    TRACE_BEGIN("pool worker");
+    size_t begin, end;
+    for (;;) {
+        if (pool__take(&pool->ranges[self], job.grain, &begin, &end)) {
+            job.body(begin, end, worker, job.ctx);
+        } else if (!pool__steal(pool, self, job.grain)) {
+            break;
+        }
+    }
+    TRACE_END();
+    pool__current = NULL;
+}
+
+static void* pool__thread(void* arg) {
+    Pool* pool = &pool__pool;
+    size_t self = (size_t)(uintptr_t)arg;
+    uint64_t seen = 0;
+
+    for (;;) {
+        pthread_mutex_lock(&pool->lock);
+        while (pool->generation == seen) pthread_cond_wait(&pool->wake, &pool->lock);
+        seen = pool->generation;
+        pthread_mutex_unlock(&pool->lock);
+
+        pool__work(pool, self);
+
+        pthread_mutex_lock(&pool->lock);
+        if (++pool->finished == pool->count - 1) pthread_cond_signal(&pool->done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return NULL;
+}
+
+static void pool__start(void) {
+    Pool* pool = &pool__pool;
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    const char* threads = getenv("AOC_THREADS");
+    if (threads && atol(threads) > 0) count = atol(threads);
+    if (count < 1) count = 1;
+    if (count > POOL_MAX_WORKERS) count = POOL_MAX_WORKERS;
+
+    pool->count = (size_t)count;
+    pool->workers = calloc(pool->count, sizeof(Pool_Worker));
+    pool->ranges = aligned_alloc(64, pool->count * sizeof(Pool__Range));
+    NOB_ASSERT(pool->workers != NULL && pool->ranges != NULL && "Buy more RAM lol");
+    pthread_mutex_init(&pool->submit, NULL);
+    pthread_mutex_init(&pool->lock, NULL);
+    pthread_cond_init(&pool->wake, NULL);
+    pthread_cond_init(&pool->done, NULL);
+
+    for (size_t i = 0; i < pool->count; ++i) {
+        pool->workers[i].index = i;
+        pthread_mutex_init(&pool->ranges[i].lock, NULL);
+        pool->ranges[i].next = pool->ranges[i].end = 0;
+        if (i == 0) continue;
+
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, pool__thread, (void*)(uintptr_t)i) != 0) {
+            nob_log(NOB_WARNING, "Could only start %zu of %ld pool threads", i, count);
+            pool->count = i;
+            break;
+        }
+        pthread_detach(thread);
+    }
+}
+
+size_t pool_worker_count(void) {
+    pthread_once(&pool__once, pool__start);
+    return pool__pool.count;
+}
+
+void parallel_for(size_t begin, size_t end, size_t grain, Pool_For_Fn body, void* ctx) {
+    if (begin >= end) return;
+    if (grain == 0) grain = 1;
+
+    // Nested calls stay on the worker that made them, its scratch still belongs to the outer body
+    if (pool__current) {
+        body(begin, end, pool__current, ctx);
+        return;
+    }
+
+    Pool* pool = &pool__pool;
+    pthread_once(&pool__once, pool__start);
+    pthread_mutex_lock(&pool->submit);
+    for (size_t i = 0; i < pool->count; ++i) arena_reset(&pool->workers[i].scratch);
+
+    if (pool->count == 1 || end - begin <= grain) {
+        pool__current = &pool->workers[0];
+        body(begin, end, pool__current, ctx);
+        pool__current = NULL;
+        pthread_mutex_unlock(&pool->submit);
+        return;
+    }
+
+    // Even shares on grain boundaries, the last workers get nothing when there are too few pieces
+    size_t pieces = (end - begin + grain - 1) / grain;
+    for (size_t i = 0; i < pool->count; ++i) {
+        size_t from = begin + pieces * i / pool->count * grain;
+        size_t to = begin + pieces * (i + 1) / pool->count * grain;
+        pool->ranges[i].next = from < end ? from : end;
+        pool->ranges[i].end = to < end ? to : end;
+    }
+
+    pthread_mutex_lock(&pool->lock);
+    pool->job = (Pool__Job){.body = body, .ctx = ctx, .grain = grain};
+    pool->finished = 0;
+    pool->generation++;
+    pthread_cond_broadcast(&pool->wake);
+    pthread_mutex_unlock(&pool->lock);
+
+    pool__work(pool, 0);
+
+    pthread_mutex_lock(&pool->lock);
+    while (pool->finished < pool->count - 1) pthread_cond_wait(&pool->done, &pool->lock);
+    pthread_mutex_unlock(&pool->lock);
+    pthread_mutex_unlock(&pool->submit);
+}
+
+typedef struct {
+    Pool_Reduce_Fn body;
+    void* ctx;
+    char* partials;
+    bool* used;
+    size_t stride;
+} Pool__Reduce;
+
+static void pool__reduce_range(size_t begin, size_t end, Pool_Worker* worker, void* ctx) {
+    Pool__Reduce* reduce = ctx;
+    reduce->used[worker->index] = true;
+    reduce->body(begin, end, worker, reduce->ctx, reduce->partials + worker->index * reduce->stride);
+}
+
+void parallel_reduce(size_t begin, size_t end, size_t grain, void* result, size_t size, Pool_Reduce_Fn body,
+                     Pool_Combine_Fn combine, void* ctx) {
+    // Nested calls fold straight into the result, there is only the one worker
+    if (pool__current) {
+        body(begin, end, pool__current, ctx, result);
+        return;
+    }
+
+    size_t count = pool_worker_count();
+    size_t stride = (size + 63) / 64 * 64;  // one cache line or more per partial
+    Pool__Reduce reduce = {
+        .body = body,
+        .ctx = ctx,
+        .partials = aligned_alloc(64, count * stride),
+        .used = calloc(count, sizeof(bool)),
+        .stride = stride,
+    };
+    NOB_ASSERT(reduce.partials != NULL && reduce.used != NULL && "Buy more RAM lol");
+    for (size_t i = 0; i < count; ++i) memcpy(reduce.partials + i * stride, result, size);
+
+    parallel_for(begin, end, grain, pool__reduce_range, &reduce);
+
+    for (size_t i = 0; i < count; ++i) {
+        if (reduce.used[i]) combine(result, reduce.partials + i * stride, ctx);
+    }
+    free(reduce.partials);
+    free(reduce.used);
+}
+
+#endif  // AOC_POOL_IMPLEMENTATION
+
+#endif  // AOC_POOL_H
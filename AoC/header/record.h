@@ -0,0 +1,34 @@
+#ifndef AOC_RECORD_H
+#define AOC_RECORD_H
+
+// The per-line record parser of parallel_parse.h and pipeline.h, one callback feeds both.
+//
+//     static Parse_Result parse_point(Nob_String_View line, const void* ctx, Arena* arena, void* record) {
+//         if (line.count == 0) return PARSE_SKIP;  // no record in this line
+//         parse_i64_fields(line, ',', ((Point*)record)->coordinates, 3);
+//         return PARSE_RECORD;
+//     }
+//
+// It runs on several threads at once: ctx is shared and only read, record and arena belong to the
+// chunk or batch the record goes into. What a record allocates from the arena lives as long as the
+// record does. parallel_parse_lines() passes a NULL arena when its caller has none to give.
+//
+// Include nob.h and arena.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before record.h"
+#endif
+#ifndef AOC_ARENA_H
+#error "include arena.h before record.h"
+#endif
+
+typedef enum {
+    PARSE_SKIP,    // no record in the line, blank lines and the like
+    PARSE_RECORD,
+    PARSE_BAD,     // malformed, fails the whole parse
+} Parse_Result;
+
+// Writes the record of line to record
+typedef Parse_Result (*Parse_Line_Fn)(Nob_String_View line, const void* ctx, Arena* arena, void* record);
+
+#endif  // AOC_RECORD_H
@@ -0,0 +1,600 @@
+#ifndef AOC_SCALE_H
+#define AOC_SCALE_H
+
+// Complexity scaling of the days on generated inputs (gen.h), `aoc scale` in the runner.
+//
+//     aoc scale [--day N] [--param size|width|height|degree|buttons] [--from N] [--to N]
+//               [--factor N | --step N] [--seed N] [--timeout S] [--memory MB] [--format text|csv|json]
+//               [--report PATH]
+//
+// Every day walks a ladder of values for one generator parameter (the size by default, day 10 walks
+// its buttons) and times parse, part 1 and part 2 at every rung. Each rung runs in a forked child
+// with a time and address space limit, so the phases that blow up are recorded as a timeout or a
+// crash instead of taking the whole run down, and are skipped on the higher rungs.
+//
+// From the timings a least squares fit of log(time) against log(n) gives the empirical exponent k of
+// time ~ n^k. A fit of log(time) against n is tried as well, when it explains the points clearly
+// better the phase is reported as exponential. Quadratic and worse phases are flagged.
+//
+// Include nob.h, input.h and aoc.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before scale.h"
+#endif
+#ifndef AOC_AOC_H
+#error "include aoc.h before scale.h"
+#endif
+
+#include <errno.h>
+#include <math.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "gen.h"
+
+#define SCALE_PHASES 3
+#define SCALE_MAX_RUNGS 64
+#define SCALE_MIN_RUNS 3
+#define SCALE_MIN_TIME_NS 20000000ull  // keep repeating a phase until it ran this long in total
+#define SCALE_SLOW_NS 1000000000ull     // but one run is enough once it takes this long
+#define SCALE_MAX_RUNS 10000
+
+static const char* const scale_phases[SCALE_PHASES] = {"parse", "part1", "part2"};
+
+typedef enum {
+    SCALE_PARAM_SIZE,
+    SCALE_PARAM_WIDTH,
+    SCALE_PARAM_HEIGHT,
+    SCALE_PARAM_DEGREE,
+    SCALE_PARAM_BUTTONS,
+    SCALE_PARAM_COUNT,
+} Scale_Param;
+
+static const char* const scale_params[SCALE_PARAM_COUNT] = {"size", "width", "height", "degree", "buttons"};
+
+// The ladder a day walks when the command line does not pick one
+typedef struct {
+    int day;
+    Scale_Param param;
+    size_t from;
+    size_t to;
+    size_t factor;  // geometric ladder when > 1
+    size_t step;    // arithmetic ladder otherwise
+} Scale_Ladder;
+
+static const Scale_Ladder scale_default_ladders[] = {
+    // 2^n in the buttons, every machine checks every subset
+    {10, SCALE_PARAM_BUTTONS, 4, 28, 0, 2},
+};
+
+static const Scale_Ladder scale_default_ladder = {0, SCALE_PARAM_SIZE, 1000, 1024000, 4, 0};
+
+typedef enum {
+    SCALE_OK,
+    SCALE_SKIPPED,  // fell over on a lower rung
+    SCALE_MISSING,  // the day has no such part
+    SCALE_TIMEOUT,
+    SCALE_CRASHED,  // killed by a signal, usually the stack or the memory limit
+    SCALE_FAILED,   // the generator or the parser refused the input
+} Scale_Status;
+
+typedef struct {
+    size_t n;
+    Scale_Status status[SCALE_PHASES];
+    uint64_t median_ns[SCALE_PHASES];
+    int signal;
+} Scale_Rung;
+
+typedef struct {
+    int day;
+    Scale_Param param;
+    Scale_Rung rungs[SCALE_MAX_RUNGS];
+    size_t count;
+} Scale_Result;
+
+typedef struct {
+    int day;  // 0 scales every day
+    bool has_param;
+    Scale_Param param;
+    size_t from, to, factor, step;  // 0 keeps the default of the day
+    uint64_t seed;
+    unsigned timeout_s;
+    size_t memory_mb;
+    Bench_Format format;
+    const char* report;
+} Scale_Options;
+
+// What the child sends back per phase
+typedef struct {
+    int phase;
+    Scale_Status status;
+    uint64_t median_ns;
+} Scale_Message;
+
+static inline void scale__usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s scale [--day N] [--param size|width|height|degree|buttons] [--from N] [--to N] "
+            "[--factor N | --step N] [--seed N] [--timeout S] [--memory MB] [--format text|csv|json] "
+            "[--report PATH]\n",
+            program);
+}
+
+static inline bool scale_parse_options(int argc, char** argv, Scale_Options* options) {
+    const char* program = nob_shift(argv, argc);
+    nob_shift(argv, argc);  // "scale"
+    *options = (Scale_Options){.seed = 1, .timeout_s = 10, .memory_mb = 4096, .format = BENCH_TEXT};
+
+    while (argc > 0) {
+        const char* flag = nob_shift(argv, argc);
+        const char* value = argc > 0 ? argv[0] : NULL;
+        long parsed = 0;
+
+        if (strcmp(flag, "--day") == 0) {
+            if (!aoc__parse_count(flag, value, 1, 25, &parsed)) return false;
+            options->day = (int)parsed;
+        } else if (strcmp(flag, "--param") == 0) {
+            options->has_param = false;
+            for (int i = 0; i < SCALE_PARAM_COUNT && value; ++i) {
+                if (strcmp(value, scale_params[i]) == 0) {
+                    options->param = (Scale_Param)i;
+                    options->has_param = true;
+                }
+            }
+            if (!options->has_param) {
+                nob_log(NOB_ERROR, "--param expects size, width, height, degree or buttons");
+                return false;
+            }
+        } else if (strcmp(flag, "--from") == 0) {
+            if (!aoc__parse_count(flag, value, 1, 1000000000, &parsed)) return false;
+            options->from = (size_t)parsed;
+        } else if (strcmp(flag, "--to") == 0) {
+            if (!aoc__parse_count(flag, value, 1, 1000000000, &parsed)) return false;
+            options->to = (size_t)parsed;
+        } else if (strcmp(flag, "--factor") == 0) {
+            if (!aoc__parse_count(flag, value, 2, 1000, &parsed)) return false;
+            options->factor = (size_t)parsed;
+            options->step = 0;
+        } else if (strcmp(flag, "--step") == 0) {
+            if (!aoc__parse_count(flag, value, 1, 1000000000, &parsed)) return false;
+            options->step = (size_t)parsed;
+            options->factor = 0;
+        } else if (strcmp(flag, "--seed") == 0) {
+            if (!aoc__parse_count(flag, value, 0, 2147483647, &parsed)) return false;
+            options->seed = (uint64_t)parsed;
+        } else if (strcmp(flag, "--timeout") == 0) {
+            if (!aoc__parse_count(flag, value, 1, 86400, &parsed)) return false;
+            options->timeout_s = (unsigned)parsed;
+        } else if (strcmp(flag, "--memory") == 0) {
+            if (!aoc__parse_count(flag, value, 64, 1048576, &parsed)) return false;
+            options->memory_mb = (size_t)parsed;
+        } else if (strcmp(flag, "--format") == 0) {
+            if (value == NULL || !bench_parse_format(value, &options->format)) {
+                nob_log(NOB_ERROR, "--format expects text, csv or json");
+                return false;
+            }
+        } else if (strcmp(flag, "--report") == 0) {
+            if (value == NULL) {
+                nob_log(NOB_ERROR, "--report expects a path");
+                return false;
+            }
+            options->report = value;
+        } else {
+            if (strcmp(flag, "--help") != 0 && strcmp(flag, "-h") != 0) {
+                nob_log(NOB_ERROR, "Unknown flag %s", flag);
+            }
+            scale__usage(program);
+            return false;
+        }
+        nob_shift(argv, argc);
+    }
+    return true;
+}
+
+// The day's default ladder with everything the command line set on top. The range only applies to
+// every day when they all walk the same parameter, that is with --day or --param.
+static inline Scale_Ladder scale__ladder(int day, const Scale_Options* options) {
+    Scale_Ladder ladder = scale_default_ladder;
+    for (size_t i = 0; i < NOB_ARRAY_LEN(scale_default_ladders); ++i) {
+        if (scale_default_ladders[i].day == day) ladder = scale_default_ladders[i];
+    }
+    if (ladder.param != scale_default_ladder.param && options->day == 0 && !options->has_param) return ladder;
+
+    // A different parameter needs its own range, the default one belongs to the default parameter
+    if (options->has_param && options->param != ladder.param) {
+        ladder = scale_default_ladder;
+        ladder.param = options->param;
+    }
+    if (options->from) ladder.from = options->from;
+    if (options->to) ladder.to = options->to;
+    if (options->factor || options->step) {
+        ladder.factor = options->factor;
+        ladder.step = options->step;
+    }
+    return ladder;
+}
+
+static inline void scale__set_param(Gen_Params* params, Scale_Param param, size_t value) {
+    switch (param) {
+        case SCALE_PARAM_SIZE: params->size = value; break;
+        case SCALE_PARAM_WIDTH: params->width = value; break;
+        case SCALE_PARAM_HEIGHT: params->height = value; break;
+        case SCALE_PARAM_DEGREE: params->degree = value; break;
+        case SCALE_PARAM_BUTTONS: params->buttons = value; break;
+        case SCALE_PARAM_COUNT: break;
+    }
+}
+
+// Times one phase until it ran SCALE_MIN_RUNS times and SCALE_MIN_TIME_NS in total (or once past
+// SCALE_SLOW_NS), returns the median.
+static inline uint64_t scale__time_phase(const Aoc_Day* day, int phase, const Lines* lines, const void* state,
+                                         Bench_Samples* samples) {
+    samples->count = 0;
+    uint64_t total = 0;
+    while (samples->count < SCALE_MAX_RUNS && total < SCALE_SLOW_NS &&
+           (samples->count < SCALE_MIN_RUNS || total < SCALE_MIN_TIME_NS)) {
+        uint64_t start = bench_now_ns();
+        if (phase == 0) {
+            void* parsed = day->parse(lines);
+            uint64_t elapsed = bench_now_ns() - start;
+            if (day->free) (day->free)(parsed);
+            nob_da_append(samples, elapsed);
+            total += elapsed;
+            continue;
+        }
+        (phase == 1 ? day->part_1 : day->part_2)(state);
+        uint64_t elapsed = bench_now_ns() - start;
+        nob_da_append(samples, elapsed);
+        total += elapsed;
+    }
+    return bench_stats(samples).median;
+}
+
+static inline void scale__send(int fd, int phase, Scale_Status status, uint64_t median_ns) {
+    Scale_Message message = {.phase = phase, .status = status, .median_ns = median_ns};
+    ssize_t written = write(fd, &message, sizeof(message));
+    (void)written;
+}
+
+// Runs in the child: generates the input, times the phases that are still wanted and reports each
+// one through fd as soon as it is done, so a later phase hanging does not lose the earlier ones.
+static inline void scale__child(const Aoc_Day* day, const Gen_Params* params, const bool* wanted, int fd) {
+    Nob_String_Builder sb = {0};
+    if (!gen_input(params, &sb)) {
+        for (int phase = 0; phase < SCALE_PHASES; ++phase) {
+            if (wanted[phase]) scale__send(fd, phase, SCALE_FAILED, 0);
+        }
+        return;
+    }
+
+    Input input = {0};
+    input_from_memory(sb.items, sb.count, &input);
+    void* state = day->parse(&input.lines);
+    if (state == NULL) {
+        for (int phase = 0; phase < SCALE_PHASES; ++phase) {
+            if (wanted[phase]) scale__send(fd, phase, SCALE_FAILED, 0);
+        }
+        return;
+    }
+
+    Bench_Samples samples = {0};
+    for (int phase = 0; phase < SCALE_PHASES; ++phase) {
+        if (!wanted[phase]) continue;
+        scale__send(fd, phase, SCALE_OK, scale__time_phase(day, phase, &input.lines, state, &samples));
+    }
+    // No cleanup, the process exits right after this
+}
+
+// Measures one rung in a forked child. Phases the child never reported ran out of time or crashed.
+static inline void scale__run_rung(const Aoc_Day* day, const Gen_Params* params, const bool* wanted,
+                                   const Scale_Options* options, Scale_Rung* rung) {
+    int fds[2];
+    if (pipe(fds) < 0) {
+        nob_log(NOB_ERROR, "Could not create a pipe: %s", strerror(errno));
+        for (int phase = 0; phase < SCALE_PHASES; ++phase) rung->status[phase] = SCALE_FAILED;
+        return;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+    pid_t pid = fork();
+    if (pid == 0) {
+        close(fds[0]);
+        struct rlimit limit = {.rlim_cur = (rlim_t)options->memory_mb << 20, .rlim_max = (rlim_t)options->memory_mb << 20};
+        setrlimit(RLIMIT_AS, &limit);
+        scale__child(day, params, wanted, fds[1]);
+        _exit(0);
+    }
+    close(fds[1]);
+    if (pid < 0) {
+        nob_log(NOB_ERROR, "Could not fork: %s", strerror(errno));
+        close(fds[0]);
+        for (int phase = 0; phase < SCALE_PHASES; ++phase) rung->status[phase] = SCALE_FAILED;
+        return;
+    }
+
+    for (int phase = 0; phase < SCALE_PHASES; ++phase) {
+        if (wanted[phase]) rung->status[phase] = SCALE_TIMEOUT;
+    }
+
+    uint64_t deadline = bench_now_ns() + (uint64_t)options->timeout_s * 1000000000ull;
+    bool timed_out = false;
+    for (;;) {
+        uint64_t now = bench_now_ns();
+        if (now >= deadline) {
+            timed_out = true;
+            break;
+        }
+        struct pollfd pfd = {.fd = fds[0], .events = POLLIN};
+        int ready = poll(&pfd, 1, (int)((deadline - now) / 1000000 + 1));
+        if (ready < 0 && errno == EINTR) continue;
+        if (ready <= 0) continue;
+
+        Scale_Message message;
+        ssize_t got = read(fds[0], &message, sizeof(message));
+        if (got != (ssize_t)sizeof(message)) break;  // the child is gone
+        rung->status[message.phase] = message.status;
+        rung->median_ns[message.phase] = message.median_ns;
+    }
+    close(fds[0]);
+
+    if (timed_out) kill(pid, SIGKILL);
+    int wstatus = 0;
+    waitpid(pid, &wstatus, 0);
+
+    if (!timed_out && WIFSIGNALED(wstatus)) {
+        rung->signal = WTERMSIG(wstatus);
+        for (int phase = 0; phase < SCALE_PHASES; ++phase) {
+            if (rung->status[phase] == SCALE_TIMEOUT) rung->status[phase] = SCALE_CRASHED;
+        }
+    }
+}
+
+static inline void scale_day(const Aoc_Day* day, const Scale_Options* options, Scale_Result* result) {
+    Scale_Ladder ladder = scale__ladder(day->number, options);
+    *result = (Scale_Result){.day = day->number, .param = ladder.param};
+
+    bool wanted[SCALE_PHASES] = {true, day->part_1 != NULL, day->part_2 != NULL};
+    size_t n = ladder.from;
+    while (n <= ladder.to && result->count < SCALE_MAX_RUNGS) {
+        bool any = false;
+        for (int phase = 0; phase < SCALE_PHASES; ++phase) any = any || wanted[phase];
+        if (!any) break;
+
+        Scale_Rung* rung = &result->rungs[result->count++];
+        *rung = (Scale_Rung){.n = n};
+        for (int phase = 0; phase < SCALE_PHASES; ++phase) {
+            rung->status[phase] = wanted[phase] ? SCALE_OK : SCALE_SKIPPED;
+        }
+        if (day->part_1 == NULL) rung->status[1] = SCALE_MISSING;
+        if (day->part_2 == NULL) rung->status[2] = SCALE_MISSING;
+
+        Gen_Params params = {.day = day->number, .seed = options->seed};
+        scale__set_param(&params, ladder.param, n);
+        scale__run_rung(day, &params, wanted, options, rung);
+
+        nob_log(NOB_INFO, "day %d %s=%zu: parse %.3f ms, part1 %.3f ms, part2 %.3f ms", day->number,
+                scale_params[ladder.param], n, rung->median_ns[0] / 1e6, rung->median_ns[1] / 1e6,
+                rung->median_ns[2] / 1e6);
+
+        // A phase that fell over stays down, and without a state the parts cannot run either
+        for (int phase = 0; phase < SCALE_PHASES; ++phase) {
+            if (wanted[phase] && rung->status[phase] != SCALE_OK) wanted[phase] = false;
+        }
+        if (rung->status[0] == SCALE_FAILED) break;
+
+        n = ladder.factor > 1 ? n * ladder.factor : n + (ladder.step ? ladder.step : 1);
+    }
+}
+
+typedef struct {
+    size_t points;
+    double exponent;       // k of time ~ n^k
+    bool exponential;
+    double doubling;       // n added per doubling of time, when exponential
+    size_t fell_over;      // first n that timed out or crashed, 0 if none did
+    Scale_Status failure;
+} Scale_Fit;
+
+// Least squares slope and residual sum of squares of y against x
+static inline double scale__regress(const double* x, const double* y, size_t count, double* rss) {
+    double mx = 0, my = 0;
+    for (size_t i = 0; i < count; ++i) {
+        mx += x[i];
+        my += y[i];
+    }
+    mx /= (double)count;
+    my /= (double)count;
+
+    double sxy = 0, sxx = 0;
+    for (size_t i = 0; i < count; ++i) {
+        sxy += (x[i] - mx) * (y[i] - my);
+        sxx += (x[i] - mx) * (x[i] - mx);
+    }
+    double slope = sxx > 0 ? sxy / sxx : 0;
+
+    *rss = 0;
+    for (size_t i = 0; i < count; ++i) {
+        double e = y[i] - (my + slope * (x[i] - mx));
+        *rss += e * e;
+    }
+    return slope;
+}
+
+static inline Scale_Fit scale_fit(const Scale_Result* result, int phase) {
+    Scale_Fit fit = {0};
+    double log_n[SCALE_MAX_RUNGS], n[SCALE_MAX_RUNGS], log_t[SCALE_MAX_RUNGS];
+
+    for (size_t i = 0; i < result->count; ++i) {
+        const Scale_Rung* rung = &result->rungs[i];
+        if (rung->status[phase] == SCALE_OK && rung->median_ns[phase] > 0) {
+            log_n[fit.points] = log((double)rung->n);
+            n[fit.points] = (double)rung->n;
+            log_t[fit.points] = log((double)rung->median_ns[phase]);
+            fit.points++;
+        } else if (fit.fell_over == 0 &&
+                   (rung->status[phase] == SCALE_TIMEOUT || rung->status[phase] == SCALE_CRASHED)) {
+            fit.fell_over = rung->n;
+            fit.failure = rung->status[phase];
+        }
+    }
+    if (fit.points < 2) return fit;
+
+    double power_rss, exp_rss;
+    fit.exponent = scale__regress(log_n, log_t, fit.points, &power_rss);
+    double rate = scale__regress(n, log_t, fit.points, &exp_rss);
+
+    // Only call it exponential when the straight line in n fits a lot better and the time grows fast
+    if (fit.points >= 4 && rate > 0 && exp_rss < 0.5 * power_rss && fit.exponent > 2.5) {
+        fit.exponential = true;
+        fit.doubling = log(2.0) / rate;
+    }
+    return fit;
+}
+
+static inline const char* scale_verdict(const Scale_Fit* fit) {
+    if (fit->points < 2) return "-";
+    if (fit->exponential) return "EXPONENTIAL";
+    if (fit->exponent >= 2.5) return "CUBIC+";
+    if (fit->exponent >= 1.6) return "QUADRATIC";
+    if (fit->exponent >= 1.2) return "superlinear";
+    if (fit->exponent >= 0.5) return "linear";
+    return "flat";
+}
+
+static inline const char* scale__status_name(Scale_Status status) {
+    switch (status) {
+        case SCALE_OK: return "ok";
+        case SCALE_SKIPPED: return "skipped";
+        case SCALE_MISSING: return "missing";
+        case SCALE_TIMEOUT: return "timeout";
+        case SCALE_CRASHED: return "crashed";
+        case SCALE_FAILED: return "failed";
+    }
+    return "?";
+}
+
+static inline void scale_print_report(FILE* out, const Scale_Result* results, size_t count, Bench_Format format) {
+    switch (format) {
+        case BENCH_TEXT:
+            fprintf(out, "%-4s %-6s %-8s %6s %7s %-12s %s\n", "day", "phase", "param", "points", "k", "verdict",
+                    "median ms per n");
+            for (size_t r = 0; r < count; ++r) {
+                const Scale_Result* result = &results[r];
+                for (int phase = 0; phase < SCALE_PHASES; ++phase) {
+                    if (result->count == 0 || result->rungs[0].status[phase] == SCALE_MISSING) continue;
+                    Scale_Fit fit = scale_fit(result, phase);
+
+                    fprintf(out, "%-4d %-6s %-8s %6zu %7.2f %-12s", result->day, scale_phases[phase],
+                            scale_params[result->param], fit.points, fit.exponent, scale_verdict(&fit));
+                    for (size_t i = 0; i < result->count; ++i) {
+                        const Scale_Rung* rung = &result->rungs[i];
+                        if (rung->status[phase] == SCALE_OK) {
+                            fprintf(out, " %zu:%.3f", rung->n, rung->median_ns[phase] / 1e6);
+                        } else if (rung->status[phase] == SCALE_CRASHED && rung->signal) {
+                            fprintf(out, " %zu:crashed(%s)", rung->n, strsignal(rung->signal));
+                        } else if (rung->status[phase] != SCALE_SKIPPED) {
+                            fprintf(out, " %zu:%s", rung->n, scale__status_name(rung->status[phase]));
+                        }
+                    }
+                    if (fit.exponential) fprintf(out, " (time doubles every +%.1f)", fit.doubling);
+                    if (fit.fell_over) {
+                        fprintf(out, " (fell over at %zu: %s)", fit.fell_over, scale__status_name(fit.failure));
+                    }
+                    fprintf(out, "\n");
+                }
+            }
+            break;
+
+        case BENCH_CSV:
+            fprintf(out, "day,phase,param,n,status,median_ns,exponent,verdict\n");
+            for (size_t r = 0; r < count; ++r) {
+                const Scale_Result* result = &results[r];
+                for (int phase = 0; phase < SCALE_PHASES; ++phase) {
+                    Scale_Fit fit = scale_fit(result, phase);
+                    for (size_t i = 0; i < result->count; ++i) {
+                        const Scale_Rung* rung = &result->rungs[i];
+                        if (rung->status[phase] == SCALE_SKIPPED || rung->status[phase] == SCALE_MISSING) continue;
+                        fprintf(out, "%d,%s,%s,%zu,%s,%" PRIu64 ",%.3f,%s\n", result->day, scale_phases[phase],
+                                scale_params[result->param], rung->n, scale__status_name(rung->status[phase]),
+                                rung->median_ns[phase], fit.exponent, scale_verdict(&fit));
+                    }
+                }
+            }
+            break;
+
+        case BENCH_JSON: {
+            fprintf(out, "[\n");
+            bool first = true;
+            for (size_t r = 0; r < count; ++r) {
+                const Scale_Result* result = &results[r];
+                for (int phase = 0; phase < SCALE_PHASES; ++phase) {
+                    if (result->count == 0 || result->rungs[0].status[phase] == SCALE_MISSING) continue;
+                    Scale_Fit fit = scale_fit(result, phase);
+
+                    fprintf(out, "%s  {\"day\": %d, \"phase\": \"%s\", \"param\": \"%s\", \"exponent\": %.3f, "
+                                 "\"verdict\": \"%s\", \"fell_over\": %zu, \"rungs\": [",
+                            first ? "" : ",\n", result->day, scale_phases[phase], scale_params[result->param],
+                            fit.exponent, scale_verdict(&fit), fit.fell_over);
+                    first = false;
+
+                    bool first_rung = true;
+                    for (size_t i = 0; i < result->count; ++i) {
+                        const Scale_Rung* rung = &result->rungs[i];
+                        if (rung->status[phase] == SCALE_SKIPPED) continue;
+                        fprintf(out, "%s{\"n\": %zu, \"status\": \"%s\", \"median_ns\": %" PRIu64 "}",
+                                first_rung ? "" : ", ", rung->n, scale__status_name(rung->status[phase]),
+                                rung->median_ns[phase]);
+                        first_rung = false;
+                    }
+                    fprintf(out, "]}");
+                }
+            }
+            fprintf(out, "\n]\n");
+        } break;
+    }
+}
+
+static inline int scale_main(const Aoc_Day* const* days, size_t count, int argc, char** argv) {
+    Scale_Options options;
+    if (!scale_parse_options(argc, argv, &options)) return 1;
+
+    Scale_Result* results = calloc(count, sizeof(*results));
+    NOB_ASSERT(results != NULL && "Buy more RAM lol");
+    size_t result_count = 0;
+
+    for (size_t i = 0; i < count; ++i) {
+        if (options.day != 0 && options.day != days[i]->number) continue;
+        if (gen_find_day(days[i]->number) == NULL) continue;
+        scale_day(days[i], &options, &results[result_count++]);
+    }
+
+    if (result_count == 0) {
+        nob_log(NOB_ERROR, "There is no generator for day %d", options.day);
+        free(results);
+        return 1;
+    }
+
+    FILE* out = stdout;
+    if (options.report) {
+        out = fopen(options.report, "w");
+        if (out == NULL) {
+            nob_log(NOB_ERROR, "Could not open %s: %s", options.report, strerror(errno));
+            free(results);
+            return 1;
+        }
+    }
+    scale_print_report(out, results, result_count, options.format);
+    if (out != stdout) fclose(out);
+
+    free(results);
+    return 0;
+}
+
+#endif  // AOC_SCALE_H
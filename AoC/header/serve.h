@@ -0,0 +1,392 @@
+#ifndef AOC_SERVE_H
+#define AOC_SERVE_H
+
+// A long running solver behind a Unix domain socket, `aoc serve` and `aoc client` in the runner.
+//
+//     aoc serve [--socket PATH]
+//     aoc client [--socket PATH] --day N [--part 1|2] [--input PATH | --input -]
+//     aoc client [--socket PATH] --stop
+//
+// The server starts the thread pool up front and answers requests until it is stopped, so a request
+// costs the parse and the solve and nothing else: no process start, no page faults on the binary,
+// a warm heap and pool. Every connection gets a thread and may send any number of requests, each
+// one line, a payload for bytes:
+//
+//     solve <day> <part> path <absolute path>\n
+//     solve <day> <part> bytes <length>\n<length bytes of input>
+//     stop\n
+//
+// part 0 solves both parts. A bytes request over SERVE_MAX_PAYLOAD, or with a length that is not a
+// number, is answered with an error and the connection closed, its payload cannot be skipped. Every request is answered with one line of JSON, the answers and the
+// nanoseconds spent in each phase, or {"error": "..."}:
+//
+//     {"day": 8, "part1": 50760, "part2": 3206508875, "parse_ns": 193021, "part1_ns": ..., "total_ns": ...}
+//
+// The client sends files by path (made absolute, the server has its own working directory) and
+// standard input as bytes, and prints the answers like the runner, the timings to stderr.
+//
+// Include nob.h, input.h, aoc.h and pool.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before serve.h"
+#endif
+#ifndef AOC_AOC_H
+#error "include aoc.h before serve.h"
+#endif
+#ifndef AOC_POOL_H
+#error "include pool.h before serve.h"
+#endif
+
+#include <errno.h>
+#include <inttypes.h>
+#include <limits.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#define SERVE_DEFAULT_SOCKET "/tmp/aoc.sock"
+#define SERVE_MAX_LINE 4352  // a request line, PATH_MAX and then some
+#define SERVE_MAX_PAYLOAD (1024ULL * 1024 * 1024)  // input bytes of one request
+
+typedef struct {
+    const Aoc_Day* const* days;
+    size_t count;
+    const char* socket_path;
+    int listen_fd;
+} Serve;
+
+typedef struct {
+    Serve* serve;
+    int fd;
+} Serve_Connection;
+
+static inline bool serve__address(const char* path, struct sockaddr_un* address) {
+    memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    if (strlen(path) >= sizeof(address->sun_path)) {
+        nob_log(NOB_ERROR, "The socket path %s is too long", path);
+        return false;
+    }
+    strcpy(address->sun_path, path);
+    return true;
+}
+
+static inline const Aoc_Day* serve__find_day(const Serve* serve, int number) {
+    for (size_t i = 0; i < serve->count; ++i) {
+        if (serve->days[i]->number == number) return serve->days[i];
+    }
+    return NULL;
+}
+
+// Solves one input and writes the JSON answer line
+static inline void serve__solve(const Serve* serve, int number, int part, Input* input, FILE* out) {
+    const Aoc_Day* day = serve__find_day(serve, number);
+    if (day == NULL) {
+        fprintf(out, "{\"error\": \"there is no day %d\"}\n", number);
+        return;
+    }
+
+    uint64_t start = bench_now_ns();
+    void* state = day->parse(&input->lines);
+    uint64_t parsed = bench_now_ns();
+    if (state == NULL) {
+        fprintf(out, "{\"error\": \"day %d could not parse the input\"}\n", number);
+        return;
+    }
+
+    fprintf(out, "{\"day\": %d", number);
+    uint64_t part_ns[2] = {0};
+    for (int p = 1; p <= 2; ++p) {
+        uint64_t (*solve)(const void*) = p == 1 ? day->part_1 : day->part_2;
+        if (solve == NULL || (part != 0 && part != p)) continue;
+        uint64_t part_start = bench_now_ns();
+        uint64_t answer = solve(state);
+        part_ns[p - 1] = bench_now_ns() - part_start;
+        fprintf(out, ", \"part%d\": %" PRIu64, p, answer);
+    }
+    if (day->free) (day->free)(state);
+
+    fprintf(out, ", \"parse_ns\": %" PRIu64, parsed - start);
+    for (int p = 1; p <= 2; ++p) {
+        if (part_ns[p - 1]) fprintf(out, ", \"part%d_ns\": %" PRIu64, p, part_ns[p - 1]);
+    }
+    fprintf(out, ", \"total_ns\": %" PRIu64 "}\n", bench_now_ns() - start);
+}
+
+static inline void* serve__connection(void* arg) {
+    Serve_Connection connection = *(Serve_Connection*)arg;
+    free(arg);
+
+    FILE* in = fdopen(connection.fd, "r");
+    FILE* out = fdopen(dup(connection.fd), "w");
+    if (in == NULL || out == NULL) {
+        if (in) fclose(in);
+        if (out) fclose(out);
+        return NULL;
+    }
+
+    // Kept for the whole connection, so a client sending bytes over and over stops allocating
+    Nob_String_Builder bytes = {0};
+    char line[SERVE_MAX_LINE];
+    while (fgets(line, sizeof(line), in)) {
+        int day = 0, part = 0, consumed = 0;
+        char kind[8] = {0};
+
+        if (strcmp(line, "stop\n") == 0) {
+            fprintf(out, "{\"stopped\": true}\n");
+            fflush(out);
+            nob_log(NOB_INFO, "Stopped by a client");
+            unlink(connection.serve->socket_path);
+            exit(0);
+        }
+        if (sscanf(line, "solve %d %d %7s %n", &day, &part, kind, &consumed) != 3 || part < 0 || part > 2) {
+            fprintf(out, "{\"error\": \"expected solve <day> <part> path|bytes ...\"}\n");
+            fflush(out);
+            continue;
+        }
+
+        Input input = {0};
+        if (strcmp(kind, "path") == 0) {
+            char* path = line + consumed;
+            path[strcspn(path, "\n")] = '\0';
+            if (!input_load(path, &input)) {
+                fprintf(out, "{\"error\": \"could not load the input file\"}\n");
+                fflush(out);
+                continue;
+            }
+        } else if (strcmp(kind, "bytes") == 0) {
+            // strtoull() takes a sign and saturates on overflow, neither is a length
+            const char* digits = line + consumed;
+            char* end = NULL;
+            errno = 0;
+            unsigned long long length = strtoull(digits, &end, 10);
+            if (*digits < '0' || *digits > '9' || errno == ERANGE || *end != '\n' || length > SERVE_MAX_PAYLOAD) {
+                fprintf(out, "{\"error\": \"bytes expects a length of at most %llu\"}\n", SERVE_MAX_PAYLOAD);
+                fflush(out);
+                break;
+            }
+            bytes.count = 0;
+            nob_da_reserve(&bytes, length);
+            if (fread(bytes.items, 1, length, in) != length) break;  // the client hung up mid request
+            bytes.count = length;
+            input_from_memory(bytes.items, bytes.count, &input);
+        } else {
+            fprintf(out, "{\"error\": \"expected path or bytes\"}\n");
+            fflush(out);
+            continue;
+        }
+
+        serve__solve(connection.serve, day, part, &input, out);
+        fflush(out);
+        input_free(&input);
+    }
+
+    nob_sb_free(bytes);
+    fclose(in);
+    fclose(out);
+    return NULL;
+}
+
+static inline bool serve__parse_socket(int* argc, char*** argv, const char** socket_path) {
+    if (*argc > 0 && strcmp((*argv)[0], "--socket") == 0) {
+        nob_shift(*argv, *argc);
+        if (*argc == 0) {
+            nob_log(NOB_ERROR, "--socket expects a path");
+            return false;
+        }
+        *socket_path = nob_shift(*argv, *argc);
+    }
+    return true;
+}
+
+static inline int serve_main(const Aoc_Day* const* days, size_t count, int argc, char** argv) {
+    const char* program = nob_shift(argv, argc);
+    nob_shift(argv, argc);  // "serve"
+    Serve serve = {.days = days, .count = count, .socket_path = SERVE_DEFAULT_SOCKET};
+    if (!serve__parse_socket(&argc, &argv, &serve.socket_path)) return 1;
+    if (argc > 0) {
+        fprintf(stderr, "Usage: %s serve [--socket PATH]\n", program);
+        return 1;
+    }
+
+    struct sockaddr_un address;
+    if (!serve__address(serve.socket_path, &address)) return 1;
+
+    // A socket file nobody listens on is left over from a server that died, anything else is in use
+    int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (probe >= 0 && connect(probe, (struct sockaddr*)&address, sizeof(address)) == 0) {
+        nob_log(NOB_ERROR, "Another server is listening on %s", serve.socket_path);
+        close(probe);
+        return 1;
+    }
+    if (probe >= 0) close(probe);
+    unlink(serve.socket_path);
+
+    serve.listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (serve.listen_fd < 0 || bind(serve.listen_fd, (struct sockaddr*)&address, sizeof(address)) < 0 ||
+        listen(serve.listen_fd, 64) < 0) {
+        nob_log(NOB_ERROR, "Could not listen on %s: %s", serve.socket_path, strerror(errno));
+        return 1;
+    }
+
+    signal(SIGPIPE, SIG_IGN);  // a client that hangs up must not take the server down
+    nob_log(NOB_INFO, "Listening on %s with %zu pool threads", serve.socket_path, pool_worker_count());
+
+    for (;;) {
+        int fd = accept(serve.listen_fd, NULL, NULL);
+        if (fd < 0) {
+            if (errno == EINTR) continue;
+            nob_log(NOB_ERROR, "Could not accept a connection: %s", strerror(errno));
+            break;
+        }
+
+        Serve_Connection* connection = malloc(sizeof(*connection));
+        NOB_ASSERT(connection != NULL && "Buy more RAM lol");
+        *connection = (Serve_Connection){.serve = &serve, .fd = fd};
+        pthread_t thread;
+        if (pthread_create(&thread, NULL, serve__connection, connection) != 0) {
+            nob_log(NOB_ERROR, "Could not start a connection thread");
+            close(fd);
+            free(connection);
+            continue;
+        }
+        pthread_detach(thread);
+    }
+
+    close(serve.listen_fd);
+    unlink(serve.socket_path);
+    return 1;
+}
+
+static inline void serve__client_usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s client [--socket PATH] --day N [--part 1|2] [--input PATH | --input -]\n"
+            "       %s client [--socket PATH] --stop\n",
+            program, program);
+}
+
+// Pulls `"key": <number>` out of a response line
+static inline bool serve__field(const char* response, const char* key, uint64_t* value) {
+    const char* found = strstr(response, nob_temp_sprintf("\"%s\": ", key));
+    if (found == NULL) return false;
+    *value = strtoull(found + strlen(key) + 4, NULL, 10);
+    return true;
+}
+
+static inline int serve_client_main(const Aoc_Day* const* days, size_t count, int argc, char** argv) {
+    const char* program = nob_shift(argv, argc);
+    nob_shift(argv, argc);  // "client"
+    const char* socket_path = SERVE_DEFAULT_SOCKET;
+    const char* input = NULL;
+    long day = 0, part = 0;
+    bool stop = false;
+
+    while (argc > 0) {
+        if (!serve__parse_socket(&argc, &argv, &socket_path)) return 1;
+        if (argc == 0) break;
+        const char* flag = nob_shift(argv, argc);
+        const char* value = argc > 0 ? argv[0] : NULL;
+
+        if (strcmp(flag, "--day") == 0) {
+            if (!aoc__parse_count(flag, value, 1, 25, &day)) return 1;
+        } else if (strcmp(flag, "--part") == 0) {
+            if (!aoc__parse_count(flag, value, 1, 2, &part)) return 1;
+        } else if (strcmp(flag, "--input") == 0) {
+            if (value == NULL) {
+                nob_log(NOB_ERROR, "--input expects a path or -");
+                return 1;
+            }
+            input = value;
+        } else if (strcmp(flag, "--stop") == 0) {
+            stop = true;
+            continue;  // takes no value
+        } else {
+            serve__client_usage(program);
+            return 1;
+        }
+        nob_shift(argv, argc);
+    }
+    if (!stop && day == 0) {
+        serve__client_usage(program);
+        return 1;
+    }
+
+    struct sockaddr_un address;
+    if (!serve__address(socket_path, &address)) return 1;
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+        nob_log(NOB_ERROR, "Could not connect to %s: %s (is `aoc serve` running?)", socket_path, strerror(errno));
+        if (fd >= 0) close(fd);
+        return 1;
+    }
+    FILE* out = fdopen(dup(fd), "w");
+    FILE* in = fdopen(fd, "r");
+
+    if (stop) {
+        fprintf(out, "stop\n");
+    } else if (input && strcmp(input, "-") == 0) {
+        Nob_String_Builder bytes = {0};
+        char buffer[1 << 16];
+        size_t got;
+        while ((got = fread(buffer, 1, sizeof(buffer), stdin)) > 0) nob_sb_append_buf(&bytes, buffer, got);
+        fprintf(out, "solve %ld %ld bytes %zu\n", day, part, bytes.count);
+        fwrite(bytes.items, 1, bytes.count, out);
+        nob_sb_free(bytes);
+    } else {
+        // Without --input the server reads the day's own input, relative to our working directory
+        if (input == NULL) {
+            for (size_t i = 0; i < count; ++i) {
+                if (days[i]->number == day) input = days[i]->input_path;
+            }
+        }
+        char path[PATH_MAX];
+        if (input == NULL) {
+            nob_log(NOB_ERROR, "There is no day %ld", day);
+            fclose(in);
+            fclose(out);
+            return 1;
+        }
+        if (realpath(input, path) == NULL) {
+            nob_log(NOB_ERROR, "Could not find %s: %s", input, strerror(errno));
+            fclose(in);
+            fclose(out);
+            return 1;
+        }
+        fprintf(out, "solve %ld %ld path %s\n", day, part, path);
+    }
+    fclose(out);
+
+    char response[1024];
+    bool answered = fgets(response, sizeof(response), in) != NULL;
+    fclose(in);
+    if (!answered) {
+        nob_log(NOB_ERROR, "The server hung up");
+        return 1;
+    }
+    if (strstr(response, "\"error\"")) {
+        nob_log(NOB_ERROR, "%.*s", (int)strcspn(response, "\n"), response);
+        return 1;
+    }
+    if (stop) return 0;
+
+    uint64_t value = 0;
+    for (int p = 1; p <= 2; ++p) {
+        if (serve__field(response, nob_temp_sprintf("part%d", p), &value)) {
+            printf("Password (Part %d) : %" PRIu64 "\n", p, value);
+        }
+    }
+    uint64_t parse_ns = 0, total_ns = 0;
+    serve__field(response, "parse_ns", &parse_ns);
+    serve__field(response, "total_ns", &total_ns);
+    nob_log(NOB_INFO, "parse %.3f ms, total %.3f ms on the server", parse_ns / 1e6, total_ns / 1e6);
+    return 0;
+}
+
+#endif  // AOC_SERVE_H
@@ -0,0 +1,181 @@
+#ifndef AOC_SNAPSHOT_H
+#define AOC_SNAPSHOT_H
+
+// Parsed states written to disk and mapped back in, `aoc --snapshot DIR` in the runner.
+//
+//     aoc --day 8 --snapshot /tmp/snapshots   # parses, then writes the state next to the others
+//     aoc --day 8 --snapshot /tmp/snapshots   # maps the state back instead of parsing
+//
+// A day opts in with .save and .restore (see Aoc_Day). .save hands the arrays of a parsed state to
+// snapshot_add() one section at a time, .restore gets them back with snapshot_items() as pointers
+// into a read-only mapping of the file. Arrays of plain values come back without a copy, states made
+// of pointers have to be rebuilt from indices.
+//
+// A snapshot is named after the day and the hash of the input bytes (cache_hash()), so every input
+// gets its own. It also records the format, the day's .version and the input size, one that does not
+// match is parsed over and written again. Sections start on 64 byte boundaries, any array fits.
+//
+// Include nob.h and cache.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before snapshot.h"
+#endif
+#ifndef AOC_CACHE_H
+#error "include cache.h before snapshot.h"
+#endif
+
+#include <errno.h>
+#include <fcntl.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define SNAPSHOT_MAGIC "AOCSNAP1"
+#define SNAPSHOT_FORMAT 1
+#define SNAPSHOT_MAX_SECTIONS 8
+#define SNAPSHOT_ALIGN 64
+
+typedef struct {
+    uint64_t offset;  // from the start of the file
+    uint64_t size;    // in bytes
+} Snapshot_Section;
+
+typedef struct {
+    char magic[8];
+    uint32_t format;
+    uint32_t day;
+    uint32_t version;  // of the day's solvers
+    uint32_t section_count;
+    uint64_t input_hash;
+    uint64_t input_size;
+    Snapshot_Section sections[SNAPSHOT_MAX_SECTIONS];
+} Snapshot_Header;
+
+// Where the first section starts
+#define SNAPSHOT_DATA_OFFSET ((sizeof(Snapshot_Header) + SNAPSHOT_ALIGN - 1) / SNAPSHOT_ALIGN * SNAPSHOT_ALIGN)
+
+typedef struct {
+    Snapshot_Header header;
+    Nob_String_Builder data;  // the whole file, header space included
+} Snapshot_Writer;
+
+typedef struct {
+    void* mapping;
+    size_t size;
+    const Snapshot_Header* header;
+} Snapshot;
+
+static inline const char* snapshot_path(const char* folder, int day, uint64_t input_hash) {
+    return nob_temp_sprintf("%s/day%d-%016" PRIx64 ".snap", folder, day, input_hash);
+}
+
+// Appends one section, an empty one too so the indices stay put
+static inline void snapshot_add(Snapshot_Writer* writer, const void* data, size_t size) {
+    NOB_ASSERT(writer->header.section_count < SNAPSHOT_MAX_SECTIONS && "raise SNAPSHOT_MAX_SECTIONS");
+    if (writer->data.count < SNAPSHOT_DATA_OFFSET) {
+        nob_da_reserve(&writer->data, SNAPSHOT_DATA_OFFSET);
+        memset(writer->data.items, 0, SNAPSHOT_DATA_OFFSET);
+        writer->data.count = SNAPSHOT_DATA_OFFSET;
+    }
+    while (writer->data.count % SNAPSHOT_ALIGN) nob_da_append(&writer->data, '\0');
+
+    Snapshot_Section* section = &writer->header.sections[writer->header.section_count++];
+    section->offset = writer->data.count;
+    section->size = size;
+    if (size) nob_sb_append_buf(&writer->data, data, size);
+}
+
+// Writes through a temporary file, a runner mapping the old snapshot keeps its copy
+static inline bool snapshot_write(const char* path, Snapshot_Writer* writer, int day, uint32_t version,
+                                  uint64_t input_hash, uint64_t input_size) {
+    Snapshot_Header* header = &writer->header;
+    memcpy(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic));
+    header->format = SNAPSHOT_FORMAT;
+    header->day = (uint32_t)day;
+    header->version = version;
+    header->input_hash = input_hash;
+    header->input_size = input_size;
+    if (writer->data.count < SNAPSHOT_DATA_OFFSET) snapshot_add(writer, NULL, 0);
+    memcpy(writer->data.items, header, sizeof(*header));
+
+    const char* tmp = nob_temp_sprintf("%s.tmp", path);
+    if (!nob_write_entire_file(tmp, writer->data.items, writer->data.count)) return false;
+    if (rename(tmp, path) < 0) {
+        nob_log(NOB_ERROR, "Could not rename %s to %s: %s", tmp, path, strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+static inline void snapshot_writer_free(Snapshot_Writer* writer) {
+    nob_sb_free(writer->data);
+    *writer = (Snapshot_Writer){0};
+}
+
+// Maps the snapshot when it is one of this day, version and input. A missing or outdated snapshot
+// returns false quietly, the caller parses instead.
+static inline bool snapshot_open(const char* path, int day, uint32_t version, uint64_t input_hash,
+                                 uint64_t input_size, Snapshot* snapshot) {
+    *snapshot = (Snapshot){0};
+    int fd = open(path, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) return false;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < SNAPSHOT_DATA_OFFSET) {
+        close(fd);
+        return false;
+    }
+
+    int flags = MAP_PRIVATE;
+#ifdef MAP_POPULATE
+    flags |= MAP_POPULATE;
+#endif
+    void* mapping = mmap(NULL, (size_t)st.st_size, PROT_READ, flags, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED) {
+        nob_log(NOB_WARNING, "Could not map %s: %s", path, strerror(errno));
+        return false;
+    }
+
+    const Snapshot_Header* header = mapping;
+    bool ok = memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(header->magic)) == 0 && header->format == SNAPSHOT_FORMAT &&
+              header->day == (uint32_t)day && header->version == version && header->input_hash == input_hash &&
+              header->input_size == input_size && header->section_count <= SNAPSHOT_MAX_SECTIONS;
+    for (uint32_t i = 0; ok && i < header->section_count; ++i) {
+        const Snapshot_Section* section = &header->sections[i];
+        ok = section->offset % SNAPSHOT_ALIGN == 0 && section->offset <= (uint64_t)st.st_size &&
+             section->size <= (uint64_t)st.st_size - section->offset;
+    }
+    if (!ok) {
+        munmap(mapping, (size_t)st.st_size);
+        return false;
+    }
+
+    snapshot->mapping = mapping;
+    snapshot->size = (size_t)st.st_size;
+    snapshot->header = header;
+    return true;
+}
+
+static inline void snapshot_close(Snapshot* snapshot) {
+    if (snapshot->mapping) munmap(snapshot->mapping, snapshot->size);
+    *snapshot = (Snapshot){0};
+}
+
+// The section as an array of item_size items, NULL when there is no such section or its size is not
+// a whole number of items
+static inline const void* snapshot_items(const Snapshot* snapshot, size_t index, size_t item_size, size_t* count) {
+    *count = 0;
+    if (index >= snapshot->header->section_count) return NULL;
+    const Snapshot_Section* section = &snapshot->header->sections[index];
+    if (section->size % item_size) return NULL;
+    *count = section->size / item_size;
+    return (const char*)snapshot->mapping + section->offset;
+}
+
+#endif  // AOC_SNAPSHOT_H
@@ -6,7 +6,10 @@
 #define typeof(x) __typeof(x)
 #endif
 
+// The aoc runner links every day together, src/aoc.c carries the one copy of the implementation
+#ifndef AOC_RUNNER
 #define STB_DS_IMPLEMENTATION
+#endif
 
 /* stb_ds.h - v0.67 - public domain data structures - Sean Barrett 2019
 
@@ -440,6 +443,7 @@ CREDITS
 #define hmfree stbds_hmfree
 #define hmdefault stbds_hmdefault
 #define hmdefaults stbds_hmdefaults
+#define hmstats stbds_hmstats
 
 #define shput stbds_shput
 #define shputi stbds_shputi
@@ -455,6 +459,7 @@ CREDITS
 #define shfree stbds_shfree
 #define shdefault stbds_shdefault
 #define shdefaults stbds_shdefaults
+#define shstats stbds_shstats
 #define sh_new_arena stbds_sh_new_arena
 #define sh_new_strdup stbds_sh_new_strdup
 
@@ -477,6 +482,12 @@ CREDITS
 #define STBDS_NOTUSED(v) (void)sizeof(v)
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+#define STBDS__UNUSED __attribute__((unused))
+#else
+#define STBDS__UNUSED
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -496,6 +507,25 @@ extern void stbds_strreset(stbds_string_arena* a);
 // have to #define STBDS_UNIT_TESTS to call this
 extern void stbds_unit_tests(void);
 
+#ifdef STBDS_STATISTICS
+// per table counters, have to #define STBDS_STATISTICS to call hmstats()/shstats(). they survive grows,
+// shrinks and rebuilds, slots/used/tombstones describe the current table
+typedef struct {
+    size_t slots;
+    size_t used;
+    size_t tombstones;
+    size_t lookups;  // gets, puts and dels
+    size_t probes;   // buckets those visited, 1 per lookup is ideal
+    size_t grows;
+    size_t shrinks;
+    size_t rebuilds;  // same size, to flush tombstones
+    size_t rehash_items;
+    size_t rehash_probes;
+} stbds_hash_statistics;
+
+extern void stbds_hmstats_func(void* a, stbds_hash_statistics* stats);
+#endif
+
 ///////////////
 //
 // Everything below here is implementation details
@@ -606,6 +636,8 @@ extern void* stbds_shmode_func(size_t elemsize, int mode);
 #define stbds_hmfree(p) \
     ((void)((p) != NULL ? stbds_hmfree_func((p) - 1, sizeof *(p)), 0 : 0), (p) = NULL)
 
+#define stbds_hmstats(t, s) stbds_hmstats_func((t) != NULL ? (void*)((t) - 1) : NULL, (s))
+
 #define stbds_hmgets(t, k) (*stbds_hmgetp(t, k))
 #define stbds_hmget(t, k) (stbds_hmgetp(t, k)->value)
 #define stbds_hmget_ts(t, k, temp) (stbds_hmgetp_ts(t, k, temp)->value)
@@ -658,6 +690,7 @@ extern void* stbds_shmode_func(size_t elemsize, int mode);
 #define stbds_shdefaults(t, s) stbds_hmdefaults(t, s)
 
 #define stbds_shfree stbds_hmfree
+#define stbds_shstats stbds_hmstats
 #define stbds_shlenu stbds_hmlenu
 
 #define stbds_shgets(t, k) (*stbds_shgetp(t, k))
@@ -726,6 +759,15 @@ template <class T>
 static T* stbds_shmode_func_wrapper(T*, size_t elemsize, int mode) {
     return (T*)stbds_shmode_func(elemsize, mode);
 }
+#elif defined(AOC_ALLOC)
+// The alloc profile charges what these allocate to the line that used the macro, see header/alloc.h
+#define stbds_arrgrowf_wrapper(...) ALLOC_STBDS_CALL(stbds_arrgrowf(__VA_ARGS__))
+#define stbds_hmget_key_wrapper(...) ALLOC_STBDS_CALL(stbds_hmget_key(__VA_ARGS__))
+#define stbds_hmget_key_ts_wrapper(...) ALLOC_STBDS_CALL(stbds_hmget_key_ts(__VA_ARGS__))
+#define stbds_hmput_default_wrapper(...) ALLOC_STBDS_CALL(stbds_hmput_default(__VA_ARGS__))
+#define stbds_hmput_key_wrapper(...) ALLOC_STBDS_CALL(stbds_hmput_key(__VA_ARGS__))
+#define stbds_hmdel_key_wrapper(...) ALLOC_STBDS_CALL(stbds_hmdel_key(__VA_ARGS__))
+#define stbds_shmode_func_wrapper(t, e, m) ALLOC_STBDS_CALL(stbds_shmode_func(e, m))
 #else
 #define stbds_arrgrowf_wrapper stbds_arrgrowf
 #define stbds_hmget_key_wrapper stbds_hmget_key
@@ -848,6 +890,9 @@ typedef struct
     size_t seed;
     size_t slot_count_log2;
     stbds_string_arena string;
+#ifdef STBDS_STATISTICS
+    stbds_hash_statistics stats;
+#endif
     stbds_hash_bucket* storage;  // not a separate allocation, just 64-byte aligned storage after this struct
 } stbds_hash_index;
 
@@ -942,6 +987,12 @@ static stbds_hash_index* stbds_make_hash_index(size_t slot_count, stbds_hash_ind
     // to avoid infinite loop, we need to guarantee that at least one slot is empty and will terminate probes
     STBDS_ASSERT(t->used_count_threshold + t->tombstone_count_threshold < t->slot_count);
     STBDS_STATS(++stbds_hash_alloc);
+#ifdef STBDS_STATISTICS
+    if (ot)
+        t->stats = ot->stats;
+    else
+        memset(&t->stats, 0, sizeof(t->stats));
+#endif
     if (ot) {
         t->string = ot->string;
         // reuse old seed so we can reuse old hashes so below "copy out old data" doesn't do any hashing
@@ -981,11 +1032,13 @@ static stbds_hash_index* stbds_make_hash_index(size_t slot_count, stbds_hash_ind
                     size_t pos = stbds_probe_position(hash, t->slot_count, t->slot_count_log2);
                     size_t step = STBDS_BUCKET_LENGTH;
                     STBDS_STATS(++stbds_rehash_items);
+                    STBDS_STATS(++t->stats.rehash_items);
                     for (;;) {
                         size_t limit, z;
                         stbds_hash_bucket* bucket;
                         bucket = &t->storage[pos >> STBDS_BUCKET_SHIFT];
                         STBDS_STATS(++stbds_rehash_probes);
+                        STBDS_STATS(++t->stats.rehash_probes);
 
                         for (z = pos & STBDS_BUCKET_MASK; z < STBDS_BUCKET_LENGTH; ++z) {
                             if (bucket->hash[z] == 0) {
@@ -1054,7 +1107,8 @@ typedef int STBDS_SIPHASH_2_4_can_only_be_used_in_64_bit_builds[sizeof(size_t) =
 #pragma warning(disable : 4127)  // conditional expression is constant, for do..while(0) and sizeof()==
 #endif
 
-static size_t stbds_siphash_bytes(void* p, size_t len, size_t seed) {
+// Kept for STBDS_SIPHASH_2_4 experiments, stbds_hash_bytes() below hashes with FNV-1a instead
+STBDS__UNUSED static size_t stbds_siphash_bytes(void* p, size_t len, size_t seed) {
     unsigned char* d = (unsigned char*)p;
     size_t i, j;
     size_t v0, v1, v2, v3, data;
@@ -1193,9 +1247,11 @@ static ptrdiff_t stbds_hm_find_slot(void* a, size_t elemsize, void* key, size_t
     if (hash < 2) hash += 2;  // stored hash values are forbidden from being 0, so we can detect empty slots
 
     pos = stbds_probe_position(hash, table->slot_count, table->slot_count_log2);
+    STBDS_STATS(++table->stats.lookups);
 
     for (;;) {
         STBDS_STATS(++stbds_hash_probes);
+        STBDS_STATS(++table->stats.probes);
         bucket = &table->storage[pos >> STBDS_BUCKET_SHIFT];
 
         // start searching from pos to end of bucket, this should help performance on small hash tables that fit in cache
@@ -1313,6 +1369,7 @@ void* stbds_hmput_key(void* a, size_t elemsize, void* key, size_t keysize, int m
             nt->string.mode = mode >= STBDS_HM_STRING ? STBDS_SH_DEFAULT : 0;
         stbds_header(a)->hash_table = table = nt;
         STBDS_STATS(++stbds_hash_grow);
+        STBDS_STATS(if (nt->slot_count > STBDS_BUCKET_LENGTH) ++nt->stats.grows);
     }
 
     // we iterate hash table explicitly because we want to track if we saw a tombstone
@@ -1327,10 +1384,12 @@ void* stbds_hmput_key(void* a, size_t elemsize, void* key, size_t keysize, int m
         if (hash < 2) hash += 2;
 
         pos = stbds_probe_position(hash, table->slot_count, table->slot_count_log2);
+        STBDS_STATS(++table->stats.lookups);
 
         for (;;) {
             size_t limit, i;
             STBDS_STATS(++stbds_hash_probes);
+            STBDS_STATS(++table->stats.probes);
             bucket = &table->storage[pos >> STBDS_BUCKET_SHIFT];
 
             // start searching from pos to end of bucket
@@ -1413,6 +1472,18 @@ void* stbds_hmput_key(void* a, size_t elemsize, void* key, size_t keysize, int m
     }
 }
 
+#ifdef STBDS_STATISTICS
+void stbds_hmstats_func(void* a, stbds_hash_statistics* stats) {
+    stbds_hash_index* table = a ? (stbds_hash_index*)stbds_header(a)->hash_table : NULL;
+    memset(stats, 0, sizeof(*stats));
+    if (table == NULL) return;
+    *stats = table->stats;
+    stats->slots = table->slot_count;
+    stats->used = table->used_count;
+    stats->tombstones = table->tombstone_count;
+}
+#endif
+
 void* stbds_shmode_func(size_t elemsize, int mode) {
     void* a = stbds_arrgrowf(0, elemsize, 0, 1);
     stbds_hash_index* h;
@@ -1477,10 +1548,12 @@ void* stbds_hmdel_key(void* a, size_t elemsize, void* key, size_t keysize, size_
                     stbds_header(raw_a)->hash_table = stbds_make_hash_index(table->slot_count >> 1, table);
                     STBDS_FREE(NULL, table);
                     STBDS_STATS(++stbds_hash_shrink);
+                    STBDS_STATS(++((stbds_hash_index*)stbds_header(raw_a)->hash_table)->stats.shrinks);
                 } else if (table->tombstone_count > table->tombstone_count_threshold) {
                     stbds_header(raw_a)->hash_table = stbds_make_hash_index(table->slot_count, table);
                     STBDS_FREE(NULL, table);
                     STBDS_STATS(++stbds_hash_rebuild);
+                    STBDS_STATS(++((stbds_hash_index*)stbds_header(raw_a)->hash_table)->stats.rebuilds);
                 }
 
                 return a;
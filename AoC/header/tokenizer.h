@@ -0,0 +1,147 @@
+#ifndef AOC_TOKENIZER_H
+#define AOC_TOKENIZER_H
+
+// Allocation-free tokenizer over Nob_String_View.
+//
+// Tokens are views into the text being split, nothing is copied and nothing needs to be freed.
+// The text (usually a line from input.h) must outlive the tokens.
+//
+//     Tokenizer tok = tok_chars(line, ",");
+//     String_View token;
+//     while (tok_next(&tok, &token)) { ... }
+//
+// Include nob.h before this header.
+
+#ifndef NOB_H_
+#error "include nob.h before tokenizer.h"
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+typedef struct {
+    Nob_String_View* items;
+    size_t count;
+    size_t capacity;
+} Tokens;
+
+typedef enum {
+    TOK_CHARS,      // any character of delims separates tokens, empty tokens are skipped (like strtok)
+    TOK_STRING,     // the whole delims string separates tokens, empty tokens are skipped
+    TOK_KEEP_RUNS,  // exactly one delimiter is consumed, the rest of a run leads the next token
+} Tok_Mode;
+
+typedef struct {
+    Nob_String_View rest;
+    Nob_String_View delims;  // TOK_CHARS and TOK_STRING
+    char delim;              // TOK_KEEP_RUNS
+    Tok_Mode mode;
+} Tokenizer;
+
+static inline Tokenizer tok_chars(Nob_String_View text, const char* delims) {
+    return (Tokenizer){.rest = text, .delims = nob_sv_from_cstr(delims), .mode = TOK_CHARS};
+}
+
+static inline Tokenizer tok_string(Nob_String_View text, const char* delim) {
+    return (Tokenizer){.rest = text, .delims = nob_sv_from_cstr(delim), .mode = TOK_STRING};
+}
+
+// Splits "*   +   *" into "*", "  +", "  *". The leading delimiters are kept so columns that are
+// aligned with spaces keep their alignment. Trailing delimiters never produce a token.
+static inline Tokenizer tok_keep_runs(Nob_String_View text, char delim) {
+    return (Tokenizer){.rest = text, .delim = delim, .mode = TOK_KEEP_RUNS};
+}
+
+static inline bool tok__is_delim(const Tokenizer* tok, char c) {
+    return memchr(tok->delims.data, c, tok->delims.count) != NULL;
+}
+
+static inline bool tok__next_chars(Tokenizer* tok, Nob_String_View* token) {
+    if (tok->delims.count == 1) {
+        char delim = tok->delims.data[0];
+        while (tok->rest.count > 0) {
+            *token = nob_sv_chop_by_delim(&tok->rest, delim);
+            if (token->count > 0) return true;
+        }
+        return false;
+    }
+
+    while (tok->rest.count > 0 && tok__is_delim(tok, tok->rest.data[0])) {
+        nob_sv_chop_left(&tok->rest, 1);
+    }
+    if (tok->rest.count == 0) return false;
+
+    size_t len = 0;
+    while (len < tok->rest.count && !tok__is_delim(tok, tok->rest.data[len])) len++;
+
+    *token = nob_sv_chop_left(&tok->rest, len);
+    if (tok->rest.count > 0) nob_sv_chop_left(&tok->rest, 1);
+    return true;
+}
+
+static inline bool tok__next_string(Tokenizer* tok, Nob_String_View* token) {
+    Nob_String_View delim = tok->delims;
+
+    while (tok->rest.count > 0) {
+        size_t len = 0;
+        while (len + delim.count <= tok->rest.count &&
+               memcmp(tok->rest.data + len, delim.data, delim.count) != 0) {
+            len++;
+        }
+
+        if (len + delim.count > tok->rest.count) {
+            // No delimiter left, the rest is the last token
+            *token = nob_sv_chop_left(&tok->rest, tok->rest.count);
+            return true;
+        }
+
+        *token = nob_sv_chop_left(&tok->rest, len);
+        nob_sv_chop_left(&tok->rest, delim.count);
+        if (token->count > 0) return true;
+    }
+    return false;
+}
+
+static inline bool tok__next_keep_runs(Tokenizer* tok, Nob_String_View* token) {
+    char delim = tok->delim;
+
+    size_t i = 0;
+    while (i < tok->rest.count && tok->rest.data[i] == delim) i++;
+    if (i == tok->rest.count) {
+        // Only delimiters left
+        nob_sv_chop_left(&tok->rest, tok->rest.count);
+        return false;
+    }
+
+    while (i < tok->rest.count && tok->rest.data[i] != delim) i++;
+
+    *token = nob_sv_chop_left(&tok->rest, i);
+    if (tok->rest.count > 0) nob_sv_chop_left(&tok->rest, 1);
+    return true;
+}
+
+static inline bool tok_next(Tokenizer* tok, Nob_String_View* token) {
+    switch (tok->mode) {
+        case TOK_CHARS:
+            return tok__next_chars(tok, token);
+        case TOK_STRING:
+            return tok__next_string(tok, token);
+        case TOK_KEEP_RUNS:
+            return tok__next_keep_runs(tok, token);
+    }
+    return false;
+}
+
+// Appends every remaining token to out and returns how many were appended. Reuse the same Tokens
+// between lines (reset out->count) and the only allocation is the array growing once.
+static inline size_t tok_collect(Tokenizer tok, Tokens* out) {
+    size_t before = out->count;
+    Nob_String_View token;
+    while (tok_next(&tok, &token)) {
+        nob_da_append(out, token);
+    }
+    return out->count - before;
+}
+
+#endif  // AOC_TOKENIZER_H
@@ -0,0 +1,193 @@
+#ifndef AOC_TRACE_H
+#define AOC_TRACE_H
+
+// Timeline of the solver phases in the chrome://tracing / Perfetto trace event format.
+//
+//     TRACE_SCOPE("build");         // until the end of the enclosing block
+//
+//     TRACE_BEGIN("wave");
+//     ...
+//     TRACE_END();
+//
+//     TRACE_COUNTER("visited", "load", 0.4);  // a counter track, one per name and key
+//
+// Tracing only exists in builds with -DAOC_TRACE (./nob trace), everywhere else the macros expand to
+// nothing. Every thread records into its own buffer, which it links into a global list with one
+// compare-and-swap the first time it traces, so recording never takes a lock. At exit all buffers
+// are written to $AOC_TRACE_FILE (trace.json by default), ready for ui.perfetto.dev.
+//
+// The runner traces every day, its parse and both parts, perf_begin()/perf_end() phases show up too.
+// Names and keys must be string literals or otherwise outlive the process.
+//
+// Like stb_ds, the aoc runner links every day together and src/aoc.c carries the one copy of the
+// buffer list, days built on their own carry their own.
+
+#ifdef AOC_TRACE
+
+#ifndef AOC_RUNNER
+#define AOC_TRACE_IMPLEMENTATION
+#endif
+
+#include <stddef.h>
+#include <stdint.h>
+#include <time.h>
+
+#define TRACE_CHUNK_EVENTS 4096
+
+typedef struct {
+    const char* name;
+    uint64_t ts_ns;
+    char phase;       // 'B', 'E' or 'C'
+    const char* key;  // counters only
+    double value;
+} Trace_Event;
+
+typedef struct Trace_Chunk {
+    struct Trace_Chunk* next;
+    size_t count;
+    Trace_Event events[TRACE_CHUNK_EVENTS];
+} Trace_Chunk;
+
+typedef struct Trace_Buffer {
+    struct Trace_Buffer* next;
+    int tid;
+    Trace_Chunk* first;
+    Trace_Chunk* last;
+} Trace_Buffer;
+
+extern _Thread_local Trace_Buffer* trace__local;
+Trace_Buffer* trace__register(void);
+Trace_Chunk* trace__grow(Trace_Buffer* buffer);
+
+static inline Trace_Event* trace__record(const char* name, char phase) {
+    Trace_Buffer* buffer = trace__local ? trace__local : trace__register();
+    Trace_Chunk* chunk = buffer->last;
+    if (chunk->count == TRACE_CHUNK_EVENTS) chunk = trace__grow(buffer);
+
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    Trace_Event* event = &chunk->events[chunk->count++];
+    *event = (Trace_Event){
+        .name = name,
+        .ts_ns = (uint64_t)ts.tv_sec * 1000000000ull + (uint64_t)ts.tv_nsec,
+        .phase = phase,
+    };
+    return event;
+}
+
+static inline void trace__counter(const char* name, const char* key, double value) {
+    Trace_Event* event = trace__record(name, 'C');
+    event->key = key;
+    event->value = value;
+}
+
+static inline void trace__scope_end(const char* const* name) {
+    trace__record(*name, 'E');
+}
+
+#define TRACE__CONCAT2(a, b) a##b
+#define TRACE__CONCAT(a, b) TRACE__CONCAT2(a, b)
+
+#define TRACE_BEGIN(name) ((void)trace__record((name), 'B'))
+#define TRACE_END() ((void)trace__record(NULL, 'E'))
+#define TRACE_COUNTER(name, key, value) trace__counter((name), (key), (value))
+#define TRACE_SCOPE(name)                                                                         \
+    __attribute__((cleanup(trace__scope_end))) const char* const TRACE__CONCAT(trace__scope_, __LINE__) = \
+        ((void)trace__record((name), 'B'), (name))
+
+#ifdef AOC_TRACE_IMPLEMENTATION
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+_Thread_local Trace_Buffer* trace__local = NULL;
+
+static Trace_Buffer* trace__buffers = NULL;
+static bool trace__exit_registered = false;
+
+static void trace__write_string(FILE* out, const char* s) {
+    fputc('"', out);
+    for (; s && *s; ++s) {
+        if (*s == '"' || *s == '\\') fputc('\\', out);
+        fputc(*s, out);
+    }
+    fputc('"', out);
+}
+
+static void trace__dump(void) {
+    const char* path = getenv("AOC_TRACE_FILE");
+    if (path == NULL) path = "trace.json";
+
+    FILE* out = fopen(path, "w");
+    if (out == NULL) {
+        fprintf(stderr, "[ERROR] Could not write the trace to %s\n", path);
+        return;
+    }
+
+    int pid = (int)getpid();
+    bool first = true;
+    fprintf(out, "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [\n");
+    for (Trace_Buffer* buffer = __atomic_load_n(&trace__buffers, __ATOMIC_ACQUIRE); buffer; buffer = buffer->next) {
+        for (Trace_Chunk* chunk = buffer->first; chunk; chunk = chunk->next) {
+            for (size_t i = 0; i < chunk->count; ++i) {
+                const Trace_Event* event = &chunk->events[i];
+                fprintf(out, "%s  {\"name\": ", first ? "" : ",\n");
+                trace__write_string(out, event->name ? event->name : "");
+                fprintf(out, ", \"ph\": \"%c\", \"ts\": %.3f, \"pid\": %d, \"tid\": %d", event->phase,
+                        event->ts_ns / 1e3, pid, buffer->tid);
+                if (event->phase == 'C') {
+                    fprintf(out, ", \"args\": {");
+                    trace__write_string(out, event->key);
+                    fprintf(out, ": %.6g}", event->value);
+                }
+                fputc('}', out);
+                first = false;
+            }
+        }
+    }
+    fprintf(out, "\n]}\n");
+    fclose(out);
+}
+
+Trace_Chunk* trace__grow(Trace_Buffer* buffer) {
+    Trace_Chunk* chunk = calloc(1, sizeof(Trace_Chunk));
+    if (chunk == NULL) abort();
+    if (buffer->last) buffer->last->next = chunk;
+    if (buffer->first == NULL) buffer->first = chunk;
+    buffer->last = chunk;
+    return chunk;
+}
+
+Trace_Buffer* trace__register(void) {
+    Trace_Buffer* buffer = calloc(1, sizeof(Trace_Buffer));
+    if (buffer == NULL) abort();
+    buffer->tid = (int)syscall(SYS_gettid);
+    trace__grow(buffer);
+
+    // Push onto the list, the buffer belongs to this thread and only the dump reads the others
+    buffer->next = __atomic_load_n(&trace__buffers, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&trace__buffers, &buffer->next, buffer, true, __ATOMIC_RELEASE,
+                                        __ATOMIC_RELAXED)) {
+    }
+
+    if (!__atomic_exchange_n(&trace__exit_registered, true, __ATOMIC_ACQ_REL)) atexit(trace__dump);
+
+    trace__local = buffer;
+    return buffer;
+}
+
+#endif  // AOC_TRACE_IMPLEMENTATION
+
+#else
+
+#define TRACE_BEGIN(name) ((void)0)
+#define TRACE_END() ((void)0)
+#define TRACE_COUNTER(name, key, value) ((void)0)
+#define TRACE_SCOPE(name)
+
+#endif  // AOC_TRACE
+
+#endif  // AOC_TRACE_H
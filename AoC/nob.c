@@ -21,50 +21,307 @@
 // examples)
 #include "nob.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 // Some folder paths that we use throughout the build process.
 #define BUILD_FOLDER "build/"
 #define SRC_FOLDER "src/"
+#define HEADER_FOLDER "header/"
+#define TOOLS_FOLDER "tools/"
+
+// Usage: ./nob [debug|release|native|lto|trace|alloc|pgo]
+//
+// Every src/q*.c is built twice: as a standalone binary build/<profile>/<day> and as an object that
+// goes into the build/<profile>/aoc runner. The compilers run in parallel (one per core) and anything
+// that is newer than its sources, the headers and this file is skipped.
+//
+// The helper programs in tools/ (input generators and the like) are built next to them.
+//
+// pgo is not a profile of its own but a pipeline, see build_pgo().
+typedef struct {
+    const char* name;
+    const char* flags[6];  // NULL terminated, used for compiling and for linking
+} Profile;
+
+static const Profile profiles[] = {
+    {"debug", {"-O0", "-g", NULL}},
+    {"release", {"-O3", NULL}},
+    {"native", {"-O3", "-march=native", NULL}},
+    {"lto", {"-O3", "-march=native", "-flto", NULL}},
+    {"trace", {"-O3", "-DAOC_TRACE", "-DSTBDS_STATISTICS", NULL}},  // trace.json and hash map stats, see header/trace.h
+    {"alloc", {"-O3", "-DAOC_ALLOC", "-include", HEADER_FOLDER "alloc.h", NULL}},  // allocation tables on exit, see header/alloc.h
+};
+
+// Both builds go to the same build/pgo/ paths, gcc names the .gcda files after the outputs so the
+// second build finds the profiles the first one wrote. Functions the inputs never reach keep their
+// regular optimization thanks to -fprofile-partial-training.
+static const Profile pgo_generate = {"pgo", {"-O3", "-march=native", "-flto", "-fprofile-generate", NULL}};
+static const Profile pgo_use = {"pgo", {"-O3", "-march=native", "-flto", "-fprofile-use", "-fprofile-partial-training", NULL}};
+
+// How many times every part runs when the pgo build is timed against the lto one
+#define PGO_TIMING_REPEAT "5"
+
+static const Profile* find_profile(const char* name) {
+    for (size_t i = 0; i < NOB_ARRAY_LEN(profiles); ++i) {
+        if (strcmp(profiles[i].name, name) == 0) return &profiles[i];
+    }
+    return NULL;
+}
+
+static void cmd_append_profile(Nob_Cmd* cmd, const Profile* profile) {
+    nob_cmd_append(cmd, "cc", "-Wall", "-Wextra", "-pthread");
+    for (size_t i = 0; profile->flags[i] != NULL; ++i) {
+        nob_cmd_append(cmd, profile->flags[i]);
+    }
+}
+
+// "q2_gift_shop" sorts before "q10_factory"
+static int compare_days(const void* a, const void* b) {
+    long x = strtol(*(const char**)a + 1, NULL, 10);
+    long y = strtol(*(const char**)b + 1, NULL, 10);
+    return (x > y) - (x < y);
+}
+
+// Collects the names (without the .c) of the days in src/, sorted so the build log is stable.
+static bool collect_days(Nob_File_Paths* days) {
+    Nob_File_Paths children = {0};
+    if (!nob_read_entire_dir(SRC_FOLDER, &children)) return false;
+
+    for (size_t i = 0; i < children.count; ++i) {
+        Nob_String_View name = nob_sv_from_cstr(children.items[i]);
+        if (name.count > 0 && name.data[0] == 'q' && nob_sv_end_with(name, ".c")) {
+            nob_da_append(days, nob_temp_sv_to_cstr(nob_sv_from_parts(name.data, name.count - 2)));
+        }
+    }
+    qsort(days->items, days->count, sizeof(*days->items), compare_days);
+
+    nob_da_free(children);
+    return true;
+}
+
+// Collects the names (without the .c) of the programs in tools/.
+static bool collect_tools(Nob_File_Paths* tools) {
+    Nob_File_Paths children = {0};
+    if (!nob_read_entire_dir(TOOLS_FOLDER, &children)) return false;
+
+    for (size_t i = 0; i < children.count; ++i) {
+        Nob_String_View name = nob_sv_from_cstr(children.items[i]);
+        if (nob_sv_end_with(name, ".c")) {
+            nob_da_append(tools, nob_temp_sv_to_cstr(nob_sv_from_parts(name.data, name.count - 2)));
+        }
+    }
+
+    nob_da_free(children);
+    return true;
+}
+
+// Every header can change any day, so each one counts as a dependency of every target.
+static bool collect_dependencies(Nob_File_Paths* deps) {
+    Nob_File_Paths children = {0};
+    if (!nob_read_entire_dir(HEADER_FOLDER, &children)) return false;
+
+    for (size_t i = 0; i < children.count; ++i) {
+        if (nob_sv_end_with(nob_sv_from_cstr(children.items[i]), ".h")) {
+            nob_da_append(deps, nob_temp_sprintf(HEADER_FOLDER "%s", children.items[i]));
+        }
+    }
+    nob_da_append(deps, __FILE__);
+
+    nob_da_free(children);
+    return true;
+}
+
+// Returns 1 when output is older than source or any of deps, 0 when it is up to date, -1 on error.
+static int needs_rebuild(const char* output, const char* source, const Nob_File_Paths* deps) {
+    Nob_File_Paths inputs = {0};
+    nob_da_append(&inputs, source);
+    nob_da_append_many(&inputs, deps->items, deps->count);
+
+    int result = nob_needs_rebuild(output, inputs.items, inputs.count);
+    nob_da_free(inputs);
+    return result;
+}
+
+// Builds every day, the runner and the tools with the given profile into build/<profile>/. With force set the
+// timestamps are ignored, for when only the flags changed.
+static bool build_profile(const Profile* profile, const Nob_File_Paths* days, const Nob_File_Paths* tools,
+                          const Nob_File_Paths* deps, bool force) {
+    // It's better to keep all the building artifacts in a separate build folder, one per profile so
+    // switching between them does not rebuild everything.
+    const char* out_folder = nob_temp_sprintf(BUILD_FOLDER "%s/", profile->name);
+    const char* obj_folder = nob_temp_sprintf("%sobj/", out_folder);
+    if (!nob_mkdir_if_not_exists(BUILD_FOLDER)) return false;
+    if (!nob_mkdir_if_not_exists(out_folder)) return false;
+    if (!nob_mkdir_if_not_exists(obj_folder)) return false;
+
+    // The working horse of nob is the Nob_Cmd structure. It's a Dynamic Array of strings which represent
+    // command line that you want to execute. With .async the command is only started and its process is
+    // added to procs, nob waits for the oldest ones once nob_nprocs() of them are running.
+    Nob_Cmd cmd = {0};
+    Nob_Procs procs = {0};
+    Nob_File_Paths objects = {0};
+    size_t max_procs = (size_t)nob_nprocs();
+
+    for (size_t i = 0; i < days->count; ++i) {
+        const char* source = nob_temp_sprintf(SRC_FOLDER "%s.c", days->items[i]);
+        const char* binary = nob_temp_sprintf("%s%s", out_folder, days->items[i]);
+        const char* object = nob_temp_sprintf("%s%s.o", obj_folder, days->items[i]);
+        nob_da_append(&objects, object);
+
+        int rebuild = force ? 1 : needs_rebuild(binary, source, deps);
+        if (rebuild < 0) return false;
+        if (rebuild) {
+            cmd_append_profile(&cmd, profile);
+            nob_cmd_append(&cmd, "-o", binary, source, "-lm");
+            if (!nob_cmd_run(&cmd, .async = &procs, .max_procs = max_procs)) return false;
+        }
+
+        rebuild = force ? 1 : needs_rebuild(object, source, deps);
+        if (rebuild < 0) return false;
+        if (rebuild) {
+            cmd_append_profile(&cmd, profile);
+            nob_cmd_append(&cmd, "-DAOC_RUNNER", "-c", "-o", object, source);
+            if (!nob_cmd_run(&cmd, .async = &procs, .max_procs = max_procs)) return false;
+        }
+    }
+
+    for (size_t i = 0; i < tools->count; ++i) {
+        const char* source = nob_temp_sprintf(TOOLS_FOLDER "%s.c", tools->items[i]);
+        const char* binary = nob_temp_sprintf("%s%s", out_folder, tools->items[i]);
+
+        int rebuild = force ? 1 : needs_rebuild(binary, source, deps);
+        if (rebuild < 0) return false;
+        if (rebuild) {
+            cmd_append_profile(&cmd, profile);
+            nob_cmd_append(&cmd, "-o", binary, source, "-lm");
+            if (!nob_cmd_run(&cmd, .async = &procs, .max_procs = max_procs)) return false;
+        }
+    }
+
+    // The runner itself carries the nob.h and stb_ds implementations for all the days.
+    const char* runner_object = nob_temp_sprintf("%saoc.o", obj_folder);
+    int rebuild = force ? 1 : needs_rebuild(runner_object, SRC_FOLDER "aoc.c", deps);
+    if (rebuild < 0) return false;
+    if (rebuild) {
+        cmd_append_profile(&cmd, profile);
+        nob_cmd_append(&cmd, "-DAOC_RUNNER", "-c", "-o", runner_object, SRC_FOLDER "aoc.c");
+        if (!nob_cmd_run(&cmd, .async = &procs, .max_procs = max_procs)) return false;
+    }
+    nob_da_append(&objects, runner_object);
+
+    if (!nob_procs_flush(&procs)) return false;
+
+    const char* runner = nob_temp_sprintf("%saoc", out_folder);
+    rebuild = force ? 1 : nob_needs_rebuild(runner, objects.items, objects.count);
+    if (rebuild < 0) return false;
+    if (rebuild) {
+        cmd_append_profile(&cmd, profile);
+        nob_cmd_append(&cmd, "-o", runner);
+        nob_da_append_many(&cmd, objects.items, objects.count);
+        nob_cmd_append(&cmd, "-lm");
+        if (!nob_cmd_run(&cmd)) return false;
+    } else {
+        nob_log(NOB_INFO, "%s is up to date", runner);
+    }
+
+    nob_cmd_free(cmd);
+    nob_da_free(procs);
+    nob_da_free(objects);
+    return true;
+
+}
+
+// Removes the .gcda files of an earlier pgo run, they would not match the new instrumented build.
+static bool remove_profiles(const char* folder) {
+    Nob_File_Paths children = {0};
+    if (!nob_read_entire_dir(folder, &children)) return false;
+
+    for (size_t i = 0; i < children.count; ++i) {
+        if (nob_sv_end_with(nob_sv_from_cstr(children.items[i]), ".gcda")) {
+            if (!nob_delete_file(nob_temp_sprintf("%s%s", folder, children.items[i]))) return false;
+        }
+    }
+
+    nob_da_free(children);
+    return true;
+}
+
+// Runs a binary from the AoC folder (the default input paths are relative to it) with its output
+// thrown away. Returns the wall clock time in nanoseconds, 0 if it failed.
+static uint64_t run_timed(const char* binary, const char* repeat) {
+    Nob_Cmd cmd = {0};
+    nob_cmd_append(&cmd, binary);
+    if (repeat) nob_cmd_append(&cmd, "--repeat", repeat);
+
+    uint64_t start = nob_nanos_since_unspecified_epoch();
+    bool ok = nob_cmd_run(&cmd, .stdout_path = "/dev/null", .stderr_path = "/dev/null");
+    uint64_t elapsed = nob_nanos_since_unspecified_epoch() - start;
+
+    nob_cmd_free(cmd);
+    return ok ? elapsed : 0;
+}
+
+// 1. build the lto profile as the baseline
+// 2. build build/pgo/ instrumented and run every day (and the runner) on its real input
+// 3. rebuild build/pgo/ with -fprofile-use
+// 4. time every day of the lto build against the pgo build
+static bool build_pgo(const Nob_File_Paths* days, const Nob_File_Paths* tools, const Nob_File_Paths* deps) {
+    const Profile* baseline = find_profile("lto");
+    if (!build_profile(baseline, days, tools, deps, false)) return false;
+
+    if (nob_file_exists(BUILD_FOLDER "pgo/")) {
+        if (!remove_profiles(BUILD_FOLDER "pgo/")) return false;
+        if (!remove_profiles(BUILD_FOLDER "pgo/obj/")) return false;
+    }
+    if (!build_profile(&pgo_generate, days, tools, deps, true)) return false;
+
+    nob_log(NOB_INFO, "Collecting profiles");
+    for (size_t i = 0; i < days->count; ++i) {
+        const char* binary = nob_temp_sprintf(BUILD_FOLDER "pgo/%s", days->items[i]);
+        if (run_timed(binary, NULL) == 0) return false;
+    }
+    if (run_timed(BUILD_FOLDER "pgo/aoc", NULL) == 0) return false;
+
+    if (!build_profile(&pgo_use, days, tools, deps, true)) return false;
+
+    printf("%-28s %12s %12s %8s\n", "day", "lto (ms)", "pgo (ms)", "speedup");
+    for (size_t i = 0; i < days->count; ++i) {
+        uint64_t before = run_timed(nob_temp_sprintf("%s%s/%s", BUILD_FOLDER, baseline->name, days->items[i]), PGO_TIMING_REPEAT);
+        uint64_t after = run_timed(nob_temp_sprintf(BUILD_FOLDER "pgo/%s", days->items[i]), PGO_TIMING_REPEAT);
+        if (before == 0 || after == 0) return false;
+
+        printf("%-28s %12.3f %12.3f %7.2fx\n", days->items[i], before / 1e6, after / 1e6, (double)before / after);
+    }
+
+    return true;
+}
 
 int main(int argc, char** argv) {
     // This line enables the self-rebuilding. It detects when nob.c is updated and auto rebuilds it then
     // runs it again.
     NOB_GO_REBUILD_URSELF(argc, argv);
 
-    // It's better to keep all the building artifacts in a separate build folder. Let's create it if it
-    // does not exist yet.
-    //
-    // Majority of the nob command return bool which indicates whether operation has failed or not (true -
-    // success, false - failure). If the operation returned false you don't need to log anything, the
-    // convention is usually that the function logs what happened to itself. Just do
-    // `if (!nob_function()) return;`
-    if (!nob_mkdir_if_not_exists(BUILD_FOLDER)) return 1;
+    const char* program = nob_shift(argv, argc);
+    const char* profile_name = argc > 0 ? nob_shift(argv, argc) : "release";
 
-    // The working horse of nob is the Nob_Cmd structure. It's a Dynamic Array of strings which represent
-    // command line that you want to execute.
-    Nob_Cmd cmd = {0};
+    Nob_File_Paths days = {0};
+    Nob_File_Paths tools = {0};
+    Nob_File_Paths deps = {0};
+    if (!collect_days(&days)) return 1;
+    if (!collect_tools(&tools)) return 1;
+    if (!collect_dependencies(&deps)) return 1;
+
+    if (strcmp(profile_name, "pgo") == 0) {
+        return build_pgo(&days, &tools, &deps) ? 0 : 1;
+    }
+
+    const Profile* profile = find_profile(profile_name);
+    if (profile == NULL) {
+        nob_log(NOB_ERROR, "Unknown profile %s", profile_name);
+        nob_log(NOB_ERROR, "Usage: %s [debug|release|native|lto|trace|alloc|pgo]", program);
+        return 1;
+    }
 
-    // Let's append the command line arguments
-#if !defined(_MSC_VER)
-    // On POSIX
-    nob_cmd_append(&cmd, "cc", "-Wall", "-Wextra", "-o", BUILD_FOLDER "q8_playground", SRC_FOLDER "q8_playground.c");
-#else
-    // On MSVC
-    nob_cmd_append(&cmd, "cl", "-I.", "-o", BUILD_FOLDER "hello", SRC_FOLDER "hello.c");
-#endif  // _MSC_VER
-
-    // Let's execute the command.
-    if (!nob_cmd_run(&cmd)) return 1;
-    // nob_cmd_run() automatically resets the cmd array, so you can nob_cmd_append() more strings
-    // into it.
-
-    // nob.h ships with a bunch of nob_cc_* macros that try abstract away the specific compiler.
-    // They are verify basic and not particularly flexible, but you can redefine them if you need to
-    // or not use them at all and create your own abstraction on top of Nob_Cmd.
-    nob_cc(&cmd);
-    nob_cc_flags(&cmd);
-    nob_cc_output(&cmd, BUILD_FOLDER "q8_playground");
-    nob_cc_inputs(&cmd, SRC_FOLDER "q8_playground.c");
-    if (!nob_cmd_run(&cmd)) return 1;
-
-    return 0;
-}
\ No newline at end of file
+    return build_profile(profile, &days, &tools, &deps, false) ? 0 : 1;
+}
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NOB_IMPLEMENTATION
+#define NOB_STRIP_PREFIX
+#define STB_DS_IMPLEMENTATION
+#define AOC_PERF_IMPLEMENTATION
+#define AOC_TRACE_IMPLEMENTATION
+#define AOC_ALLOC_IMPLEMENTATION
+#define AOC_MAP_STATS_IMPLEMENTATION
+#define AOC_POOL_IMPLEMENTATION
+
+#include "../header/nob.h"
+#include "../header/std_ds.h"
+#include "../header/input.h"
+#include "../header/arena.h"
+#include "../header/pool.h"
+#include "../header/aoc.h"
+#include "../header/scale.h"
+#include "../header/diff.h"
+#include "../header/batch.h"
+#include "../header/serve.h"
+
+// Every day is compiled with -DAOC_RUNNER and only exports its aoc_day_<n> entry,
+// the nob.h, stb_ds, perf.h, trace.h, alloc.h, map_stats.h and pool.h implementations live in this file.
+extern const Aoc_Day aoc_day_1;
+extern const Aoc_Day aoc_day_2;
+extern const Aoc_Day aoc_day_3;
+extern const Aoc_Day aoc_day_4;
+extern const Aoc_Day aoc_day_5;
+extern const Aoc_Day aoc_day_6;
+extern const Aoc_Day aoc_day_7;
+extern const Aoc_Day aoc_day_8;
+extern const Aoc_Day aoc_day_9;
+extern const Aoc_Day aoc_day_10;
+extern const Aoc_Day aoc_day_11;
+extern const Aoc_Day aoc_day_12;
+
+static const Aoc_Day* days[] = {
+    &aoc_day_1, &aoc_day_2, &aoc_day_3, &aoc_day_4, &aoc_day_5, &aoc_day_6,
+    &aoc_day_7, &aoc_day_8, &aoc_day_9, &aoc_day_10, &aoc_day_11, &aoc_day_12,
+};
+
+int main(int argc, char** argv) {
+    if (argc > 1 && strcmp(argv[1], "scale") == 0) {
+        return scale_main(days, ARRAY_LEN(days), argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "diff") == 0) {
+        return diff_main(days, ARRAY_LEN(days), argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "serve") == 0) {
+        return serve_main(days, ARRAY_LEN(days), argc, argv);
+    }
+    if (argc > 1 && strcmp(argv[1], "client") == 0) {
+        return serve_client_main(days, ARRAY_LEN(days), argc, argv);
+    }
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--batch") == 0) return batch_main(days, ARRAY_LEN(days), argc, argv);
+    }
+    return aoc_main(days, ARRAY_LEN(days), argc, argv);
+}
@@ -4,12 +4,20 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
 
+#ifndef AOC_RUNNER
 #define NOB_IMPLEMENTATION
+#endif
 #define NOB_STRIP_PREFIX
 
 #include "../header/nob.h"
+#include "../header/input.h"
+#include "../header/fast_parse.h"
+#include "../header/tokenizer.h"
+#include "../header/arena.h"
+#include "../header/pool.h"
+#include "../header/parallel_parse.h"
+#include "../header/aoc.h"
 
 #define max(a, b) \
     ({ __typeof__ (a) _a = (a); \
@@ -21,165 +29,6 @@
     __typeof__ (b) _b = (b); \
     a < _b ? _a : _b; })
 
-typedef struct {
-    char** items;
-    size_t capacity;
-    size_t count;
-} InputData;
-
-#define LINE_MAX_LEN 100000
-typedef struct {
-    char** items;
-    size_t count;
-    size_t capacity;
-} Strings;
-
-static inline uint64_t ns_now(void) {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
-}
-
-static char* strdup_s(const char* s) {
-    size_t len = strlen(s) + 1;
-    char* p = malloc(len);
-    if (!p) return NULL;
-    memcpy(p, s, len);
-    return p;
-}
-
-void split(Strings* out, const char* text, const char* delimiter) {
-    char* copy = strdup_s(text);
-    if (!copy) {
-        fprintf(stderr, "Failed to allocate memory for copy\n");
-        return;
-    }
-
-    char* token = strtok(copy, delimiter);
-    while (token != NULL) {
-        char* tok_copy = strdup_s(token);
-        if (!tok_copy) {
-            fprintf(stderr, "Failed to allocate memory for token\n");
-            break;  // stop adding more; keep what we have
-        }
-        da_append(out, tok_copy);
-        token = strtok(NULL, delimiter);
-    }
-
-    free(copy);
-}
-
-void remove_spaces(char* str) {
-    char* read = str;
-    char* write = str;
-
-    while (*read) {
-        if (*read != ' ') {  // keep only non-space characters
-            *write = *read;
-            write++;
-        }
-        read++;
-    }
-    *write = '\0';  // null-terminate the cleaned string
-}
-
-InputData* copy_input_data(const InputData* src) {
-    InputData* dest = (InputData*)malloc(sizeof(InputData));
-
-    // Copy metadata
-    dest->capacity = src->capacity;
-    dest->count = src->count;
-
-    // Allocate new array of char*
-    dest->items = malloc(dest->capacity * sizeof(char*));
-    if (!dest->items) {
-        dest->capacity = dest->count = 0;
-        return dest;  // handle alloc failure however you like
-    }
-
-    // Deep-copy each string
-    for (size_t i = 0; i < src->count; i++) {
-        dest->items[i] = strdup(src->items[i]);  // or manual malloc/copy
-        if (!dest->items[i]) {
-            // Clean up partial allocation on failure
-            for (size_t j = 0; j < i; j++) free(dest->items[j]);
-            free(dest->items);
-            dest->items = NULL;
-            dest->capacity = dest->count = 0;
-            return dest;
-        }
-    }
-
-    return dest;
-}
-
-InputData read_lines(const char* filename) {
-    InputData input_data = {0};
-    FILE* fp = fopen(filename, "r");
-
-    if (!fp) return input_data;
-
-    char buffer[LINE_MAX_LEN];
-
-    while (fgets(buffer, LINE_MAX_LEN, fp)) {
-        // Trim newline
-        buffer[strcspn(buffer, "\n")] = '\0';
-
-        da_append(&input_data, nob_temp_strdup(buffer));
-    }
-
-    fclose(fp);
-    return input_data;
-}
-
-void split_into_chunks(InputData* out, const char* text, size_t chunk_size) {
-    size_t len = strlen(text);
-
-    for (size_t i = 0; i < len; i += chunk_size) {
-        size_t remaining = len - i;
-        size_t take = remaining < chunk_size ? remaining : chunk_size;
-
-        char* chunk = malloc(take + 1);
-        memcpy(chunk, text + i, take);
-        chunk[take] = '\0';
-
-        nob_da_append(out, chunk);
-    }
-}
-
-char* extract_segment(const char* text, size_t start_index, size_t end_index) {
-    if (start_index >= end_index)
-        return "";
-
-    size_t segment_size = end_index - start_index;
-
-    char* segment = malloc(segment_size + 1);
-    memcpy(segment, text + start_index, segment_size);
-    segment[segment_size] = '\0';
-
-    return segment;
-}
-
-size_t char_to_int(char x) {
-    return (size_t)(x - '0');
-}
-
-char* concat(const char* a, const char* b) {
-    size_t len = strlen(a) + strlen(b) + 1;
-    char* res = malloc(len);
-    snprintf(res, len, "%s%s", a, b);
-    return res;
-}
-
-int cmp_size_t(const void* a, const void* b) {
-    size_t x = *(const size_t*)a;
-    size_t y = *(const size_t*)b;
-
-    if (x > y) return -1;
-    if (x < y) return 1;
-    return 0;
-}
-
 typedef struct
 {
     size_t* items;
@@ -205,67 +54,65 @@ typedef struct {
     Diagram* items;
     size_t count;
     size_t capacity;
+    Arena arena;  // the button and joltage lists of every machine
 } Diagrams;
 
-size_t diagram_to_value(char* diagram_str) {
-    size_t len = strlen(diagram_str);
-    size_t byte_length = len - 2;
-    size_t value = 0;
-    // Skip first and last letters
-    for (size_t i = 1; i < len - 1; ++i) {
-        char light_value = diagram_str[i];
-        if (light_value == '#') {
-            value += (1 << (byte_length - i));
-        }
-    }
-    return value;
-}
-
-size_t semantic_to_value(char* semantic_str, size_t diagram_len) {
-    size_t len = strlen(semantic_str);
+// The presses are counted over 1 << buttons combinations, the lights are the bits of a size_t
+#define MAX_BUTTONS 30
+#define MAX_LIGHTS 63
 
-    char* new_semantic_str = extract_segment(semantic_str, 1, len - 1);
-
-    len = strlen(new_semantic_str);
-    Strings nums = {0};
-    split(&nums, new_semantic_str, ",");
-    size_t value = 0;
+// The inside of a token wrapped in open and close, false when it is not
+static bool unwrap(String_View token, char open, char close, String_View* inside) {
+    if (token.count < 2 || token.data[0] != open || token.data[token.count - 1] != close) return false;
+    *inside = sv_from_parts(token.data + 1, token.count - 2);
+    return true;
+}
 
-    // Skip first and last letters
-    for (size_t i = 0; i < nums.count; ++i) {
-        char* light_value = nums.items[i];
-        size_t button_number = (size_t)strtoll(nums.items[i], NULL, 10);
-        size_t diff = (diagram_len - button_number);
-        size_t mask_value = (1 << diff);
-        value += mask_value;
+// A list entry of digits only, below limit
+static bool parse_number(String_View num, size_t limit, size_t* value) {
+    if (num.count == 0 || num.count > 18) return false;
+    for (size_t i = 0; i < num.count; ++i) {
+        if (num.data[i] < '0' || num.data[i] > '9') return false;
     }
-
-    free(new_semantic_str);
-    da_free(nums);
-
-    return value;
+    *value = (size_t)sv_to_u64(num);
+    return *value < limit;
 }
 
-size_t dfs(Diagram* d, size_t current_value, size_t target_value, size_t button_pressed, size_t last_index) {
-    if (last_index > d->button_semantics.count) {
-        return INT_FAST16_MAX;
-    }
+// "[.##.]", the first light is the highest bit
+static bool diagram_to_value(String_View diagram_str, size_t* value) {
+    String_View lights;
+    if (!unwrap(diagram_str, '[', ']', &lights) || lights.count == 0 || lights.count > MAX_LIGHTS) return false;
 
-    if (current_value == target_value) {
-        return button_pressed;
+    *value = 0;
+    for (size_t i = 0; i < lights.count; ++i) {
+        char light_value = lights.data[i];
+        if (light_value != '#' && light_value != '.') return false;
+        if (light_value == '#') *value |= (size_t)1 << (lights.count - 1 - i);
     }
+    return true;
+}
 
-    size_t button_semantic = d->button_semantics.items[last_index];
-    size_t hit = dfs(d, current_value ^ button_semantic, target_value, button_pressed + 1, last_index + 1);
-    size_t skip = dfs(d, current_value, target_value, button_pressed, last_index + 1);
-    return min(hit, skip);
+// "(1,3)", the lights the button toggles as a mask in the bit order of the diagram
+static bool semantic_to_value(String_View semantic_str, size_t diagram_len, size_t* value) {
+    String_View nums;
+    if (!unwrap(semantic_str, '(', ')', &nums)) return false;
+
+    Tokenizer tok = tok_chars(nums, ",");
+    String_View num;
+    *value = 0;
+    while (tok_next(&tok, &num)) {
+        size_t button_number = 0;
+        if (!parse_number(num, diagram_len, &button_number)) return false;
+        *value |= (size_t)1 << (diagram_len - 1 - button_number);
+    }
+    return true;
 }
 
-uint64_t check_all_combinations(Diagram* d, size_t current_value, size_t target_value) {
+static uint64_t check_all_combinations(const Diagram* d, size_t target_value) {
     uint64_t min_presses = UINT8_MAX;
-    uint64_t total_combinations = 1 << (d->button_semantics.count - 1);
+    uint64_t total_combinations = (uint64_t)1 << d->button_semantics.count;
 
-    for (uint64_t i = 1; i < (1 << d->button_semantics.count); ++i) {
+    for (uint64_t i = 1; i < total_combinations; ++i) {
         unsigned presses = (unsigned)__builtin_popcountll(i);
 
         if (presses >= min_presses)
@@ -288,85 +135,130 @@ uint64_t check_all_combinations(Diagram* d, size_t current_value, size_t target_
     return min_presses;
 }
 
-uint64_t shortest_combination(Diagram* d) {
+static uint64_t shortest_combination(const Diagram* d) {
     size_t target_value = d->light_diagram;
-    size_t diagram_len = d->light_diagram_len;
-    size_t current_value = 0;
-    // return dfs(d, current_value, target_value, 0, 0);
-    return check_all_combinations(d, current_value, target_value);
+    return check_all_combinations(d, target_value);
 }
 
-uint64_t solve(const InputData* lines) {
-    Diagrams diagrams = {0};
-    for (size_t line_idx = 0; line_idx < lines->count; ++line_idx) {
-        char* line = lines->items[line_idx];
-        printf("%s\n", line);
-
-        Strings out = {0};
-        split(&out, line, " ");
+// "[.##.] (3) (1,3) (2) {3,5,4,7}", the lists go into the arena. False for blank lines and for
+// malformed ones: a token that is not wrapped in its brackets, lights other than '.' and '#', a button
+// of a light that is not there, no buttons or more than MAX_BUTTONS of them.
+static bool parse_machine(String_View line, Arena* arena, Diagram* d) {
+    String_View tokens[MAX_BUTTONS + 2];
+    size_t count = 0;
+    Tokenizer tok = tok_chars(line, " ");
+    String_View token;
+    while (tok_next(&tok, &token)) {
+        if (count == MAX_BUTTONS + 2) return false;
+        tokens[count++] = token;
+    }
+    if (count < 3) return false;
 
-        size_t diagram_len = strlen(out.items[0]) - 2;
-        size_t light_diagram = diagram_to_value(out.items[0]);
+    size_t light_diagram = 0;
+    if (!diagram_to_value(tokens[0], &light_diagram)) return false;
+    size_t diagram_len = tokens[0].count - 2;
 
-        ButtonSemantics button_semantics = {0};
+    size_t button_count = count - 2;
+    size_t* buttons = arena_alloc(arena, button_count * sizeof(size_t));
+    for (size_t i = 0; i < button_count; ++i) {
+        if (!semantic_to_value(tokens[i + 1], diagram_len, &buttons[i])) return false;
+    }
 
-        for (size_t i = 1; i < out.count - 1; ++i) {
-            size_t button_semantic = semantic_to_value(out.items[i], diagram_len - 1);
-            da_append(&button_semantics, button_semantic);
-        }
+    String_View reqs_list;
+    if (!unwrap(tokens[count - 1], '{', '}', &reqs_list)) return false;
+    size_t req_capacity = 1;
+    for (size_t i = 0; i < reqs_list.count; ++i) req_capacity += reqs_list.data[i] == ',';
+    size_t* reqs = arena_alloc(arena, req_capacity * sizeof(size_t));
+    size_t req_count = 0;
+    Tokenizer req_tok = tok_chars(reqs_list, ",");
+    String_View req;
+    while (req_count < req_capacity && tok_next(&req_tok, &req)) {
+        if (!parse_number(req, SIZE_MAX, &reqs[req_count++])) return false;
+    }
 
-        JoltageReqs reqs = {0};
-        char* reqs_str = out.items[out.count - 1];
-        char* new_req_str = extract_segment(reqs_str, 1, strlen(reqs_str) - 1);
-        Strings req_vals = {0};
-        split(&req_vals, new_req_str, ",");
+    *d = (Diagram){
+        light_diagram,
+        diagram_len,
+        (ButtonSemantics){buttons, button_count, button_count},
+        (JoltageReqs){reqs, req_count, req_count},
+    };
+    return true;
+}
 
-        for (size_t i = 0; i < req_vals.count; ++i) {
-            size_t value = (size_t)strtoll(req_vals.items[i], NULL, 10);
-            da_append(&reqs, value);
-        }
+static void free_diagrams(void* state) {
+    Diagrams* diagrams = state;
+    arena_free(&diagrams->arena);
+    da_free(*diagrams);
+    free(diagrams);
+}
 
-        free(new_req_str);
-        da_free(out);
-        da_free(req_vals);
+// Every machine is a record of its own, for parse over the pool and for `aoc --pipeline`, its lists go
+// into the arena of its chunk or batch. A malformed machine fails either.
+static Parse_Result parse_machine_line(String_View line, const void* ctx, Arena* arena, void* record) {
+    (void)ctx;
+    if (sv_trim(line).count == 0) return PARSE_SKIP;
+    if (parse_machine(line, arena, record)) return PARSE_RECORD;
+    nob_log(NOB_ERROR, "Not a machine: " SV_Fmt, SV_Arg(line));
+    return PARSE_BAD;
+}
 
-        Diagram d = (Diagram){light_diagram, diagram_len, button_semantics, reqs};
-        da_append(&diagrams, d);
+static void* parse(const Lines* lines) {
+    Diagrams* diagrams = calloc(1, sizeof(Diagrams));
+    diagrams->arena.block_size = 64 * 1024;
+    bool failed = false;
+    diagrams->items = parallel_parse_lines(lines->text, sizeof(Diagram), parse_machine_line, NULL, &diagrams->arena,
+                                           &diagrams->count, &failed);
+    diagrams->capacity = diagrams->count;
+    if (failed) {
+        free_diagrams(diagrams);
+        return NULL;
     }
+    return diagrams;
+}
+
+// The serial sum, kept as the reference of the parallel one below
+static uint64_t solve_reference(const void* state) {
+    const Diagrams* diagrams = state;
 
     uint64_t total = 0;
-    uint64_t total_time_taken = 0;
-    for (int i = 0; i < 2; ++i) {
-        uint64_t start = ns_now();
-        total = 0;
-        for (size_t idx = 0; idx < diagrams.count; ++idx) {
-            uint64_t current_shortest = shortest_combination(&diagrams.items[idx]);
-            total += current_shortest;
-        }
-        uint64_t end = ns_now();
-        total_time_taken += (end - start);
+    for (size_t idx = 0; idx < diagrams->count; ++idx) {
+        uint64_t current_shortest = shortest_combination(&diagrams->items[idx]);
+        total += current_shortest;
     }
 
-    da_free(diagrams);
-    for (size_t idx = 0; idx < diagrams.count; ++idx) {
-        da_free(diagrams.items[idx].button_semantics);
-        da_free(diagrams.items[idx].joltage_requirements);
+    return total;
+}
+
+static void sum_machines(size_t begin, size_t end, Pool_Worker* worker, void* ctx, void* partial) {
+    (void)worker;
+    const Diagrams* diagrams = ctx;
+    uint64_t* total = partial;
+
+    for (size_t idx = begin; idx < end; ++idx) {
+        *total += shortest_combination(&diagrams->items[idx]);
     }
+}
+
+// Every machine is searched on its own, 2^buttons combinations each
+static uint64_t solve(const void* state) {
+    const Diagrams* diagrams = state;
 
-    printf("Average Elapsed Time (ns) : %lu\n", total_time_taken / 2);
+    uint64_t total = 0;
+    parallel_reduce(0, diagrams->count, 1, &total, sizeof(total), sum_machines, pool_sum_u64, (void*)diagrams);
     return total;
 }
 
-uint64_t solve_part_2(const InputData* diagrams) {
+static void solve_machine(const void* record, const void* shared, uint64_t answers[2]) {
+    (void)shared;
+    answers[0] += shortest_combination(record);
 }
 
-int main() {
-    char* input_file = "inputs/q10_input.txt";
-
-    InputData input_lines = read_lines(input_file);
+static const Pipeline_Stream stream = {
+    .record_size = sizeof(Diagram),
+    .parse = parse_machine_line,
+    .solve = solve_machine,
+};
 
-    uint64_t password = solve(&input_lines);
-    // uint64_t password = solve_part_2(&input_lines);
-    printf("Password : %" PRIu64 "\n", password);
-    return 0;
-}
\ No newline at end of file
+AOC_DAY(10, .name = "Factory", .input_path = "inputs/q10_input.txt",
+        .parse = parse, .part_1 = solve, .free = free_diagrams,
+        .reference_1 = solve_reference, .stream = &stream, .text_only = true)
@@ -4,12 +4,16 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
 
+#ifndef AOC_RUNNER
 #define NOB_IMPLEMENTATION
+#endif
 #define NOB_STRIP_PREFIX
 
 #include "../header/nob.h"
+#include "../header/input.h"
+#include "../header/tokenizer.h"
+#include "../header/aoc.h"
 #include "../header/std_ds.h"
 
 #define max(a, b) \
@@ -22,188 +26,86 @@
     __typeof__ (b) _b = (b); \
     a < _b ? _a : _b; })
 
-typedef struct {
-    char** items;
-    size_t capacity;
-    size_t count;
-} InputData;
-
-#define LINE_MAX_LEN 100000
 typedef struct {
     char** items;
     size_t count;
     size_t capacity;
 } Strings;
 
-static inline uint64_t ns_now(void) {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
-}
+typedef struct {
+    char* key;
+    Strings value;
+} Graph;
 
-static char* strdup_s(const char* s) {
-    size_t len = strlen(s) + 1;
-    char* p = malloc(len);
-    if (!p) return NULL;
-    memcpy(p, s, len);
-    return p;
-}
+typedef struct {
+    char* key;
+    bool value;
+} Visited;
 
-void split(Strings* out, const char* text, const char* delimiter) {
-    char* copy = strdup_s(text);
-    if (!copy) {
-        fprintf(stderr, "Failed to allocate memory for copy\n");
-        return;
-    }
+typedef struct {
+    char* key;
+    uint64_t value;
+} DiscoveredPaths;
 
-    char* token = strtok(copy, delimiter);
-    while (token != NULL) {
-        char* tok_copy = strdup_s(token);
-        if (!tok_copy) {
-            fprintf(stderr, "Failed to allocate memory for token\n");
-            break;  // stop adding more; keep what we have
-        }
-        da_append(out, tok_copy);
-        token = strtok(NULL, delimiter);
+typedef struct {
+    char* key;
+    bool value;
+} Names;
+
+// Node names are copied once into the string arena of names, the graph keys and the output lists
+// all point at those copies instead of owning a malloc'd string per token.
+static char* intern_name(Names** names, String_View name) {
+    // The lookup key is a stack copy, nob's temp storage is shared by all threads of `aoc --batch`
+    char stack_key[64];
+    char* key = name.count < sizeof(stack_key) ? stack_key : malloc(name.count + 1);
+    memcpy(key, name.data, name.count);
+    key[name.count] = '\0';
+
+    ptrdiff_t index = shgeti(*names, key);
+    if (index == -1) {
+        shput(*names, key, true);
+        index = shgeti(*names, key);
     }
 
-    free(copy);
+    if (key != stack_key) free(key);
+    return (*names)[index].key;
 }
 
-void remove_spaces(char* str) {
-    char* read = str;
-    char* write = str;
+static Graph* read_graph(const Lines* lines, Names** names) {
+    Graph* graph = NULL;
+    Tokens out = {0};
 
-    while (*read) {
-        if (*read != ' ') {  // keep only non-space characters
-            *write = *read;
-            write++;
-        }
-        read++;
-    }
-    *write = '\0';  // null-terminate the cleaned string
-}
+    sh_new_arena(*names);
 
-InputData* copy_input_data(const InputData* src) {
-    InputData* dest = (InputData*)malloc(sizeof(InputData));
+    for (size_t line_idx = 0; line_idx < lines->count; ++line_idx) {
+        String_View line = lines->items[line_idx];
 
-    // Copy metadata
-    dest->capacity = src->capacity;
-    dest->count = src->count;
+        out.count = 0;
+        tok_collect(tok_chars(line, " "), &out);
 
-    // Allocate new array of char*
-    dest->items = malloc(dest->capacity * sizeof(char*));
-    if (!dest->items) {
-        dest->capacity = dest->count = 0;
-        return dest;  // handle alloc failure however you like
-    }
+        // Drop the ':' after the input node
+        String_View input = out.items[0];
+        char* node = intern_name(names, sv_from_parts(input.data, input.count - 1));
 
-    // Deep-copy each string
-    for (size_t i = 0; i < src->count; i++) {
-        dest->items[i] = strdup(src->items[i]);  // or manual malloc/copy
-        if (!dest->items[i]) {
-            // Clean up partial allocation on failure
-            for (size_t j = 0; j < i; j++) free(dest->items[j]);
-            free(dest->items);
-            dest->items = NULL;
-            dest->capacity = dest->count = 0;
-            return dest;
+        Strings outputs = {0};
+        for (size_t idx = 1; idx < out.count; ++idx) {
+            da_append(&outputs, intern_name(names, out.items[idx]));
         }
-    }
-
-    return dest;
-}
-
-InputData read_lines(const char* filename) {
-    InputData input_data = {0};
-    FILE* fp = fopen(filename, "r");
-
-    if (!fp) return input_data;
-
-    char buffer[LINE_MAX_LEN];
-
-    while (fgets(buffer, LINE_MAX_LEN, fp)) {
-        // Trim newline
-        buffer[strcspn(buffer, "\n")] = '\0';
-
-        da_append(&input_data, nob_temp_strdup(buffer));
-    }
-
-    fclose(fp);
-    return input_data;
-}
-
-void split_into_chunks(InputData* out, const char* text, size_t chunk_size) {
-    size_t len = strlen(text);
-
-    for (size_t i = 0; i < len; i += chunk_size) {
-        size_t remaining = len - i;
-        size_t take = remaining < chunk_size ? remaining : chunk_size;
-
-        char* chunk = malloc(take + 1);
-        memcpy(chunk, text + i, take);
-        chunk[take] = '\0';
 
-        nob_da_append(out, chunk);
+        shput(graph, node, outputs);
     }
-}
-
-char* extract_segment(const char* text, size_t start_index, size_t end_index) {
-    if (start_index >= end_index)
-        return "";
-
-    size_t segment_size = end_index - start_index;
 
-    char* segment = malloc(segment_size + 1);
-    memcpy(segment, text + start_index, segment_size);
-    segment[segment_size] = '\0';
-
-    return segment;
-}
-
-size_t char_to_int(char x) {
-    return (size_t)(x - '0');
+    da_free(out);
+    return graph;
 }
 
-char* concat(const char* a, const char* b) {
-    size_t len = strlen(a) + strlen(b) + 1;
-    char* res = malloc(len);
-    snprintf(res, len, "%s%s", a, b);
-    return res;
-}
-
-int cmp_size_t(const void* a, const void* b) {
-    size_t x = *(const size_t*)a;
-    size_t y = *(const size_t*)b;
-
-    if (x > y) return -1;
-    if (x < y) return 1;
-    return 0;
-}
-
-typedef struct {
-    char* key;
-    Strings value;
-} Graph;
-
-typedef struct {
-    char* key;
-    bool value;
-} Visited;
-
-typedef struct {
-    char* key;
-    uint64_t value;
-} DiscoveredPaths;
-
-uint64_t dfs(const Graph* graph, char* next) {
+// Not const, stb_ds lookups leave their result in the header of the table
+static uint64_t dfs(Graph* graph, char* next) {
     if (strcmp(next, "out") == 0) {
         return 1;
     }
 
     uint64_t total = 0;
-    // printf("Next Node : %s\n", next);
-
     Strings outputs = shget(graph, next);
     for (size_t idx = 0; idx < outputs.count; ++idx) {
         total += dfs(graph, outputs.items[idx]);
@@ -211,45 +113,125 @@ uint64_t dfs(const Graph* graph, char* next) {
     return total;
 }
 
-uint64_t solve(const InputData* lines) {
-    Graph* graph = NULL;
-
-    char* start;
+typedef struct {
+    Names* names;  // owns every node name, the graph only points at them
+    Graph* graph;
+} Reactor;
+
+static void* parse(const Lines* lines) {
+    Reactor* reactor = calloc(1, sizeof(Reactor));
+    reactor->graph = read_graph(lines, &reactor->names);
+    return reactor;
+}
 
-    for (size_t line_idx = 0; line_idx < lines->count; ++line_idx) {
-        char* line = lines->items[line_idx];
-        printf("%s\n", line);
+static void free_reactor(void* state) {
+    Reactor* reactor = state;
+    for (ptrdiff_t i = 0; i < shlen(reactor->graph); ++i) {
+        da_free(reactor->graph[i].value);
+    }
+    MAP_STATS("graph", reactor->graph);
+    MAP_STATS("names", reactor->names);
+    shfree(reactor->graph);
+    shfree(reactor->names);
+    free(reactor);
+}
 
-        Strings out = {0};
-        split(&out, line, " ");
+// The names as NUL terminated strings in interning order, then the graph in CSR form: the name index
+// of every node, where its outputs start and the name indices of all the outputs
+static void save_reactor(const void* state, Snapshot_Writer* out) {
+    const Reactor* reactor = state;
+    Names* names = reactor->names;
+    Graph* graph = reactor->graph;
+
+    Nob_String_Builder text = {0};
+    for (ptrdiff_t i = 0; i < shlen(names); ++i) {
+        sb_append_cstr(&text, names[i].key);
+        sb_append_null(&text);
+    }
 
-        char* input = out.items[0];
+    size_t node_count = (size_t)shlen(graph);
+    uint32_t* nodes = malloc(node_count * sizeof(uint32_t) + 1);
+    uint32_t* offsets = malloc((node_count + 1) * sizeof(uint32_t));
+    struct {
+        uint32_t* items;
+        size_t count;
+        size_t capacity;
+    } targets = {0};
+
+    for (size_t i = 0; i < node_count; ++i) {
+        nodes[i] = (uint32_t)shgeti(names, graph[i].key);
+        offsets[i] = (uint32_t)targets.count;
+        for (size_t j = 0; j < graph[i].value.count; ++j) {
+            da_append(&targets, (uint32_t)shgeti(names, graph[i].value.items[j]));
+        }
+    }
+    offsets[node_count] = (uint32_t)targets.count;
+
+    snapshot_add(out, text.items, text.count);
+    snapshot_add(out, nodes, node_count * sizeof(uint32_t));
+    snapshot_add(out, offsets, (node_count + 1) * sizeof(uint32_t));
+    snapshot_add(out, targets.items, targets.count * sizeof(uint32_t));
+    sb_free(text);
+    free(nodes);
+    free(offsets);
+    da_free(targets);
+}
 
-        input = extract_segment(input, 0, strlen(input) - 1);
+// Both maps are rebuilt from the indices, one insertion per name and node instead of a lookup per token
+static void* restore_reactor(const Snapshot* snapshot) {
+    size_t text_size = 0, node_count = 0, offset_count = 0, target_count = 0;
+    const char* text = snapshot_items(snapshot, 0, 1, &text_size);
+    const uint32_t* nodes = snapshot_items(snapshot, 1, sizeof(uint32_t), &node_count);
+    const uint32_t* offsets = snapshot_items(snapshot, 2, sizeof(uint32_t), &offset_count);
+    const uint32_t* targets = snapshot_items(snapshot, 3, sizeof(uint32_t), &target_count);
+    if (text == NULL || nodes == NULL || offsets == NULL || targets == NULL || text_size == 0 ||
+        text[text_size - 1] != '\0' || offset_count != node_count + 1 || offsets[node_count] != target_count) {
+        return NULL;
+    }
 
-        if (strcmp(input, "you") == 0) {
-            start = input;
-        }
+    Reactor* reactor = calloc(1, sizeof(Reactor));
+    sh_new_arena(reactor->names);
+    Strings interned = {0};
+    for (const char* name = text; name < text + text_size; name += strlen(name) + 1) {
+        shput(reactor->names, name, true);
+        da_append(&interned, reactor->names[shgeti(reactor->names, name)].key);
+    }
 
+    bool ok = true;
+    for (size_t i = 0; i < node_count && ok; ++i) {
+        ok = nodes[i] < interned.count && offsets[i] <= offsets[i + 1];
         Strings outputs = {0};
-        for (size_t idx = 1; idx < out.count; ++idx) {
-            da_append(&outputs, out.items[idx]);
+        for (uint32_t j = offsets[i]; ok && j < offsets[i + 1]; ++j) {
+            ok = targets[j] < interned.count;
+            if (ok) da_append(&outputs, interned.items[targets[j]]);
         }
+        if (ok) {
+            shput(reactor->graph, interned.items[nodes[i]], outputs);
+        } else {
+            da_free(outputs);
+        }
+    }
+    da_free(interned);
 
-        shput(graph, input, outputs);
+    if (!ok) {
+        free_reactor(reactor);
+        return NULL;
     }
+    return reactor;
+}
 
-    printf("-------------------------\n");
-    uint64_t total_ways = dfs(graph, "you");
+static uint64_t solve(const void* state) {
+    const Reactor* reactor = state;
+    uint64_t total_ways = dfs(reactor->graph, "you");
     return total_ways;
 }
 
-uint64_t dfs_v2(const Graph* graph, char* next, char* target, Visited** visited, DiscoveredPaths** discovered_paths) {
+static uint64_t dfs_v2(Graph* graph, char* next, char* target, Visited** visited, DiscoveredPaths** discovered_paths) {
     /*
     DFS with a lot of book keeping. Fast enough. Open to improvements.
     */
     if (strcmp(next, target) == 0) {
-        shdel(*visited, next);
+        (void)shdel(*visited, next);
         return 1;
     }
 
@@ -258,11 +240,6 @@ uint64_t dfs_v2(const Graph* graph, char* next, char* target, Visited** visited,
         return 0;
     }
 
-    // // Visited nodes? Do we need it?
-    // if (shgeti(*visited, next) != -1) {
-    //     return 0;
-    // }
-
     // If we have found this node, we know that there is only discovered amount of ways.
     // Whatever we put inside of this list will never be visited it will help us to build the DP.
     if (shgeti(*discovered_paths, next) != -1) {
@@ -284,7 +261,7 @@ uint64_t dfs_v2(const Graph* graph, char* next, char* target, Visited** visited,
     }
 
     // Release this node so it can be visited again
-    shdel(*visited, next);
+    (void)shdel(*visited, next);
 
     // DP part of the solution, memorize the number of paths up to here
     shput(*discovered_paths, next, total);
@@ -292,85 +269,57 @@ uint64_t dfs_v2(const Graph* graph, char* next, char* target, Visited** visited,
     return total;
 }
 
-uint64_t solve_part_2(const InputData* lines) {
-    Graph* graph = NULL;
-
-    char* start;
-
-    for (size_t line_idx = 0; line_idx < lines->count; ++line_idx) {
-        char* line = lines->items[line_idx];
-        printf("%s\n", line);
-
-        Strings out = {0};
-        split(&out, line, " ");
-
-        char* input = out.items[0];
-
-        input = extract_segment(input, 0, strlen(input) - 1);
-
-        if (strcmp(input, "you") == 0) {
-            start = input;
-        }
-
-        Strings outputs = {0};
-        for (size_t idx = 1; idx < out.count; ++idx) {
-            da_append(&outputs, out.items[idx]);
-        }
+// Every leg starts over with empty maps
+static void release_leg(Visited** visited, DiscoveredPaths** discovered_paths) {
+    MAP_STATS("visited", *visited);
+    MAP_STATS("discovered paths", *discovered_paths);
+    shfree(*visited);
+    shfree(*discovered_paths);
+}
 
-        shput(graph, input, outputs);
-    }
+static uint64_t solve_part_2(const void* state) {
+    Graph* graph = ((const Reactor*)state)->graph;
 
     Visited* visited = NULL;
     DiscoveredPaths* discovered_paths = NULL;
 
     // Learned this brilliant division trick from https://www.reddit.com/user/mine49er/
     // SVR->DAC->FFT->OUT + SVR->FFT->DAC->OUT
-    printf("-------------------------\n");
+    TRACE_BEGIN("svr->dac");
     uint64_t total_ways_path_1 = dfs_v2(graph, "svr", "dac", &visited, &discovered_paths);
-    shfree(visited);
-    shfree(discovered_paths);
-    printf("SVR -> DAC DONE\n");
+    TRACE_END();
+    release_leg(&visited, &discovered_paths);
 
+    TRACE_BEGIN("dac->fft");
     total_ways_path_1 *= dfs_v2(graph, "dac", "fft", &visited, &discovered_paths);
-    shfree(visited);
-    shfree(discovered_paths);
-    printf("DAC -> FFT DONE\n");
+    TRACE_END();
+    release_leg(&visited, &discovered_paths);
 
+    TRACE_BEGIN("fft->out");
     total_ways_path_1 *= dfs_v2(graph, "fft", "out", &visited, &discovered_paths);
-    shfree(visited);
-    shfree(discovered_paths);
-    printf("FFT -> OUT DONE\n");
+    TRACE_END();
+    release_leg(&visited, &discovered_paths);
 
+    TRACE_BEGIN("svr->fft");
     uint64_t total_ways_path_2 = dfs_v2(graph, "svr", "fft", &visited, &discovered_paths);
-    shfree(visited);
-    shfree(discovered_paths);
-    printf("SVR -> FFT DONE\n");
+    TRACE_END();
+    release_leg(&visited, &discovered_paths);
 
+    TRACE_BEGIN("fft->dac");
     total_ways_path_2 *= dfs_v2(graph, "fft", "dac", &visited, &discovered_paths);
-    shfree(visited);
-    shfree(discovered_paths);
-    printf("FFT -> DAC DONE\n");
+    TRACE_END();
+    release_leg(&visited, &discovered_paths);
 
+    TRACE_BEGIN("dac->out");
     total_ways_path_2 *= dfs_v2(graph, "dac", "out", &visited, &discovered_paths);
-    shfree(visited);
-    shfree(discovered_paths);
-    printf("DAC -> OUT DONE\n");
+    TRACE_END();
+    release_leg(&visited, &discovered_paths);
 
     uint64_t total_ways = total_ways_path_1 + total_ways_path_2;
 
     return total_ways;
 }
 
-int main() {
-    char* input_file = "inputs/q11_input.txt";
-
-    InputData input_lines = read_lines(input_file);
-
-    uint64_t password = solve(&input_lines);
-    uint64_t password = solve_part_2(&input_lines);
-    printf("Password : %" PRIu64 "\n", password);
-
-    da_free(input_lines);
-
-    return 0;
-}
\ No newline at end of file
+AOC_DAY(11, .name = "Reactor", .input_path = "inputs/q11_input.txt",
+        .parse = parse, .part_1 = solve, .part_2 = solve_part_2, .free = free_reactor,
+        .save = save_reactor, .restore = restore_reactor, .free_restored = free_reactor)
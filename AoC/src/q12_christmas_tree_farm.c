@@ -4,12 +4,17 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include <time.h>
 
+#ifndef AOC_RUNNER
 #define NOB_IMPLEMENTATION
+#endif
 #define NOB_STRIP_PREFIX
 
 #include "../header/nob.h"
+#include "../header/input.h"
+#include "../header/fast_parse.h"
+#include "../header/tokenizer.h"
+#include "../header/aoc.h"
 #include "../header/std_ds.h"
 
 #define max(a, b) \
@@ -23,269 +28,142 @@
     a < _b ? _a : _b; })
 
 typedef struct {
-    char** items;
-    size_t capacity;
-    size_t count;
-} InputData;
-
-#define LINE_MAX_LEN 100000
-typedef struct {
-    char** items;
+    uint8_t* items;
     size_t count;
     size_t capacity;
-} Strings;
-
-static inline uint64_t ns_now(void) {
-    struct timespec ts;
-    clock_gettime(CLOCK_MONOTONIC, &ts);
-    return (uint64_t)ts.tv_sec * 1000000000ull + ts.tv_nsec;
-}
-
-static char* strdup_s(const char* s) {
-    size_t len = strlen(s) + 1;
-    char* p = malloc(len);
-    if (!p) return NULL;
-    memcpy(p, s, len);
-    return p;
-}
-
-void split(Strings* out, const char* text, const char* delimiter) {
-    char* copy = strdup_s(text);
-    if (!copy) {
-        fprintf(stderr, "Failed to allocate memory for copy\n");
-        return;
-    }
-
-    char* token = strtok(copy, delimiter);
-    while (token != NULL) {
-        char* tok_copy = strdup_s(token);
-        if (!tok_copy) {
-            fprintf(stderr, "Failed to allocate memory for token\n");
-            break;  // stop adding more; keep what we have
-        }
-        da_append(out, tok_copy);
-        token = strtok(NULL, delimiter);
-    }
-
-    free(copy);
-}
-
-void remove_spaces(char* str) {
-    char* read = str;
-    char* write = str;
+} Gifts;
 
-    while (*read) {
-        if (*read != ' ') {  // keep only non-space characters
-            *write = *read;
-            write++;
-        }
-        read++;
-    }
-    *write = '\0';  // null-terminate the cleaned string
-}
+// The input starts with 6 gift shapes of 5 lines each ("0:" and a 3x3 grid), the regions follow
+#define GIFT_SHAPE_COUNT 6
+#define GIFT_SHAPE_LINES 5
 
-InputData* copy_input_data(const InputData* src) {
-    InputData* dest = (InputData*)malloc(sizeof(InputData));
+typedef struct {
+    uint16_t row;
+    uint16_t col;
+    uint16_t requests[GIFT_SHAPE_COUNT];  // how many of each gift has to fit
+} Region;
 
-    // Copy metadata
-    dest->capacity = src->capacity;
-    dest->count = src->count;
+typedef struct {
+    Region* items;
+    size_t count;
+    size_t capacity;
+} Regions;
 
-    // Allocate new array of char*
-    dest->items = malloc(dest->capacity * sizeof(char*));
-    if (!dest->items) {
-        dest->capacity = dest->count = 0;
-        return dest;  // handle alloc failure however you like
-    }
+typedef struct {
+    Gifts gifts;  // filled tiles of every gift shape
+    Regions regions;
+} Farm;
 
-    // Deep-copy each string
-    for (size_t i = 0; i < src->count; i++) {
-        dest->items[i] = strdup(src->items[i]);  // or manual malloc/copy
-        if (!dest->items[i]) {
-            // Clean up partial allocation on failure
-            for (size_t j = 0; j < i; j++) free(dest->items[j]);
-            free(dest->items);
-            dest->items = NULL;
-            dest->capacity = dest->count = 0;
-            return dest;
+static void parse_gifts(const Lines* lines, Gifts* gifts) {
+    size_t regions_start = GIFT_SHAPE_COUNT * GIFT_SHAPE_LINES;
+    for (size_t idx = 0; idx < regions_start; idx += GIFT_SHAPE_LINES) {
+        uint8_t total_filled_tiles = 0;
+        for (size_t gift_offset = 1; gift_offset <= 3; ++gift_offset) {
+            String_View gift_line = lines->items[idx + gift_offset];
+            for (size_t tid = 0; tid < gift_line.count; ++tid) {
+                if (gift_line.data[tid] == '#') {
+                    total_filled_tiles++;
+                }
+            }
         }
+        da_append(gifts, total_filled_tiles);
     }
-
-    return dest;
 }
 
-InputData read_lines(const char* filename) {
-    InputData input_data = {0};
-    FILE* fp = fopen(filename, "r");
+// "41x37: 1 0 2 ..." is a 41 by 37 region and the gift counts, false for lines without tokens
+static bool parse_region(String_View line, Region* region) {
+    Tokenizer tok = tok_chars(line, " ");
+    String_View size_str, request;
+    if (!tok_next(&tok, &size_str)) return false;
 
-    if (!fp) return input_data;
+    // "41x37:" -> 41 and 37
+    String_View grid_size = sv_from_parts(size_str.data, size_str.count - 1);
+    String_View row_str = sv_chop_by_delim(&grid_size, 'x');
 
-    char buffer[LINE_MAX_LEN];
+    *region = (Region){0};
+    region->row = (uint16_t)sv_to_i64(row_str);
+    region->col = (uint16_t)sv_to_i64(grid_size);
 
-    while (fgets(buffer, LINE_MAX_LEN, fp)) {
-        // Trim newline
-        buffer[strcspn(buffer, "\n")] = '\0';
-
-        da_append(&input_data, nob_temp_strdup(buffer));
+    for (size_t req_idx = 0; req_idx < GIFT_SHAPE_COUNT && tok_next(&tok, &request); ++req_idx) {
+        region->requests[req_idx] = (uint16_t)sv_to_i64(request);
     }
-
-    fclose(fp);
-    return input_data;
+    return true;
 }
 
-void split_into_chunks(InputData* out, const char* text, size_t chunk_size) {
-    size_t len = strlen(text);
+static void* parse(const Lines* lines) {
+    size_t regions_start = GIFT_SHAPE_COUNT * GIFT_SHAPE_LINES;
+    if (lines->count < regions_start) return NULL;
 
-    for (size_t i = 0; i < len; i += chunk_size) {
-        size_t remaining = len - i;
-        size_t take = remaining < chunk_size ? remaining : chunk_size;
+    Farm* farm = calloc(1, sizeof(Farm));
+    parse_gifts(lines, &farm->gifts);
 
-        char* chunk = malloc(take + 1);
-        memcpy(chunk, text + i, take);
-        chunk[take] = '\0';
-
-        nob_da_append(out, chunk);
+    for (size_t idx = regions_start; idx < lines->count; ++idx) {
+        Region region;
+        if (parse_region(lines->items[idx], &region)) da_append(&farm->regions, region);
     }
-}
-
-char* extract_segment(const char* text, size_t start_index, size_t end_index) {
-    if (start_index >= end_index)
-        return "";
-
-    size_t segment_size = end_index - start_index;
-
-    char* segment = malloc(segment_size + 1);
-    memcpy(segment, text + start_index, segment_size);
-    segment[segment_size] = '\0';
 
-    return segment;
+    return farm;
 }
 
-size_t char_to_int(char x) {
-    return (size_t)(x - '0');
+static void free_farm(void* state) {
+    Farm* farm = state;
+    da_free(farm->gifts);
+    da_free(farm->regions);
+    free(farm);
 }
 
-char* concat(const char* a, const char* b) {
-    size_t len = strlen(a) + strlen(b) + 1;
-    char* res = malloc(len);
-    snprintf(res, len, "%s%s", a, b);
-    return res;
-}
-
-int cmp_size_t(const void* a, const void* b) {
-    size_t x = *(const size_t*)a;
-    size_t y = *(const size_t*)b;
-
-    if (x > y) return -1;
-    if (x < y) return 1;
-    return 0;
-}
-
-typedef struct {
-    char* key;
-    Strings value;
-} Graph;
-
-typedef struct {
-    char* key;
-    bool value;
-} Visited;
-
-typedef struct {
-    char* key;
-    uint64_t value;
-} DiscoveredPaths;
-
-uint64_t dfs(const Graph* graph, char* next) {
-    if (strcmp(next, "out") == 0) {
-        return 1;
+static bool region_fits(const Gifts* gifts, const Region* region) {
+    uint32_t total_occupied_area = 0;
+    for (size_t req_idx = 0; req_idx < GIFT_SHAPE_COUNT; ++req_idx) {
+        uint16_t req_count = region->requests[req_idx];
+        if (req_count > 0) {
+            total_occupied_area += req_count * gifts->items[req_idx];
+        }
     }
 
-    uint64_t total = 0;
-    // printf("Next Node : %s\n", next);
-
-    Strings outputs = shget(graph, next);
-    for (size_t idx = 0; idx < outputs.count; ++idx) {
-        total += dfs(graph, outputs.items[idx]);
-    }
-    return total;
+    return total_occupied_area < (uint32_t)(region->row * region->col);
 }
 
-typedef struct {
-    uint8_t* items;
-    size_t count;
-    size_t capacity;
-} Gifts;
-
-uint64_t solve(const InputData* lines) {
+static uint64_t solve(const void* state) {
     // Disgusting hueristic approach works for general use cases for AoC does it solve the real problem? NO! Is real problem easy? FUCK NO! It is np-hard.
-    Gifts gifts = {0};
-    for (size_t idx = 0; idx < 30; idx += 5) {
-        uint8_t total_filled_tiles = 0;
-        for (size_t gift_offset = 1; gift_offset <= 3; ++gift_offset) {
-            char* gift_line = lines->items[idx + gift_offset];
-            printf("%s\n", gift_line);
-            for (size_t tid = 0; tid < strlen(gift_line); ++gift_line) {
-                if (gift_line[tid] == '#') {
-                    total_filled_tiles++;
-                }
-            }
-        }
-        da_append(&gifts, total_filled_tiles);
-    }
-
+    const Farm* farm = state;
     uint64_t valid_map_count = 0;
 
-    for (size_t idx = 30; idx < lines->count; ++idx) {
-        char* line = lines->items[idx];
-
-        Strings out = {0};
-        split(&out, line, " ");
-
-        char* grid_size = out.items[0];
-        char* new_grid_size = extract_segment(grid_size, 0, strlen(grid_size) - 1);
-
-        Strings grid_size_out = {0};
-        split(&grid_size_out, new_grid_size, "x");
-
-        uint16_t row = (uint16_t)strtoll(grid_size_out.items[0], NULL, 10);
-        uint16_t col = (uint16_t)strtoll(grid_size_out.items[1], NULL, 10);
-
-        uint32_t total_occupied_area = 0;
-        for (size_t req_idx = 1; req_idx < out.count; ++req_idx) {
-            uint16_t req_count = (uint16_t)strtoll(out.items[req_idx], NULL, 10);
-            printf("%d ", req_count);
-            if (req_count > 0) {
-                total_occupied_area += req_count * gifts.items[req_idx - 1];
-            }
-        }
-        printf("\n");
-
-        if (total_occupied_area < (row * col)) {
-            printf("Valid Total Occupied area : %lu \n", total_occupied_area);
+    for (size_t idx = 0; idx < farm->regions.count; ++idx) {
+        if (region_fits(&farm->gifts, &farm->regions.items[idx])) {
             valid_map_count++;
         }
-
-        da_free(grid_size_out);
     }
 
-    da_free(gifts);
-
     return valid_map_count;
 }
 
-uint64_t solve_part_2(const InputData* lines) {
+// For `aoc --pipeline` the gift shapes are the header every region is checked against
+static void* parse_shapes(const Lines* lines) {
+    if (lines->count < GIFT_SHAPE_COUNT * GIFT_SHAPE_LINES) return NULL;
+    Farm* farm = calloc(1, sizeof(Farm));
+    parse_gifts(lines, &farm->gifts);
+    return farm;
 }
 
-int main() {
-    char* input_file = "inputs/q12_input.txt";
+static Parse_Result parse_region_record(String_View line, const void* shared, Arena* arena, void* record) {
+    (void)shared;
+    (void)arena;
+    return parse_region(line, record) ? PARSE_RECORD : PARSE_SKIP;
+}
 
-    InputData input_lines = read_lines(input_file);
+static void solve_region(const void* record, const void* shared, uint64_t answers[2]) {
+    answers[0] += region_fits(&((const Farm*)shared)->gifts, record);
+}
 
-    uint64_t password = solve(&input_lines);
-    uint64_t password = solve_part_2(&input_lines);
-    printf("Password : %" PRIu64 "\n", password);
-    
-    da_free(input_lines);
-    return 0;
-}
\ No newline at end of file
+static const Pipeline_Stream stream = {
+    .record_size = sizeof(Region),
+    .header_lines = GIFT_SHAPE_COUNT * GIFT_SHAPE_LINES,
+    .header = parse_shapes,
+    .free_header = free_farm,
+    .parse = parse_region_record,
+    .solve = solve_region,
+};
+
+AOC_DAY(12, .name = "Christmas Tree Farm", .input_path = "inputs/q12_input.txt",
+        .parse = parse, .part_1 = solve, .free = free_farm, .stream = &stream)
@@ -3,109 +3,121 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef AOC_RUNNER
 #define NOB_IMPLEMENTATION
+#endif
 #define NOB_STRIP_PREFIX
 
 #include "../header/nob.h"
+#include "../header/input.h"
+#include "../header/fast_parse.h"
+#include "../header/aoc.h"
 
+// Rotations are stored signed, right turns positive and left turns negative
 typedef struct {
-    char** items;
-    size_t capacity;
+    int* items;
     size_t count;
-} InputData;
-
-#define LINE_MAX_LEN 1024
+    size_t capacity;
+} Rotations;
 
-InputData read_lines(const char* filename) {
-    InputData input_data = {0};
-    FILE* fp = fopen(filename, "r");
+// False for lines that hold no rotation
+static bool parse_rotation(String_View dial, int* rotation) {
+    if (dial.count < 2) return false;
 
-    if (!fp) return input_data;
+    int dial_value = (int)sv_to_i64(sv_from_parts(dial.data + 1, dial.count - 1));
+    *rotation = dial.data[0] == 'R' ? dial_value : -dial_value;
+    return true;
+}
 
-    char buffer[LINE_MAX_LEN];
+static void* parse(const Lines* lines) {
+    Rotations* rotations = calloc(1, sizeof(Rotations));
 
-    while (fgets(buffer, LINE_MAX_LEN, fp)) {
-        // Trim newline
-        buffer[strcspn(buffer, "\n")] = '\0';
-        da_append(&input_data, nob_temp_strdup(buffer));
+    for (size_t i = 0; i < lines->count; ++i) {
+        int rotation = 0;
+        if (parse_rotation(lines->items[i], &rotation)) da_append(rotations, rotation);
     }
 
-    fclose(fp);
-    return input_data;
+    return rotations;
 }
 
-int solve(InputData dials) {
-    int current_dial = 50;
-    int click = 0;
+static void free_rotations(void* state) {
+    Rotations* rotations = state;
+    da_free(*rotations);
+    free(rotations);
+}
 
-    for (size_t i = 0; i < dials.count; ++i) {
-        char* dial = dials.items[i];
-        char dial_type = dial[0];
-        char* dial_value_str = dial + 1;
-        int dial_value = atoi(dial_value_str);
+// Clicks of part 1, 1 when the dial stops at 0
+static int turn(int* current_dial, int rotation) {
+    *current_dial += rotation;
+    *current_dial %= 100;
+    return *current_dial == 0;
+}
 
-        if (dial_type == 'R') {
-            current_dial += dial_value;
-        } else {
-            current_dial -= dial_value;
-        }
+// Clicks of part 2, every time the dial passes or stops at 0
+static int turn_counting_passes(int* current_dial, int rotation) {
+    int prev_dial = *current_dial;
+    int click = 0;
+    *current_dial += rotation;
 
-        current_dial %= 100;
+    if (*current_dial >= 100) {
+        click += (int)(*current_dial / 100);
+    }
 
-        if (current_dial == 0) {
-            click++;
+    if (*current_dial <= 0) {
+        if (!(prev_dial == 0 && *current_dial > -100)) {
+            click += (int)abs(*current_dial / 100) + (int)(prev_dial != 0);
         }
     }
 
+    *current_dial %= 100;
+    if (*current_dial < 0) {
+        *current_dial += 100;
+    }
     return click;
 }
 
-int solve_part_2(InputData dials) {
+static uint64_t solve(const void* state) {
+    const Rotations* dials = state;
     int current_dial = 50;
     int click = 0;
 
-    for (size_t i = 0; i < dials.count; ++i) {
-        char* dial = dials.items[i];
-        char dial_type = dial[0];
-        char* dial_value_str = dial + 1;
-
-        int dial_value = atoi(dial_value_str);
-        int prev_dial = current_dial;
-
-        if (dial_type == 'R') {
-            current_dial += dial_value;
-        } else {
-            current_dial -= dial_value;
-        }
+    for (size_t i = 0; i < dials->count; ++i) {
+        click += turn(&current_dial, dials->items[i]);
+    }
 
-        if (current_dial >= 100) {
-            click += (int)(current_dial / 100);
-        }
+    return click;
+}
 
-        if (current_dial <= 0) {
-            if (!(prev_dial == 0 && current_dial > -100)) {
-                click += (int)abs(current_dial / 100) + (int)(prev_dial != 0);
-            }
-        }
+static uint64_t solve_part_2(const void* state) {
+    const Rotations* dials = state;
+    int current_dial = 50;
+    int click = 0;
 
-        current_dial %= 100;
-        if (current_dial < 0) {
-            current_dial += 100;
-        }
+    for (size_t i = 0; i < dials->count; ++i) {
+        click += turn_counting_passes(&current_dial, dials->items[i]);
     }
 
     return click;
 }
 
-int main() {
-    char* input_file = "inputs/q1_input.txt";
-    InputData input_lines = read_lines(input_file);
-    
-    int password = solve(input_lines);
-    int password = solve_part_2(input_lines);
+// Both parts turn their dial as the rotations come in, nothing is kept
+static bool scan_rotations(Line_Stream* lines, uint64_t answers[2]) {
+    int dials[2] = {50, 50};
+    int clicks[2] = {0};
+
+    String_View line;
+    while (line_stream_next(lines, &line)) {
+        int rotation = 0;
+        if (!parse_rotation(line, &rotation)) continue;
+        clicks[0] += turn(&dials[0], rotation);
+        clicks[1] += turn_counting_passes(&dials[1], rotation);
+    }
 
-    printf("Password : %d\n", password);
+    answers[0] += (uint64_t)clicks[0];
+    answers[1] += (uint64_t)clicks[1];
+    return true;
+}
 
-    da_free(input_lines);
-    return 0;
-}
\ No newline at end of file
+AOC_DAY(1, .name = "Secret Entrance", .input_path = "inputs/q1_input.txt",
+        .parse = parse, .part_1 = solve, .part_2 = solve_part_2, .free = free_rotations,
+        .scan = scan_rotations)
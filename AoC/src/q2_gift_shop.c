@@ -4,81 +4,36 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef AOC_RUNNER
 #define NOB_IMPLEMENTATION
+#endif
 #define NOB_STRIP_PREFIX
 
 #include "../header/nob.h"
-
-typedef long long ull;
+#include "../header/input.h"
+#include "../header/fast_parse.h"
+#include "../header/tokenizer.h"
+#include "../header/aoc.h"
 
 typedef struct {
-    int start;
-    int end;
+    uint64_t start;
+    uint64_t end;
 } IDPair;
 
 typedef struct {
-    char** items;
-    size_t capacity;
+    IDPair* items;
     size_t count;
-} InputData;
+    size_t capacity;
+} IDPairs;
 
-#define LINE_MAX_LEN 2024
 typedef struct {
     char** items;
     size_t count;
     size_t capacity;
 } Strings;
 
-static char* strdup_s(const char* s) {
-    size_t len = strlen(s) + 1;
-    char* p = malloc(len);
-    if (!p) return NULL;
-    memcpy(p, s, len);
-    return p;
-}
-
-void split(Strings* out, const char* text, const char* delimiter) {
-    char* copy = strdup_s(text);
-    if (!copy) {
-        fprintf(stderr, "Failed to allocate memory for copy\n");
-        return;
-    }
-
-    char* token = strtok(copy, delimiter);
-    while (token != NULL) {
-        char* tok_copy = strdup_s(token);
-        if (!tok_copy) {
-            fprintf(stderr, "Failed to allocate memory for token\n");
-            break;  // stop adding more; keep what we have
-        }
-        da_append(out, tok_copy);
-        token = strtok(NULL, delimiter);
-    }
-
-    free(copy);
-}
-
-InputData read_lines(const char* filename) {
-    InputData input_data = {0};
-    FILE* fp = fopen(filename, "r");
-
-    if (!fp) return input_data;
-
-    char buffer[LINE_MAX_LEN];
-
-    while (fgets(buffer, LINE_MAX_LEN, fp)) {
-        // Trim newline
-        buffer[strcspn(buffer, "\n")] = '\0';
-
-        da_append(&input_data, nob_temp_strdup(buffer));
-    }
-
-    fclose(fp);
-    return input_data;
-}
-
 // This is for part I
-int is_valid(char* value_str) {
+static int is_valid(char* value_str) {
     size_t len = strlen(value_str);
 
     if (len % 2 != 0) {
@@ -96,14 +51,14 @@ int is_valid(char* value_str) {
     left[half] = '\0';
     right[half] = '\0';
 
-    if (strcmp(left, right) == 0) {
-        return 0;
-    }
+    int valid = strcmp(left, right) != 0;
+    free(left);
+    free(right);
 
-    return 1;
+    return valid;
 }
 
-void split_into_chunks(Strings* out, const char* text, size_t chunk_size) {
+static void split_into_chunks(Strings* out, const char* text, size_t chunk_size) {
     size_t len = strlen(text);
 
     for (size_t i = 0; i < len; i += chunk_size) {
@@ -119,74 +74,223 @@ void split_into_chunks(Strings* out, const char* text, size_t chunk_size) {
 }
 
 // This is for part II
-int is_valid_v2(char* value_str) {
+static int is_valid_v2(char* value_str) {
     size_t len = strlen(value_str);
 
-    for (int chunk_size = 1; chunk_size <= len / 2; ++chunk_size) {
+    for (size_t chunk_size = 1; chunk_size <= len / 2; ++chunk_size) {
         if (len % chunk_size == 0) {
             Strings segments = {0};
             split_into_chunks(&segments, value_str, chunk_size);
 
             bool invalid = true;
-            for (int seg_idx = 1; seg_idx < segments.count; ++seg_idx) {
+            for (size_t seg_idx = 1; seg_idx < segments.count; ++seg_idx) {
                 if (strcmp(segments.items[seg_idx - 1], segments.items[seg_idx]) != 0) {
                     invalid = false;
                     break;
                 }
             }
 
+            for (size_t seg_idx = 0; seg_idx < segments.count; ++seg_idx) {
+                free(segments.items[seg_idx]);
+            }
+            da_free(segments);
+
             if (invalid) {
                 return 0;
             }
-            
-            da_free(segments);
         }
     }
 
     return 1;
 }
 
-uint64_t solve(Strings id_pairs) {
+// "11-22", false for anything else
+static bool parse_range(String_View range, IDPair* pair) {
+    Tokenizer tok = tok_chars(range, "-");
+    String_View low_str, high_str;
+    if (!tok_next(&tok, &low_str) || !tok_next(&tok, &high_str)) {
+        return false;
+    }
+
+    *pair = (IDPair){.start = sv_to_u64(low_str), .end = sv_to_u64(high_str)};
+    return true;
+}
+
+static void* parse(const Lines* lines) {
+    if (lines->count == 0) return NULL;
+
+    IDPairs* id_pairs = calloc(1, sizeof(IDPairs));
+    Tokenizer ranges = tok_chars(lines->items[0], ",");
+    String_View range;
+
+    while (tok_next(&ranges, &range)) {
+        IDPair pair;
+        if (parse_range(range, &pair)) da_append(id_pairs, pair);
+    }
+
+    return id_pairs;
+}
+
+static void free_id_pairs(void* state) {
+    IDPairs* id_pairs = state;
+    da_free(*id_pairs);
+    free(id_pairs);
+}
+
+static uint64_t sum_invalid_ids(const IDPairs* id_pairs, int (*is_valid_id)(char*)) {
     uint64_t sum_of_invalid_ids = 0;
 
-    for (size_t i = 0; i < id_pairs.count; ++i) {
-        Strings id_pair = {0};
-        split(&id_pair, id_pairs.items[i], "-");
-        
-        if (id_pair.items[0][0] == "0" || id_pair.items[1][0] == "0") {
-            continue;
-        }
-        
-        uint64_t low = (uint64_t)strtoull(id_pair.items[0], NULL, 10);
-        uint64_t high = (uint64_t)strtoull(id_pair.items[1], NULL, 10);
-        
-        for (uint64_t value = low; value <= high; ++value) {
+    for (size_t i = 0; i < id_pairs->count; ++i) {
+        IDPair pair = id_pairs->items[i];
+        for (uint64_t value = pair.start; value <= pair.end; ++value) {
             char value_str[32];
-            sprintf(value_str, "%zu", value);
-            if (!is_valid_v2(value_str)) {
+            sprintf(value_str, "%" PRIu64, value);
+            if (!is_valid_id(value_str)) {
                 sum_of_invalid_ids += value;
             }
         }
+    }
+
+    return sum_of_invalid_ids;
+}
+
+// The straightforward solvers, kept as the reference `aoc diff` checks the arithmetic ones against
+static uint64_t solve_reference(const void* state) {
+    return sum_invalid_ids(state, is_valid);
+}
+
+static uint64_t solve_part_2_reference(const void* state) {
+    return sum_invalid_ids(state, is_valid_v2);
+}
+
+// A number of len digits made of one k digit block repeated is that block times the repunit
+// 1 0..0 1 0..0 1 with len / k ones, and every multiple of it with exactly len digits is such a number.
+// So the invalid ids of a range are sums of multiples, one length at a time, without visiting any id.
+#define MAX_DIGITS 19
+
+static const uint64_t powers_of_10[MAX_DIGITS + 1] = {
+    1ull,
+    10ull,
+    100ull,
+    1000ull,
+    10000ull,
+    100000ull,
+    1000000ull,
+    10000000ull,
+    100000000ull,
+    1000000000ull,
+    10000000000ull,
+    100000000000ull,
+    1000000000000ull,
+    10000000000000ull,
+    100000000000000ull,
+    1000000000000000ull,
+    10000000000000000ull,
+    100000000000000000ull,
+    1000000000000000000ull,
+    10000000000000000000ull,
+};
+
+static size_t digit_count(uint64_t value) {
+    size_t len = 1;
+    while (len < MAX_DIGITS + 1 && value >= powers_of_10[len]) ++len;
+    return len;
+}
+
+static uint64_t repunit(size_t len, size_t block) {
+    uint64_t value = 0;
+    for (size_t i = 0; i < len; i += block) value += powers_of_10[i];
+    return value;
+}
+
+// Sum of the multiples of m in [low, high]
+static uint64_t sum_of_multiples(uint64_t m, uint64_t low, uint64_t high) {
+    uint64_t first = (low + m - 1) / m;
+    uint64_t last = high / m;
+    if (first > last) return 0;
+
+    uint64_t count = last - first + 1;
+    uint64_t sum = count % 2 == 0 ? count / 2 * (first + last) : (first + last) / 2 * count;
+    return sum * m;
+}
+
+// Calls sum_of_length(len, low, high) for the part of the pair with exactly len digits
+static uint64_t sum_range(IDPair pair, uint64_t (*sum_of_length)(size_t, uint64_t, uint64_t)) {
+    if (pair.start > pair.end) return 0;
 
-        da_free(id_pair);
+    uint64_t sum_of_invalid_ids = 0;
+    size_t last_len = digit_count(pair.end);
+    NOB_ASSERT(last_len <= MAX_DIGITS && "ids with 20 digits are not supported");
+    for (size_t len = digit_count(pair.start); len <= last_len; ++len) {
+        uint64_t low = pair.start > powers_of_10[len - 1] ? pair.start : powers_of_10[len - 1];
+        uint64_t high = pair.end < powers_of_10[len] - 1 ? pair.end : powers_of_10[len] - 1;
+        sum_of_invalid_ids += sum_of_length(len, low, high);
+    }
+    return sum_of_invalid_ids;
+}
+
+static uint64_t sum_by_length(const IDPairs* id_pairs, uint64_t (*sum_of_length)(size_t, uint64_t, uint64_t)) {
+    uint64_t sum_of_invalid_ids = 0;
+
+    for (size_t i = 0; i < id_pairs->count; ++i) {
+        sum_of_invalid_ids += sum_range(id_pairs->items[i], sum_of_length);
     }
 
     return sum_of_invalid_ids;
 }
 
-int main() {
-    char* input_file = "inputs/q2_input.txt";
+static uint64_t sum_halves(size_t len, uint64_t low, uint64_t high) {
+    if (len % 2 != 0) return 0;
+    return sum_of_multiples(repunit(len, len / 2), low, high);
+}
+
+// A number repeating a block of k digits also repeats every block whose size k divides, so each
+// number is counted once under the smallest block that builds it
+static uint64_t sum_repeats(size_t len, uint64_t low, uint64_t high) {
+    uint64_t smallest[MAX_DIGITS + 1] = {0};
+    uint64_t sum = 0;
+
+    for (size_t block = 1; block < len; ++block) {
+        if (len % block != 0) continue;
+        smallest[block] = sum_of_multiples(repunit(len, block), low, high);
+        for (size_t inner = 1; inner < block; ++inner) {
+            if (block % inner == 0) smallest[block] -= smallest[inner];
+        }
+        sum += smallest[block];
+    }
 
-    InputData input_lines = read_lines(input_file);
+    return sum;
+}
 
-    Strings strings = {0};
-    split(&strings, input_lines.items[0], ",");
+static uint64_t solve(const void* state) {
+    return sum_by_length(state, sum_halves);
+}
 
-    uint64_t password = solve(strings);
-    printf("Password : %" PRIu64 "\n", password);
+static uint64_t solve_part_2(const void* state) {
+    return sum_by_length(state, sum_repeats);
+}
+
+// The ranges are the records of `aoc --pipeline`, the last one still has the newline
+static Parse_Result parse_range_record(String_View text, const void* shared, Arena* arena, void* record) {
+    (void)shared;
+    (void)arena;
+    return parse_range(sv_trim(text), record) ? PARSE_RECORD : PARSE_SKIP;
+}
+
+static void solve_range(const void* record, const void* shared, uint64_t answers[2]) {
+    (void)shared;
+    const IDPair* pair = record;
+    answers[0] += sum_range(*pair, sum_halves);
+    answers[1] += sum_range(*pair, sum_repeats);
+}
 
-    da_free(input_lines);
-    da_free(strings);
+static const Pipeline_Stream stream = {
+    .delimiter = ',',
+    .record_size = sizeof(IDPair),
+    .parse = parse_range_record,
+    .solve = solve_range,
+};
 
-    return 0;
-}
\ No newline at end of file
+AOC_DAY(2, .name = "Gift Shop", .input_path = "inputs/q2_input.txt",
+        .parse = parse, .part_1 = solve, .part_2 = solve_part_2, .free = free_id_pairs,
+        .reference_1 = solve_reference, .reference_2 = solve_part_2_reference, .stream = &stream)
@@ -5,10 +5,14 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef AOC_RUNNER
 #define NOB_IMPLEMENTATION
+#endif
 #define NOB_STRIP_PREFIX
 
 #include "../header/nob.h"
+#include "../header/input.h"
+#include "../header/aoc.h"
 
 #define max(a, b) \
     ({ __typeof__ (a) _a = (a); \
@@ -20,167 +24,93 @@
     __typeof__ (b) _b = (b); \
     a < _b ? _a : _b; })
 
-typedef struct {
-    char** items;
-    size_t capacity;
-    size_t count;
-} InputData;
-
-#define LINE_MAX_LEN 2024
-typedef struct {
-    char** items;
-    size_t count;
-    size_t capacity;
-} Strings;
-
-static char* strdup_s(const char* s) {
-    size_t len = strlen(s) + 1;
-    char* p = malloc(len);
-    if (!p) return NULL;
-    memcpy(p, s, len);
-    return p;
-}
-
-void split(Strings* out, const char* text, const char* delimiter) {
-    char* copy = strdup_s(text);
-    if (!copy) {
-        fprintf(stderr, "Failed to allocate memory for copy\n");
-        return;
-    }
-
-    char* token = strtok(copy, delimiter);
-    while (token != NULL) {
-        char* tok_copy = strdup_s(token);
-        if (!tok_copy) {
-            fprintf(stderr, "Failed to allocate memory for token\n");
-            break;  // stop adding more; keep what we have
-        }
-        da_append(out, tok_copy);
-        token = strtok(NULL, delimiter);
-    }
-
-    free(copy);
+static size_t char_to_int(char x) {
+    return (size_t)(x - '0');
 }
 
-InputData read_lines(const char* filename) {
-    InputData input_data = {0};
-    FILE* fp = fopen(filename, "r");
+// The largest two digit number the bank can make, its digits in order
+static uint64_t max_joltage_pair(String_View bank) {
+    const char* joltage_ratings = bank.data;
+    size_t len = bank.count;
 
-    if (!fp) return input_data;
+    uint64_t max_joltage = 0;
+    uint64_t max_first = (uint64_t)char_to_int(joltage_ratings[0]);
 
-    char buffer[LINE_MAX_LEN];
-
-    while (fgets(buffer, LINE_MAX_LEN, fp)) {
-        // Trim newline
-        buffer[strcspn(buffer, "\n")] = '\0';
-
-        da_append(&input_data, nob_temp_strdup(buffer));
+    for (uint64_t i = 1; i < len; ++i) {
+        uint64_t current_jolt_rating = (uint64_t)char_to_int(joltage_ratings[i]);
+        max_joltage = max(max_first * 10 + current_jolt_rating, max_joltage);
+        max_first = max(current_jolt_rating, max_first);
     }
-
-    fclose(fp);
-    return input_data;
+    return max_joltage;
 }
 
-void split_into_chunks(InputData* out, const char* text, size_t chunk_size) {
-    size_t len = strlen(text);
-
-    for (size_t i = 0; i < len; i += chunk_size) {
-        size_t remaining = len - i;
-        size_t take = remaining < chunk_size ? remaining : chunk_size;
-
-        char* chunk = malloc(take + 1);
-        memcpy(chunk, text + i, take);
-        chunk[take] = '\0';
-
-        nob_da_append(out, chunk);
-    }
-}
+static uint64_t max_joltage_digits(String_View bank, size_t num_digits) {
+    const char* joltage_ratings = bank.data;
 
-char* extract_segment(const char* text, size_t start_index, size_t end_index) {
-    if (start_index >= end_index)
-        return "";
+    size_t len = bank.count;
+    size_t current_segment_len = num_digits;
 
-    size_t segment_size = end_index - start_index;
+    size_t start = 0;
+    uint64_t max_joltage = 0;
 
-    char* segment = malloc(segment_size + 1);
-    memcpy(segment, text + start_index, segment_size);
-    segment[segment_size] = '\0';
+    while (current_segment_len > 0) {
+        // Find the first max value in this segment
+        uint64_t current_max = 0;
+        size_t segment_end = len - current_segment_len + 1;
 
-    return segment;
-}
+        for (size_t segment_idx = start; segment_idx < segment_end; ++segment_idx) {
+            uint64_t current_value = (uint64_t)char_to_int(joltage_ratings[segment_idx]);
+            if (current_max < current_value) {
+                current_max = current_value;
+                start = segment_idx + 1;
+            }
+            current_max = max(current_max, current_value);
+        }
+        max_joltage += current_max * (uint64_t)pow(10, current_segment_len - 1);
 
-size_t char_to_int(char x) {
-    return (size_t)(x - '0');
+        current_segment_len--;
+    }
+    return max_joltage;
 }
 
-uint64_t solve(const InputData joltage_rating_lines) {
+static uint64_t solve(const void* state) {
+    const Lines* joltage_rating_lines = state;
     uint64_t total_max_joltages = 0;
-    for (uint64_t line_idx = 0; line_idx < joltage_rating_lines.count; ++line_idx) {
-        char* joltage_ratings = joltage_rating_lines.items[line_idx];
-        size_t len = strlen(joltage_ratings);
-
-        uint64_t max_joltage = 0;
-        uint64_t max_first = (uint64_t)char_to_int(joltage_ratings[0]);
-        printf("Line :%s\n", joltage_ratings);
-
-        for (uint64_t i = 1; i < len; ++i) {
-            uint64_t current_jolt_rating = (uint64_t)char_to_int(joltage_ratings[i]);
-            max_joltage = max(max_first * 10 + current_jolt_rating, max_joltage);
-            max_first = max(current_jolt_rating, max_first);
-        }
-
-        printf("%s - %" PRIu64 " - %" PRIu64 "\n", joltage_ratings, max_joltage, max_first);
-
-        total_max_joltages += max_joltage;
+    for (uint64_t line_idx = 0; line_idx < joltage_rating_lines->count; ++line_idx) {
+        total_max_joltages += max_joltage_pair(joltage_rating_lines->items[line_idx]);
     }
     return total_max_joltages;
 }
 
-uint64_t solve_part_2(const InputData joltage_rating_lines, size_t num_digits) {
+static uint64_t solve_part_2(const Lines* joltage_rating_lines, size_t num_digits) {
     uint64_t total_max_joltages = 0;
-    for (uint64_t line_idx = 0; line_idx < joltage_rating_lines.count; ++line_idx) {
-        char* joltage_ratings = joltage_rating_lines.items[line_idx];
-
-        size_t len = strlen(joltage_ratings);
-        size_t current_segment_len = num_digits;
-
-        size_t start = 0;
-        uint64_t max_joltage = 0;
-
-        while (current_segment_len > 0) {
-            // Find the first max value in this segment
-            uint64_t current_max = 0;
-            size_t segment_end = len - current_segment_len + 1;
-
-            for (size_t segment_idx = start; segment_idx < segment_end; ++segment_idx) {
-                uint64_t current_value = (uint64_t)char_to_int(joltage_ratings[segment_idx]);
-                if (current_max < current_value) {
-                    current_max = current_value;
-                    start = segment_idx + 1;
-                }
-                current_max = max(current_max, current_value);
-            }
-            max_joltage += current_max * (uint64_t)pow(10, current_segment_len - 1);
-
-            current_segment_len--;
-        }
-
-        total_max_joltages += max_joltage;
+    for (uint64_t line_idx = 0; line_idx < joltage_rating_lines->count; ++line_idx) {
+        total_max_joltages += max_joltage_digits(joltage_rating_lines->items[line_idx], num_digits);
     }
     return total_max_joltages;
 }
 
-int main() {
-    char* input_file = "inputs/q3_input.txt";
+static uint64_t part_2(const void* state) {
+    return solve_part_2(state, 12);
+}
 
-    InputData input_lines = read_lines(input_file);
+// Every bank is a record of its own for `aoc --pipeline`, it stays a view into its chunk
+static Parse_Result parse_bank(String_View line, const void* shared, Arena* arena, void* record) {
+    (void)shared;
+    (void)arena;
+    if (line.count == 0) return PARSE_SKIP;
+    *(String_View*)record = line;
+    return PARSE_RECORD;
+}
 
-    uint64_t password = solve(input_lines);
-    uint64_t password = solve_part_2(input_lines, 12);
- 
-    printf("Password : %" PRIu64 "\n", password);
+static void solve_bank(const void* record, const void* shared, uint64_t answers[2]) {
+    (void)shared;
+    String_View bank = *(const String_View*)record;
+    answers[0] += max_joltage_pair(bank);
+    answers[1] += max_joltage_digits(bank, 12);
+}
 
-    da_free(input_lines);
+static const Pipeline_Stream stream = {.record_size = sizeof(String_View), .parse = parse_bank, .solve = solve_bank};
 
-    return 0;
-}
\ No newline at end of file
+AOC_DAY(3, .name = "Lobby", .input_path = "inputs/q3_input.txt",
+        .parse = aoc_parse_lines, .part_1 = solve, .part_2 = part_2, .stream = &stream)
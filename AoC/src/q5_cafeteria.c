@@ -5,11 +5,19 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef AOC_RUNNER
 #define NOB_IMPLEMENTATION
+#endif
 #define NOB_STRIP_PREFIX
 
 #include "../header/interval_tree.h"
 #include "../header/nob.h"
+#include "../header/input.h"
+#include "../header/fast_parse.h"
+#include "../header/arena.h"
+#include "../header/pool.h"
+#include "../header/parallel_parse.h"
+#include "../header/aoc.h"
 
 #define max(a, b) \
     ({ __typeof__ (a) _a = (a); \
@@ -22,162 +30,97 @@
     a < _b ? _a : _b; })
 
 typedef struct {
-    char** items;
-    size_t capacity;
+    Interval* items;
     size_t count;
-} InputData;
+    size_t capacity;
+} Intervals;
 
-#define LINE_MAX_LEN 2024
 typedef struct {
-    char** items;
+    uint64_t* items;
     size_t count;
     size_t capacity;
-} Strings;
-
-static char* strdup_s(const char* s) {
-    size_t len = strlen(s) + 1;
-    char* p = malloc(len);
-    if (!p) return NULL;
-    memcpy(p, s, len);
-    return p;
-}
+} Ingredients;
 
-void split(Strings* out, const char* text, const char* delimiter) {
-    char* copy = strdup_s(text);
-    if (!copy) {
-        fprintf(stderr, "Failed to allocate memory for copy\n");
-        return;
-    }
-
-    char* token = strtok(copy, delimiter);
-    while (token != NULL) {
-        char* tok_copy = strdup_s(token);
-        if (!tok_copy) {
-            fprintf(stderr, "Failed to allocate memory for token\n");
-            break;  // stop adding more; keep what we have
-        }
-        da_append(out, tok_copy);
-        token = strtok(NULL, delimiter);
-    }
-
-    free(copy);
+typedef struct {
+    Intervals fresh_ranges;
+    Ingredients ingredients;
+} Recipe;
+
+static Parse_Result parse_range(String_View line, const void* ctx, Arena* arena, void* record) {
+    (void)ctx;
+    (void)arena;
+    if (line.count == 0) return PARSE_SKIP;
+
+    String_View low_str = sv_chop_by_delim(&line, '-');
+    *(Interval*)record = (Interval){sv_to_u64(low_str), sv_to_u64(line)};
+    return PARSE_RECORD;
 }
 
-InputData* copy_input_data(const InputData* src) {
-    InputData* dest = (InputData*)malloc(sizeof(InputData));
+static Parse_Result parse_ingredient(String_View line, const void* ctx, Arena* arena, void* record) {
+    (void)ctx;
+    (void)arena;
+    if (line.count == 0) return PARSE_SKIP;
 
-    // Copy metadata
-    dest->capacity = src->capacity;
-    dest->count = src->count;
-
-    // Allocate new array of char*
-    dest->items = malloc(dest->capacity * sizeof(char*));
-    if (!dest->items) {
-        dest->capacity = dest->count = 0;
-        return dest;  // handle alloc failure however you like
-    }
-
-    // Deep-copy each string
-    for (size_t i = 0; i < src->count; i++) {
-        dest->items[i] = strdup(src->items[i]);  // or manual malloc/copy
-        if (!dest->items[i]) {
-            // Clean up partial allocation on failure
-            for (size_t j = 0; j < i; j++) free(dest->items[j]);
-            free(dest->items);
-            dest->items = NULL;
-            dest->capacity = dest->count = 0;
-            return dest;
-        }
-    }
-
-    return dest;
+    *(uint64_t*)record = sv_to_u64(line);
+    return PARSE_RECORD;
 }
 
-InputData read_lines(const char* filename) {
-    InputData input_data = {0};
-    FILE* fp = fopen(filename, "r");
-
-    if (!fp) return input_data;
+// The ranges come first, a blank line separates them from the ingredient ids. Both halves are parsed
+// in chunks over the pool.
+static void* parse(const Lines* lines) {
+    Recipe* recipe = calloc(1, sizeof(Recipe));
+    String_View text = lines->text;
 
-    char buffer[LINE_MAX_LEN];
-
-    while (fgets(buffer, LINE_MAX_LEN, fp)) {
-        // Trim newline
-        buffer[strcspn(buffer, "\n")] = '\0';
-
-        da_append(&input_data, nob_temp_strdup(buffer));
+    size_t split = 0;
+    while (split < text.count && text.data[split] != '\n') {
+        split = input_find_newline(text.data, split, text.count) + 1;
     }
-
-    fclose(fp);
-    return input_data;
+    String_View ranges = sv_from_parts(text.data, split < text.count ? split : text.count);
+    String_View ingredients = sv_from_parts(text.data + ranges.count, text.count - ranges.count);
+
+    Intervals* fresh_ranges = &recipe->fresh_ranges;
+    fresh_ranges->items = parallel_parse_lines(ranges, sizeof(Interval), parse_range, NULL, NULL, &fresh_ranges->count,
+                                               NULL);
+    fresh_ranges->capacity = fresh_ranges->count;
+
+    Ingredients* ids = &recipe->ingredients;
+    ids->items = parallel_parse_lines(ingredients, sizeof(uint64_t), parse_ingredient, NULL, NULL, &ids->count, NULL);
+    ids->capacity = ids->count;
+    return recipe;
 }
 
-void split_into_chunks(InputData* out, const char* text, size_t chunk_size) {
-    size_t len = strlen(text);
-
-    for (size_t i = 0; i < len; i += chunk_size) {
-        size_t remaining = len - i;
-        size_t take = remaining < chunk_size ? remaining : chunk_size;
-
-        char* chunk = malloc(take + 1);
-        memcpy(chunk, text + i, take);
-        chunk[take] = '\0';
-
-        nob_da_append(out, chunk);
-    }
-}
-
-char* extract_segment(const char* text, size_t start_index, size_t end_index) {
-    if (start_index >= end_index)
-        return "";
-
-    size_t segment_size = end_index - start_index;
-
-    char* segment = malloc(segment_size + 1);
-    memcpy(segment, text + start_index, segment_size);
-    segment[segment_size] = '\0';
-
-    return segment;
+static void free_recipe(void* state) {
+    Recipe* recipe = state;
+    da_free(recipe->fresh_ranges);
+    da_free(recipe->ingredients);
+    free(recipe);
 }
 
-size_t char_to_int(char x) {
-    return (size_t)(x - '0');
-}
-
-uint64_t solve(const InputData* recipe) {
-    bool switch_recipe = false;
+static uint64_t solve(const void* state) {
+    const Recipe* recipe = state;
     uint64_t available_ingredient_count = 0;
     ITNode* root = NULL;
 
-    for (size_t i = 0; i < recipe->count; ++i) {
-        if (!switch_recipe) {
-            if (strcmp(recipe->items[i], "") == 0) {
-                switch_recipe = true;
-                printf("Switch");
-                continue;
-            }
-
-            Strings interval = {0};
-            split(&interval, recipe->items[i], "-");
-
-            uint64_t low = (uint64_t)strtoull(interval.items[0], NULL, 10);
-            uint64_t high = (uint64_t)strtoull(interval.items[1], NULL, 10);
-
-            root = insert(root, (Interval){low, high});
-
-            da_free(interval);
-        } else {
-            uint64_t item = (uint64_t)strtoull(recipe->items[i], NULL, 10);
-            bool found = containsPoint(root, item, NULL);
-            if (found) {
-                available_ingredient_count++;
-            }
+    TRACE_BEGIN("tree build");
+    for (size_t i = 0; i < recipe->fresh_ranges.count; ++i) {
+        root = insert(root, recipe->fresh_ranges.items[i]);
+    }
+    TRACE_END();
+
+    TRACE_BEGIN("lookups");
+    for (size_t i = 0; i < recipe->ingredients.count; ++i) {
+        bool found = containsPoint(root, recipe->ingredients.items[i], NULL);
+        if (found) {
+            available_ingredient_count++;
         }
     }
+    TRACE_END();
+
+    freeTree(root);
     return available_ingredient_count;
 }
 
-uint64_t inorder_sum(ITNode* root) {
+static uint64_t inorder_sum(ITNode* root) {
     if (!root) return 0;
 
     uint64_t sum = 0;
@@ -187,41 +130,21 @@ uint64_t inorder_sum(ITNode* root) {
     return sum;
 }
 
-uint64_t solve_part_2(const InputData* recipe) {
-    bool switch_recipe = false;
+static uint64_t solve_part_2(const void* state) {
+    const Recipe* recipe = state;
     ITNode* root = NULL;
 
-    for (size_t i = 0; i < recipe->count; ++i) {
-        if (!switch_recipe) {
-            if (strcmp(recipe->items[i], "") == 0) {
-                switch_recipe = true;
-                continue;
-            }
-
-            Strings interval = {0};
-            split(&interval, recipe->items[i], "-");
-
-            uint64_t low = (uint64_t)strtoull(interval.items[0], NULL, 10);
-            uint64_t high = (uint64_t)strtoull(interval.items[1], NULL, 10);
-
-            root = insertAndMerge(root, (Interval){low, high});
-        } else {
-            break;
-        }
+    TRACE_BEGIN("merge");
+    for (size_t i = 0; i < recipe->fresh_ranges.count; ++i) {
+        root = insertAndMerge(root, recipe->fresh_ranges.items[i]);
     }
-    // inorder(root);
-    return inorder_sum(root);
-}
-
-int main() {
-    char* input_file = "inputs/q5_input_simple.txt";
+    TRACE_END();
 
-    InputData input_lines = read_lines(input_file);
-
-    uint64_t password = solve(&input_lines);
-    uint64_t password = solve_part_2(&input_lines);
-    printf("Password : %" PRIu64 "\n", password);
+    uint64_t fresh_ids = inorder_sum(root);
+    freeTree(root);
+    return fresh_ids;
+}
 
-    da_free(input_lines);
-    return 0;
-}
\ No newline at end of file
+AOC_DAY(5, .name = "Cafeteria", .input_path = "inputs/q5_input.txt",
+        .parse = parse, .part_1 = solve, .part_2 = solve_part_2, .free = free_recipe,
+        .text_only = true)
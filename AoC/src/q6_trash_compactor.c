@@ -5,10 +5,16 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef AOC_RUNNER
 #define NOB_IMPLEMENTATION
+#endif
 #define NOB_STRIP_PREFIX
 
 #include "../header/nob.h"
+#include "../header/input.h"
+#include "../header/fast_parse.h"
+#include "../header/tokenizer.h"
+#include "../header/aoc.h"
 
 #define max(a, b) \
     ({ __typeof__ (a) _a = (a); \
@@ -21,219 +27,25 @@
     a < _b ? _a : _b; })
 
 typedef struct {
-    char** items;
-    size_t capacity;
-    size_t count;
-} InputData;
-
-#define LINE_MAX_LEN 100000
-typedef struct {
-    char** items;
-    size_t count;
-    size_t capacity;
-} Strings;
-
-typedef struct {
-    Strings* items;
+    Tokens* items;
     size_t count;
     size_t capacity;
 } SMatrix;
 
-static char*
-strdup_s(const char* s) {
-    size_t len = strlen(s) + 1;
-    char* p = malloc(len);
-    if (!p) return NULL;
-    memcpy(p, s, len);
-    return p;
-}
-
-void split(Strings* out, const char* text, const char* delimiter) {
-    char* copy = strdup_s(text);
-    if (!copy) {
-        fprintf(stderr, "Failed to allocate memory for copy\n");
-        return;
-    }
-
-    char* token = strtok(copy, delimiter);
-    while (token != NULL) {
-        char* tok_copy = strdup_s(token);
-        if (!tok_copy) {
-            fprintf(stderr, "Failed to allocate memory for token\n");
-            break;  // stop adding more; keep what we have
-        }
-        da_append(out, tok_copy);
-        token = strtok(NULL, delimiter);
-    }
-
-    free(copy);
-}
-
-void remove_spaces(char* str) {
-    char* read = str;
-    char* write = str;
-
-    while (*read) {
-        if (*read != ' ') {  // keep only non-space characters
-            *write = *read;
-            write++;
-        }
-        read++;
-    }
-    *write = '\0';  // null-terminate the cleaned string
-}
-
-void split_v2(Strings* out, const char* text, const char* delimiter) {
-    if (!text || !delimiter || !delimiter[0]) {
-        return;
-    }
-
-    char delim = delimiter[0];  // assume single char delimiter, e.g. ' '
-
-    const char* p = text;
-    const char* token_start = p;
-    int seen_non_delim = 0;  // have we seen a non-space in this token?
-
-    while (*p) {
-        if (*p == delim) {
-            if (seen_non_delim) {
-                // We just hit the *first* delimiter after some non-delim chars:
-                // cut the token here, remove exactly ONE delimiter.
-                size_t len = (size_t)(p - token_start);
-                if (len > 0) {
-                    char* tok_copy = malloc(len + 1);
-                    if (!tok_copy) {
-                        fprintf(stderr, "Failed to allocate memory for token\n");
-                        return;
-                    }
-                    memcpy(tok_copy, token_start, len);
-                    tok_copy[len] = '\0';
-                    da_append(out, tok_copy);
-                }
-
-                // Consume exactly one delimiter, leave the rest (if any)
-                p++;
-                token_start = p;
-                seen_non_delim = 0;
-                continue;  // continue scanning from here, but now in a new token
-            } else {
-                // Still haven't seen a non-delim in this token yet
-                // (e.g. leading spaces before first real char of this token).
-                // Keep these as part of the token.
-                p++;
-            }
-        } else {
-            seen_non_delim = 1;
-            p++;
-        }
-    }
-
-    // Last token (only if it has non-delim characters)
-    if (seen_non_delim) {
-        size_t len = (size_t)(p - token_start);
-        if (len > 0) {
-            char* tok_copy = malloc(len + 1);
-            if (!tok_copy) {
-                fprintf(stderr, "Failed to allocate memory for token\n");
-                return;
-            }
-            memcpy(tok_copy, token_start, len);
-            tok_copy[len] = '\0';
-            da_append(out, tok_copy);
-        }
-    }
-}
-
-InputData* copy_input_data(const InputData* src) {
-    InputData* dest = (InputData*)malloc(sizeof(InputData));
-
-    // Copy metadata
-    dest->capacity = src->capacity;
-    dest->count = src->count;
-
-    // Allocate new array of char*
-    dest->items = malloc(dest->capacity * sizeof(char*));
-    if (!dest->items) {
-        dest->capacity = dest->count = 0;
-        return dest;  // handle alloc failure however you like
-    }
-
-    // Deep-copy each string
-    for (size_t i = 0; i < src->count; i++) {
-        dest->items[i] = strdup(src->items[i]);  // or manual malloc/copy
-        if (!dest->items[i]) {
-            // Clean up partial allocation on failure
-            for (size_t j = 0; j < i; j++) free(dest->items[j]);
-            free(dest->items);
-            dest->items = NULL;
-            dest->capacity = dest->count = 0;
-            return dest;
-        }
-    }
-
-    return dest;
-}
-
-InputData read_lines(const char* filename) {
-    InputData input_data = {0};
-    FILE* fp = fopen(filename, "r");
-
-    if (!fp) return input_data;
-
-    char buffer[LINE_MAX_LEN];
-
-    while (fgets(buffer, LINE_MAX_LEN, fp)) {
-        // Trim newline
-        buffer[strcspn(buffer, "\n")] = '\0';
-
-        da_append(&input_data, nob_temp_strdup(buffer));
-    }
-
-    fclose(fp);
-    return input_data;
-}
-
-void split_into_chunks(InputData* out, const char* text, size_t chunk_size) {
-    size_t len = strlen(text);
-
-    for (size_t i = 0; i < len; i += chunk_size) {
-        size_t remaining = len - i;
-        size_t take = remaining < chunk_size ? remaining : chunk_size;
-
-        char* chunk = malloc(take + 1);
-        memcpy(chunk, text + i, take);
-        chunk[take] = '\0';
-
-        nob_da_append(out, chunk);
-    }
-}
-
-char* extract_segment(const char* text, size_t start_index, size_t end_index) {
-    if (start_index >= end_index)
-        return "";
-
-    size_t segment_size = end_index - start_index;
-
-    char* segment = malloc(segment_size + 1);
-    memcpy(segment, text + start_index, segment_size);
-    segment[segment_size] = '\0';
-
-    return segment;
-}
-
-size_t char_to_int(char x) {
+static size_t char_to_int(char x) {
     return (size_t)(x - '0');
 }
 
-uint64_t solve(const SMatrix* grid) {
+static uint64_t solve(const void* state) {
+    const SMatrix* grid = state;
     size_t row_count = grid->count;
     size_t col_count = grid->items[0].count;
 
     uint64_t total = 0;
 
     for (size_t col = 0; col < col_count; ++col) {
-        char* op = grid->items[row_count - 1].items[col];
-        char op_ch = strcmp(op, "+") == 0 ? '+' : '*';
+        String_View op = sv_trim(grid->items[row_count - 1].items[col]);
+        char op_ch = sv_eq(op, sv_from_cstr("+")) ? '+' : '*';
         uint64_t col_value = 1;
         
         if (op_ch == '+') {
@@ -241,8 +53,8 @@ uint64_t solve(const SMatrix* grid) {
         }
         
         for (size_t row = 0; row < row_count - 1; ++row) {
-            uint64_t value = (uint64_t)strtoull(grid->items[row].items[col], NULL, 10);
-            printf("%s\n", grid->items[row].items[col]);
+            String_View word = grid->items[row].items[col];
+            uint64_t value = sv_to_u64(word);
 
             if (op_ch == '+') {
                 col_value += value;
@@ -251,12 +63,20 @@ uint64_t solve(const SMatrix* grid) {
             }
         }
         total += col_value;
-        printf("\nTotal = %" PRIu64 "\nGrandTotal = %" PRIu64 "\n", col_value, total);
     }
     return total;
 }
 
-uint64_t solve_part_2(SMatrix* grid) {
+static size_t count_non_spaces(String_View word) {
+    size_t count = 0;
+    for (size_t i = 0; i < word.count; ++i) {
+        if (word.data[i] != ' ') count++;
+    }
+    return count;
+}
+
+static uint64_t solve_part_2(const void* state) {
+    const SMatrix* grid = state;
     // This could have been cleaner but it is what it is. Nothing to gain as an algorithmic knowledge unless you want to verify your solution.
     size_t row_count = grid->count;
     size_t col_count = grid->items[0].count;
@@ -264,9 +84,8 @@ uint64_t solve_part_2(SMatrix* grid) {
     uint64_t total = 0;
 
     for (size_t col = 0; col < col_count; ++col) {
-        char* op = grid->items[row_count - 1].items[col];
-        remove_spaces(op);
-        char op_ch = strcmp(op, "+") == 0 ? '+' : '*';
+        String_View op = sv_trim(grid->items[row_count - 1].items[col]);
+        char op_ch = sv_eq(op, sv_from_cstr("+")) ? '+' : '*';
         uint64_t col_value = 1;
 
         if (op_ch == '+') {
@@ -278,51 +97,32 @@ uint64_t solve_part_2(SMatrix* grid) {
         bool check_extra_space = true;
 
         for (size_t row = 0; row < row_count - 1; ++row) {
-            char* word = grid->items[row].items[col];
+            String_View word = grid->items[row].items[col];
 
-            size_t len_word = strlen(word);
-            max_word_len = max(max_word_len, len_word);
+            max_word_len = max(max_word_len, word.count);
 
-            if (word[0] != ' ') {
+            if (word.data[0] != ' ') {
                 check_extra_space = false;
             }
         }
 
-        if (check_extra_space) {
-            for (size_t row = 0; row < row_count - 1; ++row) {
-                char* word = grid->items[row].items[col];
-                char* word_cpy = temp_strdup(word);
-                remove_spaces(word_cpy);
-                if (strlen(word_cpy) == max_word_len - 1) {
-                    word += 1;
-                    grid->items[row].items[col] += 1;
-                }
-            }
-        }
-
-        // ALIGNMENT : Read the numbers vertically
-        Strings top_down_numbers = {0};
+        // ALIGNMENT : Read the numbers vertically and calculate the math problem on the fly
         for (size_t number_index = 0; number_index < max_word_len; ++number_index) {
-            char* num = (char*)malloc(row_count - 1 * sizeof(char));
+            uint64_t value = 0;
+            bool has_digits = false;
             for (size_t row = 0; row < row_count - 1; ++row) {
-                char* word = grid->items[row].items[col];
-                size_t len_word = strlen(word);
-                char word_ch = ' ';
-                if (number_index < len_word) {
-                    word_ch = word[number_index];
+                String_View word = grid->items[row].items[col];
+                if (check_extra_space && count_non_spaces(word) == max_word_len - 1) {
+                    sv_chop_left(&word, 1);
+                }
+                if (number_index < word.count && word.data[number_index] != ' ') {
+                    value = value * 10 + char_to_int(word.data[number_index]);
+                    has_digits = true;
                 }
-                num[row] = word_ch;
-            }
-            remove_spaces(num);
-            if (num[0] != '\0') {
-                da_append(&top_down_numbers, nob_temp_strdup(num));
             }
-            free(num);
-        }
 
-        // Calculate the math problem
-        for (size_t num_idx = 0; num_idx < top_down_numbers.count; ++num_idx) {
-            uint64_t value = (uint64_t)strtoull(top_down_numbers.items[num_idx], NULL, 10);
+            if (!has_digits) continue;
+
             if (op_ch == '+') {
                 col_value += value;
             } else if (op_ch == '*') {
@@ -335,35 +135,84 @@ uint64_t solve_part_2(SMatrix* grid) {
     return total;
 }
 
-SMatrix read_matrix(const InputData* input_lines) {
+static void* read_matrix(const Lines* input_lines) {
     size_t row_count = input_lines->count;
-    SMatrix matrix = {0};
+    if (row_count < 2) return NULL;
+
+    SMatrix* matrix = calloc(1, sizeof(SMatrix));
     for (size_t row = 0; row < row_count; ++row) {
-        Strings out = {0};
-        split_v2(&out, input_lines->items[row], " ");
-        da_append(&matrix, out);
+        Tokens out = {0};
+        tok_collect(tok_keep_runs(input_lines->items[row], ' '), &out);
+        da_append(matrix, out);
     }
 
     return matrix;
 }
 
-int main() {
-    char* input_file = "inputs/q6_input.txt";
+static void free_matrix(void* state) {
+    SMatrix* matrix = state;
+    for (size_t row = 0; row < matrix->count; ++row) {
+        da_free(matrix->items[row]);
+    }
+    da_free(*matrix);
+    free(matrix);
+}
 
-    InputData input_lines = read_lines(input_file);
-    SMatrix grid = read_matrix(&input_lines);
+// Rows of tokens, as token counts, (offset, length) pairs and the text the offsets point into
+static void save_matrix(const void* state, Snapshot_Writer* out) {
+    const SMatrix* matrix = state;
+    Nob_String_Builder text = {0};
+    uint64_t* counts = malloc(matrix->count * sizeof(uint64_t));
+    size_t total = 0;
+    for (size_t row = 0; row < matrix->count; ++row) total += matrix->items[row].count;
+    uint64_t* spans = malloc(2 * total * sizeof(uint64_t) + 1);
+
+    size_t span = 0;
+    for (size_t row = 0; row < matrix->count; ++row) {
+        const Tokens* tokens = &matrix->items[row];
+        counts[row] = tokens->count;
+        for (size_t col = 0; col < tokens->count; ++col) {
+            spans[span++] = text.count;
+            spans[span++] = tokens->items[col].count;
+            sb_append_buf(&text, tokens->items[col].data, tokens->items[col].count);
+        }
+    }
 
-    uint64_t password = solve(&grid);
-    uint64_t password = solve_part_2(&grid);
-    printf("Password : %" PRIu64 "\n", password);
+    snapshot_add(out, counts, matrix->count * sizeof(uint64_t));
+    snapshot_add(out, spans, span * sizeof(uint64_t));
+    snapshot_add(out, text.items, text.count);
+    free(counts);
+    free(spans);
+    sb_free(text);
+}
 
-    size_t row_count = input_lines.count;
+// The tokens point into the text of the snapshot again, only the rows are allocated
+static void* restore_matrix(const Snapshot* snapshot) {
+    size_t row_count = 0, span_count = 0, text_size = 0;
+    const uint64_t* counts = snapshot_items(snapshot, 0, sizeof(uint64_t), &row_count);
+    const uint64_t* spans = snapshot_items(snapshot, 1, sizeof(uint64_t), &span_count);
+    const char* text = snapshot_items(snapshot, 2, 1, &text_size);
+    if (counts == NULL || spans == NULL || text == NULL || row_count < 2) return NULL;
+
+    SMatrix* matrix = calloc(1, sizeof(SMatrix));
+    da_reserve(matrix, row_count);
+    size_t span = 0;
     for (size_t row = 0; row < row_count; ++row) {
-        da_free(grid.items[row]);
+        Tokens tokens = {0};
+        da_reserve(&tokens, counts[row]);
+        for (size_t col = 0; col < counts[row] && span + 1 < span_count; ++col, span += 2) {
+            if (spans[span] + spans[span + 1] > text_size) break;
+            da_append(&tokens, sv_from_parts(text + spans[span], spans[span + 1]));
+        }
+        da_append(matrix, tokens);
+        if (tokens.count != counts[row]) {
+            free_matrix(matrix);
+            return NULL;
+        }
     }
+    return matrix;
+}
 
-    da_free(input_lines);
-    da_free(grid);
-
-    return 0;
-}
\ No newline at end of file
+AOC_DAY(6, .name = "Trash Compactor", .input_path = "inputs/q6_input.txt",
+        .parse = read_matrix, .part_1 = solve, .part_2 = solve_part_2, .free = free_matrix,
+        .save = save_matrix, .restore = restore_matrix, .free_restored = free_matrix)
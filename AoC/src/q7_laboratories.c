@@ -5,10 +5,14 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef AOC_RUNNER
 #define NOB_IMPLEMENTATION
+#endif
 #define NOB_STRIP_PREFIX
 
 #include "../header/nob.h"
+#include "../header/input.h"
+#include "../header/aoc.h"
 #include "../header/std_ds.h"
 
 #define max(a, b) \
@@ -21,157 +25,6 @@
     __typeof__ (b) _b = (b); \
     a < _b ? _a : _b; })
 
-typedef struct {
-    char** items;
-    size_t capacity;
-    size_t count;
-} InputData;
-
-#define LINE_MAX_LEN 100000
-typedef struct {
-    char** items;
-    size_t count;
-    size_t capacity;
-} Strings;
-
-typedef struct {
-    Strings* items;
-    size_t count;
-    size_t capacity;
-} SMatrix;
-
-static char*
-strdup_s(const char* s) {
-    size_t len = strlen(s) + 1;
-    char* p = malloc(len);
-    if (!p) return NULL;
-    memcpy(p, s, len);
-    return p;
-}
-
-void split(Strings* out, const char* text, const char* delimiter) {
-    char* copy = strdup_s(text);
-    if (!copy) {
-        fprintf(stderr, "Failed to allocate memory for copy\n");
-        return;
-    }
-
-    char* token = strtok(copy, delimiter);
-    while (token != NULL) {
-        char* tok_copy = strdup_s(token);
-        if (!tok_copy) {
-            fprintf(stderr, "Failed to allocate memory for token\n");
-            break;  // stop adding more; keep what we have
-        }
-        da_append(out, tok_copy);
-        token = strtok(NULL, delimiter);
-    }
-
-    free(copy);
-}
-
-void remove_spaces(char* str) {
-    char* read = str;
-    char* write = str;
-
-    while (*read) {
-        if (*read != ' ') {  // keep only non-space characters
-            *write = *read;
-            write++;
-        }
-        read++;
-    }
-    *write = '\0';  // null-terminate the cleaned string
-}
-
-InputData* copy_input_data(const InputData* src) {
-    InputData* dest = (InputData*)malloc(sizeof(InputData));
-
-    // Copy metadata
-    dest->capacity = src->capacity;
-    dest->count = src->count;
-
-    // Allocate new array of char*
-    dest->items = malloc(dest->capacity * sizeof(char*));
-    if (!dest->items) {
-        dest->capacity = dest->count = 0;
-        return dest;  // handle alloc failure however you like
-    }
-
-    // Deep-copy each string
-    for (size_t i = 0; i < src->count; i++) {
-        dest->items[i] = strdup(src->items[i]);  // or manual malloc/copy
-        if (!dest->items[i]) {
-            // Clean up partial allocation on failure
-            for (size_t j = 0; j < i; j++) free(dest->items[j]);
-            free(dest->items);
-            dest->items = NULL;
-            dest->capacity = dest->count = 0;
-            return dest;
-        }
-    }
-
-    return dest;
-}
-
-InputData read_lines(const char* filename) {
-    InputData input_data = {0};
-    FILE* fp = fopen(filename, "r");
-
-    if (!fp) return input_data;
-
-    char buffer[LINE_MAX_LEN];
-
-    while (fgets(buffer, LINE_MAX_LEN, fp)) {
-        // Trim newline
-        buffer[strcspn(buffer, "\n")] = '\0';
-
-        da_append(&input_data, nob_temp_strdup(buffer));
-    }
-
-    fclose(fp);
-    return input_data;
-}
-
-void split_into_chunks(InputData* out, const char* text, size_t chunk_size) {
-    size_t len = strlen(text);
-
-    for (size_t i = 0; i < len; i += chunk_size) {
-        size_t remaining = len - i;
-        size_t take = remaining < chunk_size ? remaining : chunk_size;
-
-        char* chunk = malloc(take + 1);
-        memcpy(chunk, text + i, take);
-        chunk[take] = '\0';
-
-        nob_da_append(out, chunk);
-    }
-}
-
-char* extract_segment(const char* text, size_t start_index, size_t end_index) {
-    if (start_index >= end_index)
-        return "";
-
-    size_t segment_size = end_index - start_index;
-
-    char* segment = malloc(segment_size + 1);
-    memcpy(segment, text + start_index, segment_size);
-    segment[segment_size] = '\0';
-
-    return segment;
-}
-
-size_t char_to_int(char x) {
-    return (size_t)(x - '0');
-}
-
-char* concat(const char* a, const char* b) {
-    size_t len = strlen(a) + strlen(b) + 1;
-    char* res = malloc(len);
-    snprintf(res, len, "%s%s", a, b);
-    return res;
-}
-
 typedef struct {
     size_t row;
     size_t col;
@@ -183,9 +36,16 @@ typedef struct {
     size_t capacity;
 } Coord2DArray;
 
-uint64_t solve(const InputData* grid) {
+// The line index is the state, the start is looked for in the first line
+static void* parse_manifold(const Lines* lines) {
+    if (lines->count == 0) return NULL;
+    return aoc_parse_lines(lines);
+}
+
+static uint64_t solve(const void* state) {
+    const Lines* grid = state;
     size_t row_count = grid->count;
-    size_t col_count = strlen(grid->items[0]);
+    size_t col_count = grid->items[0].count;
 
     Coord2D start_coord = {0};
     Coord2DArray beams = {0};
@@ -197,7 +57,7 @@ uint64_t solve(const InputData* grid) {
 
     // Find S in the first line
     for (size_t col = 0; col < col_count; ++col) {
-        if (grid->items[0][col] == 'S') {
+        if (grid->items[0].data[col] == 'S') {
             start_coord = (Coord2D){0, col};
             da_append(&beams, start_coord);
             hmput(beam_hashes, start_coord, 1);
@@ -212,14 +72,15 @@ uint64_t solve(const InputData* grid) {
         for (size_t beam_idx = 0; beam_idx < beams.count; ++beam_idx) {
             Coord2D current = beams.items[beam_idx];
 
-            if (current.row < row_count - 1 && current.col < col_count && current.col >= 0) {
-                if (grid->items[current.row + 1][current.col] == '.') {
+            // A beam split off column 0 wraps around to SIZE_MAX, col < col_count catches it
+            if (current.row < row_count - 1 && current.col < col_count) {
+                if (grid->items[current.row + 1].data[current.col] == '.') {
                     Coord2D next = (Coord2D){current.row + 1, current.col};
                     if (hmgeti(beam_hashes, next) == -1) {
                         da_append(&next_beams, next);
                         hmput(beam_hashes, next, 1);
                     }
-                } else if (grid->items[current.row + 1][current.col] == '^') {
+                } else if (grid->items[current.row + 1].data[current.col] == '^') {
                     Coord2D left_next = (Coord2D){current.row + 1, current.col - 1};
                     Coord2D right_next = (Coord2D){current.row + 1, current.col + 1};
 
@@ -245,15 +106,16 @@ uint64_t solve(const InputData* grid) {
     }
 
     da_free(beams);
-    // shfree(beam_hashes);
+    MAP_STATS("part1 beams", beam_hashes);
     hmfree(beam_hashes);
 
     return split_count;
 }
 
-uint64_t solve_part_2(InputData* grid) {
+static uint64_t solve_part_2(const void* state) {
+    const Lines* grid = state;
     size_t row_count = grid->count;
-    size_t col_count = strlen(grid->items[0]);
+    size_t col_count = grid->items[0].count;
 
     Coord2D start_coord = {0};
     Coord2DArray beams = {0};
@@ -265,7 +127,7 @@ uint64_t solve_part_2(InputData* grid) {
 
     // Find S in the first line
     for (size_t col = 0; col < col_count; ++col) {
-        if (grid->items[0][col] == 'S') {
+        if (grid->items[0].data[col] == 'S') {
             start_coord = (Coord2D){0, col};
             da_append(&beams, start_coord);
             hmput(beam_hashes, start_coord, 1);
@@ -281,16 +143,16 @@ uint64_t solve_part_2(InputData* grid) {
             Coord2D current = beams.items[beam_idx];
             uint64_t path_to_here = hmget(beam_hashes, current);
 
-            if (current.row < row_count - 1 && current.col < col_count && current.col >= 0) {
-                if (grid->items[current.row + 1][current.col] == '.') {
+            if (current.row < row_count - 1 && current.col < col_count) {
+                if (grid->items[current.row + 1].data[current.col] == '.') {
                     Coord2D next = (Coord2D){current.row + 1, current.col};
                     if (hmgeti(beam_hashes, next) == -1) {
                         da_append(&next_beams, next);
                         hmput(beam_hashes, next, path_to_here);
                     } else {
-                        hmput(beam_hashes, next, hmget(beam_hashes, next) + path_to_here);
+                        hmgetp(beam_hashes, next)->value += path_to_here;
                     }
-                } else if (grid->items[current.row + 1][current.col] == '^') {
+                } else if (grid->items[current.row + 1].data[current.col] == '^') {
                     Coord2D left_next = (Coord2D){current.row + 1, current.col - 1};
                     Coord2D right_next = (Coord2D){current.row + 1, current.col + 1};
 
@@ -298,14 +160,14 @@ uint64_t solve_part_2(InputData* grid) {
                         da_append(&next_beams, left_next);
                         hmput(beam_hashes, left_next, path_to_here);
                     } else {
-                        hmput(beam_hashes, left_next, hmget(beam_hashes, left_next) + path_to_here);
+                        hmgetp(beam_hashes, left_next)->value += path_to_here;
                     }
 
                     if (hmgeti(beam_hashes, right_next) == -1) {
                         da_append(&next_beams, right_next);
                         hmput(beam_hashes, right_next, path_to_here);
                     } else {
-                        hmput(beam_hashes, right_next, hmget(beam_hashes, right_next) + path_to_here);
+                        hmgetp(beam_hashes, right_next)->value += path_to_here;
                     }
                 }
             } else if (current.row == row_count - 1) {
@@ -315,32 +177,67 @@ uint64_t solve_part_2(InputData* grid) {
         if (next_beams.count == 0) {
             break;
         }
+        da_free(beams);
         beams = next_beams;
     }
 
+    da_free(beams);
+    MAP_STATS("part2 beams", beam_hashes);
+    hmfree(beam_hashes);
+
     return ways_count;
 }
 
-SMatrix read_matrix(const InputData* input_lines) {
-    size_t row_count = input_lines->count;
-    SMatrix matrix = {0};
-    for (size_t row = 0; row < row_count; ++row) {
-        Strings out = {0};
-        split(&out, input_lines->items[row], " ");
-        da_append(&matrix, out);
+// Both parts a row at a time: ways[col + 1] counts the paths of the beam in that column of the row
+// last read, slots 0 and col_count + 1 hold the beams split off the sides. Those end right there,
+// like in the solvers above, and only count towards part 2 when they are on the last row.
+static bool scan_manifold(Line_Stream* lines, uint64_t answers[2]) {
+    String_View row;
+    if (!line_stream_next(lines, &row)) return false;
+
+    size_t col_count = row.count;
+    uint64_t* ways = calloc(col_count + 2, sizeof(uint64_t));
+    uint64_t* next_ways = calloc(col_count + 2, sizeof(uint64_t));
+    NOB_ASSERT(ways != NULL && next_ways != NULL && "Buy more RAM lol");
+
+    // Find S in the first line
+    for (size_t col = 0; col < col_count; ++col) {
+        if (row.data[col] == 'S') {
+            ways[col + 1] = 1;
+            break;
+        }
     }
-    return matrix;
-}
 
-int main() {
-    char* input_file = "inputs/q7_input.txt";
+    uint64_t split_count = 0;
+    while (line_stream_next(lines, &row)) {
+        memset(next_ways, 0, (col_count + 2) * sizeof(uint64_t));
+        for (size_t col = 0; col < col_count; ++col) {
+            uint64_t path_to_here = ways[col + 1];
+            if (path_to_here == 0 || col >= row.count) continue;
+
+            if (row.data[col] == '.') {
+                next_ways[col + 1] += path_to_here;
+            } else if (row.data[col] == '^') {
+                split_count++;
+                next_ways[col] += path_to_here;
+                next_ways[col + 2] += path_to_here;
+            }
+        }
 
-    InputData input_lines = read_lines(input_file);
+        uint64_t* swap = ways;
+        ways = next_ways;
+        next_ways = swap;
+    }
+
+    uint64_t ways_count = 0;
+    for (size_t col = 0; col < col_count + 2; ++col) ways_count += ways[col];
 
-    uint64_t password = solve(&input_lines);
-    uint64_t password = solve_part_2(&input_lines);
-    printf("Password : %" PRIu64 "\n", password);
+    free(ways);
+    free(next_ways);
+    answers[0] += split_count;
+    answers[1] += ways_count;
+    return true;
+}
 
-    da_free(input_lines);
-    return 0;
-}
\ No newline at end of file
+AOC_DAY(7, .name = "Laboratories", .input_path = "inputs/q7_input.txt",
+        .parse = parse_manifold, .part_1 = solve, .part_2 = solve_part_2, .scan = scan_manifold)
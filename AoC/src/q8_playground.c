@@ -5,11 +5,19 @@
 #include <stdlib.h>
 #include <string.h>
 
+#ifndef AOC_RUNNER
 #define NOB_IMPLEMENTATION
+#endif
 #define NOB_STRIP_PREFIX
 
 #include "../header/disjoint_set.h"
 #include "../header/nob.h"
+#include "../header/input.h"
+#include "../header/fast_parse.h"
+#include "../header/arena.h"
+#include "../header/pool.h"
+#include "../header/parallel_parse.h"
+#include "../header/aoc.h"
 
 #define max(a, b) \
     ({ __typeof__ (a) _a = (a); \
@@ -21,151 +29,6 @@
     __typeof__ (b) _b = (b); \
     a < _b ? _a : _b; })
 
-typedef struct {
-    char** items;
-    size_t capacity;
-    size_t count;
-} InputData;
-
-#define LINE_MAX_LEN 100000
-typedef struct {
-    char** items;
-    size_t count;
-    size_t capacity;
-} Strings;
-
-static char*
-strdup_s(const char* s) {
-    size_t len = strlen(s) + 1;
-    char* p = malloc(len);
-    if (!p) return NULL;
-    memcpy(p, s, len);
-    return p;
-}
-
-void split(Strings* out, const char* text, const char* delimiter) {
-    char* copy = strdup_s(text);
-    if (!copy) {
-        fprintf(stderr, "Failed to allocate memory for copy\n");
-        return;
-    }
-
-    char* token = strtok(copy, delimiter);
-    while (token != NULL) {
-        char* tok_copy = strdup_s(token);
-        if (!tok_copy) {
-            fprintf(stderr, "Failed to allocate memory for token\n");
-            break;  // stop adding more; keep what we have
-        }
-        da_append(out, tok_copy);
-        token = strtok(NULL, delimiter);
-    }
-
-    free(copy);
-}
-
-void remove_spaces(char* str) {
-    char* read = str;
-    char* write = str;
-
-    while (*read) {
-        if (*read != ' ') {  // keep only non-space characters
-            *write = *read;
-            write++;
-        }
-        read++;
-    }
-    *write = '\0';  // null-terminate the cleaned string
-}
-
-InputData* copy_input_data(const InputData* src) {
-    InputData* dest = (InputData*)malloc(sizeof(InputData));
-
-    // Copy metadata
-    dest->capacity = src->capacity;
-    dest->count = src->count;
-
-    // Allocate new array of char*
-    dest->items = malloc(dest->capacity * sizeof(char*));
-    if (!dest->items) {
-        dest->capacity = dest->count = 0;
-        return dest;  // handle alloc failure however you like
-    }
-
-    // Deep-copy each string
-    for (size_t i = 0; i < src->count; i++) {
-        dest->items[i] = strdup(src->items[i]);  // or manual malloc/copy
-        if (!dest->items[i]) {
-            // Clean up partial allocation on failure
-            for (size_t j = 0; j < i; j++) free(dest->items[j]);
-            free(dest->items);
-            dest->items = NULL;
-            dest->capacity = dest->count = 0;
-            return dest;
-        }
-    }
-
-    return dest;
-}
-
-InputData read_lines(const char* filename) {
-    InputData input_data = {0};
-    FILE* fp = fopen(filename, "r");
-
-    if (!fp) return input_data;
-
-    char buffer[LINE_MAX_LEN];
-
-    while (fgets(buffer, LINE_MAX_LEN, fp)) {
-        // Trim newline
-        buffer[strcspn(buffer, "\n")] = '\0';
-
-        da_append(&input_data, nob_temp_strdup(buffer));
-    }
-
-    fclose(fp);
-    return input_data;
-}
-
-void split_into_chunks(InputData* out, const char* text, size_t chunk_size) {
-    size_t len = strlen(text);
-
-    for (size_t i = 0; i < len; i += chunk_size) {
-        size_t remaining = len - i;
-        size_t take = remaining < chunk_size ? remaining : chunk_size;
-
-        char* chunk = malloc(take + 1);
-        memcpy(chunk, text + i, take);
-        chunk[take] = '\0';
-
-        nob_da_append(out, chunk);
-    }
-}
-
-char* extract_segment(const char* text, size_t start_index, size_t end_index) {
-    if (start_index >= end_index)
-        return "";
-
-    size_t segment_size = end_index - start_index;
-
-    char* segment = malloc(segment_size + 1);
-    memcpy(segment, text + start_index, segment_size);
-    segment[segment_size] = '\0';
-
-    return segment;
-}
-
-size_t char_to_int(char x) {
-    return (size_t)(x - '0');
-}
-
-char* concat(const char* a, const char* b) {
-    size_t len = strlen(a) + strlen(b) + 1;
-    char* res = malloc(len);
-    snprintf(res, len, "%s%s", a, b);
-    return res;
-}
-
 typedef struct {
     int64_t x, y, z;
 } Point;
@@ -189,7 +52,7 @@ typedef struct {
     size_t capacity;
 } PointArray;
 
-int compare_edges(const void* x, const void* y) {
+static int compare_edges(const void* x, const void* y) {
     Edge e1 = *(Edge*)x;
     Edge e2 = *(Edge*)y;
     if (e1.distance < e2.distance) {
@@ -201,7 +64,7 @@ int compare_edges(const void* x, const void* y) {
     return 0;
 }
 
-int cmp_size_t(const void* a, const void* b) {
+static int cmp_size_t(const void* a, const void* b) {
     size_t x = *(const size_t*)a;
     size_t y = *(const size_t*)b;
 
@@ -210,147 +73,209 @@ int cmp_size_t(const void* a, const void* b) {
     return 0;
 }
 
-uint64_t solve(const InputData* grid, size_t max_iterations) {
-    size_t row_count = grid->count;
-    size_t col_count = strlen(grid->items[0]);
-
-    PointArray points = {0};
-
-    for (size_t point_index = 0; point_index < row_count; ++point_index) {
-        char* point_str = grid->items[point_index];
-        Strings coordinates = {0};
-        split(&coordinates, point_str, ",");
+typedef struct {
+    PointArray points;
+    EdgeArray edges;  // every pair of points, shortest first
+} Playground;
 
-        int32_t x = (int32_t)strtoull(coordinates.items[0], NULL, 10);
-        int32_t y = (int32_t)strtoull(coordinates.items[1], NULL, 10);
-        int32_t z = (int32_t)strtoull(coordinates.items[2], NULL, 10);
+// Pairs are laid out row by row, row i holds the pairs of point i with the points after it
+static size_t edge_row_offset(size_t point_count, size_t row) {
+    return row * (2 * point_count - row - 1) / 2;
+}
 
-        Point p = (Point){x, y, z};
-        da_append(&points, p);
-        da_free(coordinates);
-    }
+static void build_edge_rows(size_t begin, size_t end, Pool_Worker* worker, void* ctx) {
+    (void)worker;
+    Playground* playground = ctx;
+    const PointArray* points = &playground->points;
 
-    EdgeArray edges = {0};
-    for (size_t p_index = 0; p_index < points.count - 1; ++p_index) {
-        for (size_t other_p_index = p_index + 1; other_p_index < points.count; ++other_p_index) {
-            Point p1 = points.items[p_index];
-            Point p2 = points.items[other_p_index];
+    for (size_t p_index = begin; p_index < end; ++p_index) {
+        Edge* edge = playground->edges.items + edge_row_offset(points->count, p_index);
+        for (size_t other_p_index = p_index + 1; other_p_index < points->count; ++other_p_index) {
+            Point p1 = points->items[p_index];
+            Point p2 = points->items[other_p_index];
 
             int64_t diff_sq_x = (p1.x - p2.x) * (p1.x - p2.x);
             int64_t diff_sq_y = (p1.y - p2.y) * (p1.y - p2.y);
             int64_t diff_sq_z = (p1.z - p2.z) * (p1.z - p2.z);
             int64_t distance = diff_sq_x + diff_sq_y + diff_sq_z;
 
-            Edge edge = (Edge){p_index, other_p_index, distance};
-            da_append(&edges, edge);
+            *edge++ = (Edge){p_index, other_p_index, distance};
         }
     }
+}
 
-    qsort(edges.items, edges.count, sizeof(Edge), compare_edges);
+static void free_playground(void* state) {
+    Playground* playground = state;
+    da_free(playground->points);
+    da_free(playground->edges);
+    free(playground);
+}
 
-    DSU set = {0};
-    dsu_init(&set, points.count);
+static Parse_Result parse_point(String_View line, const void* ctx, Arena* arena, void* record) {
+    (void)ctx;
+    (void)arena;
+    if (line.count == 0) return PARSE_SKIP;
 
-    for (size_t edge_idx = 0; edge_idx < max_iterations; ++edge_idx) {
-        size_t p1_index = edges.items[edge_idx].p1_index;
-        size_t p2_index = edges.items[edge_idx].p2_index;
-        float distance = edges.items[edge_idx].distance;
+    int64_t coordinates[3] = {0};
+    parse_i64_fields(line, ',', coordinates, 3);
+    *(Point*)record = (Point){coordinates[0], coordinates[1], coordinates[2]};
+    return PARSE_RECORD;
+}
 
-        if (dsu_find(&set, p1_index) != dsu_find(&set, p2_index)) {
-            dsu_union(&set, p1_index, p2_index);
-        }
+static void* parse(const Lines* grid) {
+    Playground* playground = calloc(1, sizeof(Playground));
+    PointArray* points = &playground->points;
+
+    // Large inputs are parsed in chunks over the pool, small ones by this thread alone
+    points->items = parallel_parse_lines(grid->text, sizeof(Point), parse_point, NULL, NULL, &points->count, NULL);
+    points->capacity = points->count;
+    // Part 1 multiplies the sizes of the three largest circuits
+    if (points->count < 3) {
+        free_playground(playground);
+        return NULL;
     }
 
-    size_t* sizes = (size_t*)calloc(points.count, sizeof(size_t));
-    for (size_t pidx = 0; pidx < points.count; ++pidx) {
-        sizes[dsu_find(&set, pidx)] += 1;
-    }
+    perf_begin("edge build");
+    // Every row knows where its pairs go, so the rows fill the array in parallel in the serial order
+    EdgeArray* edges = &playground->edges;
+    size_t edge_count = edge_row_offset(points->count, points->count - 1);
+    da_reserve(edges, edge_count);
+    edges->count = edge_count;
+    parallel_for(0, points->count - 1, 16, build_edge_rows, playground);
 
-    qsort(set.size, points.count, sizeof(size_t), cmp_size_t);
-    printf("Top 3 Set Sizes : %d %d %d\n", set.size[0], set.size[1], set.size[2]);
+    perf_end(edges->count);
 
-    da_free(points);
-    da_free(edges);
-    dsu_free(&set);
+    perf_begin("sort");
+    qsort(edges->items, edges->count, sizeof(Edge), compare_edges);
+    perf_end(edges->count);
 
-    return (uint64_t)set.size[0] * (uint64_t)set.size[1] * (uint64_t)set.size[2];
+    return playground;
 }
 
-uint64_t solve_part_2(const InputData* grid) {
-    size_t row_count = grid->count;
-    size_t col_count = strlen(grid->items[0]);
+static void save_playground(const void* state, Snapshot_Writer* out) {
+    const Playground* playground = state;
+    snapshot_add(out, playground->points.items, playground->points.count * sizeof(Point));
+    snapshot_add(out, playground->edges.items, playground->edges.count * sizeof(Edge));
+}
 
-    PointArray points = {0};
+// The points and the sorted edges stay in the snapshot, the edge build and the sort are skipped
+static void* restore_playground(const Snapshot* snapshot) {
+    Playground* playground = calloc(1, sizeof(Playground));
+    PointArray* points = &playground->points;
+    EdgeArray* edges = &playground->edges;
+    points->items = (Point*)snapshot_items(snapshot, 0, sizeof(Point), &points->count);
+    edges->items = (Edge*)snapshot_items(snapshot, 1, sizeof(Edge), &edges->count);
+    if (points->items == NULL || edges->items == NULL || points->count < 3 ||
+        edges->count != edge_row_offset(points->count, points->count - 1)) {
+        free(playground);
+        return NULL;
+    }
+    points->capacity = points->count;
+    edges->capacity = edges->count;
+    return playground;
+}
 
-    for (size_t point_index = 0; point_index < row_count; ++point_index) {
-        char* point_str = grid->items[point_index];
-        Strings coordinates = {0};
-        split(&coordinates, point_str, ",");
+static uint64_t solve(const Playground* playground, size_t max_iterations) {
+    const PointArray* points = &playground->points;
+    const EdgeArray* edges = &playground->edges;
 
-        int32_t x = (int32_t)strtoull(coordinates.items[0], NULL, 10);
-        int32_t y = (int32_t)strtoull(coordinates.items[1], NULL, 10);
-        int32_t z = (int32_t)strtoull(coordinates.items[2], NULL, 10);
+    DSU set = {0};
+    dsu_init(&set, points->count);
 
-        Point p = (Point){x, y, z};
-        da_append(&points, p);
+    perf_begin("dsu part1");
+    size_t edge_idx = 0;
+    for (; edge_idx < max_iterations && edge_idx < edges->count; ++edge_idx) {
+        size_t p1_index = edges->items[edge_idx].p1_index;
+        size_t p2_index = edges->items[edge_idx].p2_index;
 
-        da_free(coordinates);
+        if (dsu_find(&set, p1_index) != dsu_find(&set, p2_index)) {
+            dsu_union(&set, p1_index, p2_index);
+        }
     }
+    perf_end(edge_idx);
 
-    EdgeArray edges = {0};
-    for (size_t p_index = 0; p_index < points.count - 1; ++p_index) {
-        for (size_t other_p_index = p_index + 1; other_p_index < points.count; ++other_p_index) {
-            Point p1 = points.items[p_index];
-            Point p2 = points.items[other_p_index];
+    qsort(set.size, points->count, sizeof(size_t), cmp_size_t);
+    uint64_t password = (uint64_t)set.size[0] * (uint64_t)set.size[1] * (uint64_t)set.size[2];
 
-            int64_t diff_sq_x = (p1.x - p2.x) * (p1.x - p2.x);
-            int64_t diff_sq_y = (p1.y - p2.y) * (p1.y - p2.y);
-            int64_t diff_sq_z = (p1.z - p2.z) * (p1.z - p2.z);
-            int64_t distance = diff_sq_x + diff_sq_y + diff_sq_z;
-            Edge edge = (Edge){p_index, other_p_index, distance};
-            da_append(&edges, edge);
-        }
-    }
+    dsu_free(&set);
 
-    qsort(edges.items, edges.count, sizeof(Edge), compare_edges);
+    return password;
+}
+
+static uint64_t part_1(const void* state) {
+    return solve(state, 1000);
+}
+
+static uint64_t solve_part_2(const void* state) {
+    const Playground* playground = state;
+    const PointArray* points = &playground->points;
+    const EdgeArray* edges = &playground->edges;
 
     DSU set = {0};
-    dsu_init(&set, points.count);
+    dsu_init(&set, points->count);
 
     size_t connection_count = 0;
+    uint64_t password = (uint64_t)-1;
 
-    for (size_t edge_idx = 0; edge_idx < edges.count; ++edge_idx) {
-        size_t p1_index = edges.items[edge_idx].p1_index;
-        size_t p2_index = edges.items[edge_idx].p2_index;
-        float distance = edges.items[edge_idx].distance;
+    perf_begin("dsu part2");
+    size_t edge_idx = 0;
+    for (; edge_idx < edges->count; ++edge_idx) {
+        size_t p1_index = edges->items[edge_idx].p1_index;
+        size_t p2_index = edges->items[edge_idx].p2_index;
 
         if (dsu_find(&set, p1_index) != dsu_find(&set, p2_index)) {
             dsu_union(&set, p1_index, p2_index);
             connection_count++;
         }
 
-        if (connection_count == points.count - 1) {
-            printf("%" PRIi64 " %" PRIi64 " \n", points.items[p1_index].x, points.items[p2_index].x);
-            return points.items[p1_index].x * points.items[p2_index].x;
+        if (connection_count == points->count - 1) {
+            password = points->items[p1_index].x * points->items[p2_index].x;
+            break;
         }
     }
+    perf_end(edge_idx);
 
-    da_free(points);
-    da_free(edges);
     dsu_free(&set);
 
-    return -1;
+    return password;
 }
 
-int main() {
-    char* input_file = "inputs/q8_input.txt";
+// The serial parse, line by line and pair by pair, kept as the reference of parse. `aoc diff` times
+// it with the parts against parse with the parts, the parts themselves are shared.
+static void* reference_parse(const Lines* grid) {
+    Playground* playground = calloc(1, sizeof(Playground));
+    PointArray* points = &playground->points;
+
+    Nob_String_View text = grid->text;
+    for (size_t start = 0; start < text.count;) {
+        size_t end = input_find_newline(text.data, start, text.count);
+        Point point;
+        if (parse_point(sv_from_parts(text.data + start, end - start), NULL, NULL, &point) == PARSE_RECORD) {
+            da_append(points, point);
+        }
+        start = end + 1;
+    }
+    if (points->count < 3) {
+        free_playground(playground);
+        return NULL;
+    }
 
-    InputData input_lines = read_lines(input_file);
+    for (size_t p_index = 0; p_index < points->count; ++p_index) {
+        for (size_t other_p_index = p_index + 1; other_p_index < points->count; ++other_p_index) {
+            Point p1 = points->items[p_index];
+            Point p2 = points->items[other_p_index];
 
-    uint64_t password = solve(&input_lines, 1000);
-    uint64_t password = solve_part_2(&input_lines);
-    printf("Password : %" PRIu64 "\n", password);
+            int64_t diff_sq_x = (p1.x - p2.x) * (p1.x - p2.x);
+            int64_t diff_sq_y = (p1.y - p2.y) * (p1.y - p2.y);
+            int64_t diff_sq_z = (p1.z - p2.z) * (p1.z - p2.z);
+            da_append(&playground->edges, ((Edge){p_index, other_p_index, diff_sq_x + diff_sq_y + diff_sq_z}));
+        }
+    }
+    qsort(playground->edges.items, playground->edges.count, sizeof(Edge), compare_edges);
+    return playground;
+}
 
-    da_free(input_lines);
-    return 0;
-}
\ No newline at end of file
+AOC_DAY(8, .name = "Playground", .input_path = "inputs/q8_input.txt",
+        .parse = parse, .part_1 = part_1, .part_2 = solve_part_2, .free = free_playground,
+        .reference_1 = part_1, .reference_2 = solve_part_2, .reference_parse = reference_parse,
+        .save = save_playground, .restore = restore_playground, .text_only = true)
@@ -0,0 +1,105 @@
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NOB_IMPLEMENTATION
+#define NOB_STRIP_PREFIX
+
+#include "../header/nob.h"
+#include "../header/gen.h"
+
+// Writes a synthetic input for one day, see header/gen.h for what the parameters mean per day.
+//
+//     gen --day N [--size N] [--seed N] [--width N] [--height N] [--degree N] [--buttons N] [--output PATH]
+//
+// Without --output the input goes to stdout.
+
+static void usage(const char* program) {
+    fprintf(stderr,
+            "Usage: %s --day N [--size N] [--seed N] [--width N] [--height N] [--degree N] [--buttons N] "
+            "[--output PATH]\n",
+            program);
+    fprintf(stderr, "\n%-4s %-18s %s\n", "day", "size counts", "default size");
+    for (size_t i = 0; i < ARRAY_LEN(gen_days); ++i) {
+        fprintf(stderr, "%-4d %-18s %zu\n", gen_days[i].number, gen_days[i].unit, gen_days[i].default_size);
+    }
+}
+
+static bool parse_number(const char* flag, const char* value, uint64_t* out) {
+    char* end = NULL;
+    unsigned long long parsed = value ? strtoull(value, &end, 10) : 0;
+    if (value == NULL || *value == '-' || *end != '\0') {
+        nob_log(ERROR, "%s expects a non-negative number", flag);
+        return false;
+    }
+    *out = parsed;
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* program = shift(argv, argc);
+    Gen_Params params = {0};
+    const char* output = NULL;
+
+    while (argc > 0) {
+        const char* flag = shift(argv, argc);
+        const char* value = argc > 0 ? argv[0] : NULL;
+        uint64_t parsed = 0;
+
+        if (strcmp(flag, "--output") == 0) {
+            if (value == NULL) {
+                nob_log(ERROR, "--output expects a path");
+                return 1;
+            }
+            output = value;
+        } else if (strcmp(flag, "--day") == 0) {
+            if (!parse_number(flag, value, &parsed)) return 1;
+            params.day = (int)parsed;
+        } else if (strcmp(flag, "--size") == 0) {
+            if (!parse_number(flag, value, &parsed)) return 1;
+            params.size = (size_t)parsed;
+        } else if (strcmp(flag, "--seed") == 0) {
+            if (!parse_number(flag, value, &parsed)) return 1;
+            params.seed = parsed;
+        } else if (strcmp(flag, "--width") == 0) {
+            if (!parse_number(flag, value, &parsed)) return 1;
+            params.width = (size_t)parsed;
+        } else if (strcmp(flag, "--height") == 0) {
+            if (!parse_number(flag, value, &parsed)) return 1;
+            params.height = (size_t)parsed;
+        } else if (strcmp(flag, "--degree") == 0) {
+            if (!parse_number(flag, value, &parsed)) return 1;
+            params.degree = (size_t)parsed;
+        } else if (strcmp(flag, "--buttons") == 0) {
+            if (!parse_number(flag, value, &parsed)) return 1;
+            params.buttons = (size_t)parsed;
+        } else {
+            if (strcmp(flag, "--help") != 0 && strcmp(flag, "-h") != 0) {
+                nob_log(ERROR, "Unknown flag %s", flag);
+            }
+            usage(program);
+            return 1;
+        }
+        shift(argv, argc);
+    }
+
+    if (params.day == 0) {
+        usage(program);
+        return 1;
+    }
+
+    String_Builder sb = {0};
+    if (!gen_input(&params, &sb)) return 1;
+
+    bool ok = true;
+    if (output) {
+        ok = write_entire_file(output, sb.items, sb.count);
+    } else {
+        ok = fwrite(sb.items, 1, sb.count, stdout) == sb.count;
+    }
+
+    sb_free(sb);
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,550 @@
+#include <inttypes.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NOB_IMPLEMENTATION
+#define NOB_STRIP_PREFIX
+
+#include "../header/nob.h"
+#include "../header/bench.h"
+#include "../header/gen.h"
+#include "../header/queue.h"
+#include "../header/disjoint_set.h"
+#include "../header/interval_tree.h"
+#include "../header/std_ds.h"
+
+// Throughput of the data structure headers on their own, away from the solvers.
+//
+//     microbench [--filter TEXT] [--sizes N,N,...] [--seed N] [--format text|csv|json]
+//
+// Every case runs at every size (1k to 1M elements by default) and reports the median time of a run
+// and operations per second. Keys are random unless the case says sorted, the same seed gives the same
+// keys. The unbalanced interval tree and the unranked dsu_mix() chain recurse once per element, those
+// cases stop at MICRO_DEEP_SIZE, and a size is skipped once a single run of the previous one took
+// longer than MICRO_SLOW_NS.
+
+#define MICRO_DEEP_SIZE 20000
+#define MICRO_MIN_RUNS 3
+#define MICRO_MIN_NS 200000000ull  // keep repeating until this much time was measured
+#define MICRO_MAX_NS 2000000000ull
+#define MICRO_SLOW_NS 1000000000ull
+
+typedef struct {
+    size_t count;
+    uint64_t* random;  // distinct, in random order
+    uint64_t* sorted;  // the same keys ascending
+    char** strings;    // the random keys in hex
+    Gen_Rng rng;       // for anything else a case needs
+} Micro_Input;
+
+typedef struct {
+    uint64_t start;
+    uint64_t elapsed;
+} Micro_Timer;
+
+// Runs one case once, times only the part between micro_start() and micro_stop() and returns the
+// number of operations in it
+typedef uint64_t (*Micro_Run)(Micro_Input* input, Micro_Timer* timer);
+
+typedef struct {
+    const char* group;
+    const char* name;
+    size_t max_size;  // 0 for no limit
+    Micro_Run run;
+} Micro_Case;
+
+typedef struct {
+    const char* group;
+    const char* name;
+    size_t size;
+    uint64_t ops;
+    Bench_Stats stats;
+} Micro_Row;
+
+typedef struct {
+    Micro_Row* items;
+    size_t count;
+    size_t capacity;
+} Micro_Report;
+
+typedef struct {
+    size_t* items;
+    size_t count;
+    size_t capacity;
+} Micro_Sizes;
+
+// Results end up here so the compiler cannot drop the work
+static volatile uint64_t micro_sink;
+
+static inline void micro_start(Micro_Timer* timer) {
+    timer->start = bench_now_ns();
+}
+
+static inline void micro_stop(Micro_Timer* timer) {
+    timer->elapsed += bench_now_ns() - timer->start;
+}
+
+static Interval micro_interval(uint64_t low, Gen_Rng* rng) {
+    return (Interval){low, low + gen_range(rng, 0, 1000)};
+}
+
+// queue.h
+
+static uint64_t micro_queue_fill_drain(Micro_Input* input, Micro_Timer* timer) {
+    Queue queue;
+    uint64_t value = 0;
+    micro_start(timer);
+    queue_init(&queue, sizeof(uint64_t), 1);  // every power of two goes through queue_grow()
+    for (size_t i = 0; i < input->count; ++i) queue_enqueue(&queue, &input->random[i]);
+    while (queue_dequeue(&queue, &value) == 0) micro_sink += value;
+    queue_free(&queue);
+    micro_stop(timer);
+    return 2 * input->count;
+}
+
+static uint64_t micro_queue_ring(Micro_Input* input, Micro_Timer* timer) {
+    Queue queue;
+    uint64_t value = 0;
+    queue_init(&queue, sizeof(uint64_t), 64);
+    micro_start(timer);
+    // A BFS frontier that stays small, head and tail keep wrapping without a grow
+    for (size_t i = 0; i < input->count; ++i) {
+        queue_enqueue(&queue, &input->random[i]);
+        if (queue.size > 32) {
+            queue_dequeue(&queue, &value);
+            micro_sink += value;
+        }
+    }
+    micro_stop(timer);
+    queue_free(&queue);
+    return input->count + (input->count > 32 ? input->count - 32 : 0);
+}
+
+// disjoint_set.h
+
+static uint64_t micro_dsu_union_random(Micro_Input* input, Micro_Timer* timer) {
+    DSU dsu;
+    dsu_init(&dsu, input->count);
+    micro_start(timer);
+    for (size_t i = 0; i < input->count; ++i) {
+        dsu_union(&dsu, input->random[i] % input->count, gen_next(&input->rng) % input->count);
+    }
+    micro_stop(timer);
+    micro_sink += dsu_set_size(&dsu, 0);
+    dsu_free(&dsu);
+    return input->count;
+}
+
+static uint64_t micro_dsu_find_random(Micro_Input* input, Micro_Timer* timer) {
+    DSU dsu;
+    dsu_init(&dsu, input->count);
+    for (size_t i = 0; i < input->count / 2; ++i) {
+        dsu_union(&dsu, input->random[i] % input->count, gen_next(&input->rng) % input->count);
+    }
+    micro_start(timer);
+    for (size_t i = 0; i < input->count; ++i) micro_sink += dsu_find(&dsu, input->random[i] % input->count);
+    micro_stop(timer);
+    dsu_free(&dsu);
+    return input->count;
+}
+
+// Equal sized trees merged round by round, the worst case for union by size: log n deep
+static void micro_dsu_binomial(DSU* dsu, size_t count) {
+    for (size_t step = 1; step < count; step *= 2) {
+        for (size_t i = 0; i + step < count; i += 2 * step) dsu_union(dsu, i + step, i);
+    }
+}
+
+static uint64_t micro_dsu_union_binomial(Micro_Input* input, Micro_Timer* timer) {
+    DSU dsu;
+    dsu_init(&dsu, input->count);
+    micro_start(timer);
+    micro_dsu_binomial(&dsu, input->count);
+    micro_stop(timer);
+    micro_sink += dsu_set_size(&dsu, 0);
+    dsu_free(&dsu);
+    return input->count - 1;
+}
+
+static uint64_t micro_dsu_find_binomial(Micro_Input* input, Micro_Timer* timer) {
+    DSU dsu;
+    dsu_init(&dsu, input->count);
+    micro_dsu_binomial(&dsu, input->count);
+    micro_start(timer);
+    // Deepest leaves first, path compression has not flattened anything yet
+    for (size_t i = input->count; i-- > 0;) micro_sink += dsu_find(&dsu, i);
+    micro_stop(timer);
+    dsu_free(&dsu);
+    return input->count;
+}
+
+static uint64_t micro_dsu_mix_chain(Micro_Input* input, Micro_Timer* timer) {
+    DSU dsu;
+    dsu_init(&dsu, input->count);
+    micro_start(timer);
+    // dsu_mix() ignores the sizes, linking in order builds one chain as deep as the set is large
+    for (size_t i = 0; i + 1 < input->count; ++i) dsu_mix(&dsu, i, i + 1);
+    for (size_t i = 0; i < input->count; ++i) micro_sink += dsu_find(&dsu, i);
+    micro_stop(timer);
+    dsu_free(&dsu);
+    return 2 * input->count - 1;
+}
+
+// interval_tree.h
+
+static uint64_t micro_tree_insert(Micro_Input* input, const uint64_t* keys, Micro_Timer* timer) {
+    ITNode* root = NULL;
+    micro_start(timer);
+    for (size_t i = 0; i < input->count; ++i) root = insert(root, micro_interval(keys[i], &input->rng));
+    micro_stop(timer);
+    micro_sink += root->max;
+    freeTree(root);
+    return input->count;
+}
+
+static uint64_t micro_tree_insert_random(Micro_Input* input, Micro_Timer* timer) {
+    return micro_tree_insert(input, input->random, timer);
+}
+
+static uint64_t micro_tree_insert_sorted(Micro_Input* input, Micro_Timer* timer) {
+    return micro_tree_insert(input, input->sorted, timer);
+}
+
+static uint64_t micro_tree_merge(Micro_Input* input, const uint64_t* keys, Micro_Timer* timer) {
+    ITNode* root = NULL;
+    micro_start(timer);
+    for (size_t i = 0; i < input->count; ++i) root = insertAndMerge(root, micro_interval(keys[i], &input->rng));
+    micro_stop(timer);
+    micro_sink += root->max;
+    freeTree(root);
+    return input->count;
+}
+
+static uint64_t micro_tree_merge_random(Micro_Input* input, Micro_Timer* timer) {
+    return micro_tree_merge(input, input->random, timer);
+}
+
+static uint64_t micro_tree_merge_sorted(Micro_Input* input, Micro_Timer* timer) {
+    return micro_tree_merge(input, input->sorted, timer);
+}
+
+static uint64_t micro_tree_contains(Micro_Input* input, const uint64_t* keys, Micro_Timer* timer) {
+    ITNode* root = NULL;
+    for (size_t i = 0; i < input->count; ++i) root = insert(root, micro_interval(keys[i], &input->rng));
+    micro_start(timer);
+    // Half of the points hit an interval start, the other half are random
+    for (size_t i = 0; i < input->count; ++i) {
+        uint64_t x = i % 2 ? input->random[i] : gen_next(&input->rng);
+        micro_sink += containsPoint(root, x, NULL);
+    }
+    micro_stop(timer);
+    freeTree(root);
+    return input->count;
+}
+
+static uint64_t micro_tree_contains_random(Micro_Input* input, Micro_Timer* timer) {
+    return micro_tree_contains(input, input->random, timer);
+}
+
+static uint64_t micro_tree_contains_sorted(Micro_Input* input, Micro_Timer* timer) {
+    return micro_tree_contains(input, input->sorted, timer);
+}
+
+// std_ds.h
+
+typedef struct {
+    int64_t row;
+    int64_t col;
+} Micro_Coord;  // the key shape of day 7
+
+static uint64_t micro_hm_u64_put(Micro_Input* input, Micro_Timer* timer) {
+    struct {
+        uint64_t key;
+        uint64_t value;
+    }* map = NULL;
+    micro_start(timer);
+    for (size_t i = 0; i < input->count; ++i) hmput(map, input->random[i], i);
+    micro_stop(timer);
+    micro_sink += hmlenu(map);
+    hmfree(map);
+    return input->count;
+}
+
+static uint64_t micro_hm_u64_get(Micro_Input* input, Micro_Timer* timer) {
+    struct {
+        uint64_t key;
+        uint64_t value;
+    }* map = NULL;
+    for (size_t i = 0; i < input->count; ++i) hmput(map, input->random[i], i);
+    micro_start(timer);
+    for (size_t i = 0; i < input->count; ++i) micro_sink += hmgeti(map, input->sorted[i]);
+    micro_stop(timer);
+    hmfree(map);
+    return input->count;
+}
+
+static uint64_t micro_hm_struct_put(Micro_Input* input, Micro_Timer* timer) {
+    struct {
+        Micro_Coord key;
+        uint64_t value;
+    }* map = NULL;
+    micro_start(timer);
+    for (size_t i = 0; i < input->count; ++i) {
+        Micro_Coord key = {(int64_t)(input->random[i] >> 32), (int64_t)(input->random[i] & 0xffffffff)};
+        hmput(map, key, i);
+    }
+    micro_stop(timer);
+    micro_sink += hmlenu(map);
+    hmfree(map);
+    return input->count;
+}
+
+static uint64_t micro_hm_struct_get(Micro_Input* input, Micro_Timer* timer) {
+    struct {
+        Micro_Coord key;
+        uint64_t value;
+    }* map = NULL;
+    for (size_t i = 0; i < input->count; ++i) {
+        Micro_Coord key = {(int64_t)(input->random[i] >> 32), (int64_t)(input->random[i] & 0xffffffff)};
+        hmput(map, key, i);
+    }
+    micro_start(timer);
+    for (size_t i = 0; i < input->count; ++i) {
+        Micro_Coord key = {(int64_t)(input->sorted[i] >> 32), (int64_t)(input->sorted[i] & 0xffffffff)};
+        micro_sink += hmgeti(map, key);
+    }
+    micro_stop(timer);
+    hmfree(map);
+    return input->count;
+}
+
+static uint64_t micro_sh_put(Micro_Input* input, Micro_Timer* timer) {
+    struct {
+        char* key;
+        uint64_t value;
+    }* map = NULL;
+    micro_start(timer);
+    sh_new_arena(map);  // copies the keys like day 11 does
+    for (size_t i = 0; i < input->count; ++i) shput(map, input->strings[i], i);
+    micro_stop(timer);
+    micro_sink += shlenu(map);
+    shfree(map);
+    return input->count;
+}
+
+static uint64_t micro_sh_get(Micro_Input* input, Micro_Timer* timer) {
+    struct {
+        char* key;
+        uint64_t value;
+    }* map = NULL;
+    sh_new_arena(map);
+    for (size_t i = 0; i < input->count; ++i) shput(map, input->strings[i], i);
+    micro_start(timer);
+    for (size_t i = input->count; i-- > 0;) micro_sink += shgeti(map, input->strings[i]);
+    micro_stop(timer);
+    shfree(map);
+    return input->count;
+}
+
+static const Micro_Case micro_cases[] = {
+    {"queue", "fill+drain", 0, micro_queue_fill_drain},
+    {"queue", "ring", 0, micro_queue_ring},
+    {"dsu", "union random", 0, micro_dsu_union_random},
+    {"dsu", "find random", 0, micro_dsu_find_random},
+    {"dsu", "union binomial", 0, micro_dsu_union_binomial},
+    {"dsu", "find binomial", 0, micro_dsu_find_binomial},
+    {"dsu", "mix chain", MICRO_DEEP_SIZE, micro_dsu_mix_chain},
+    {"itree", "insert random", 0, micro_tree_insert_random},
+    {"itree", "insert sorted", MICRO_DEEP_SIZE, micro_tree_insert_sorted},
+    {"itree", "merge random", 0, micro_tree_merge_random},
+    {"itree", "merge sorted", MICRO_DEEP_SIZE, micro_tree_merge_sorted},
+    {"itree", "contains random", 0, micro_tree_contains_random},
+    {"itree", "contains sorted", MICRO_DEEP_SIZE, micro_tree_contains_sorted},
+    {"hm", "put u64", 0, micro_hm_u64_put},
+    {"hm", "get u64", 0, micro_hm_u64_get},
+    {"hm", "put struct", 0, micro_hm_struct_put},
+    {"hm", "get struct", 0, micro_hm_struct_get},
+    {"sh", "put string", 0, micro_sh_put},
+    {"sh", "get string", 0, micro_sh_get},
+};
+
+static int micro_compare_u64(const void* a, const void* b) {
+    return bench__cmp_u64(a, b);
+}
+
+static void micro_input_init(Micro_Input* input, size_t count, uint64_t seed) {
+    input->count = count;
+    input->rng = (Gen_Rng){seed};
+    input->random = malloc(count * sizeof(uint64_t));
+    input->sorted = malloc(count * sizeof(uint64_t));
+    input->strings = malloc(count * sizeof(char*));
+    char* text = malloc(count * 17);
+    if (!input->random || !input->sorted || !input->strings || !text) {
+        nob_log(ERROR, "Out of memory for %zu keys", count);
+        exit(1);
+    }
+
+    // Odd multiples of a random odd number are distinct, and the low bits still look random
+    uint64_t odd = gen_next(&input->rng) | 1;
+    for (size_t i = 0; i < count; ++i) input->random[i] = (2 * (uint64_t)i + 1) * odd;
+    memcpy(input->sorted, input->random, count * sizeof(uint64_t));
+    qsort(input->sorted, count, sizeof(uint64_t), micro_compare_u64);
+
+    for (size_t i = 0; i < count; ++i) {
+        input->strings[i] = text + 17 * i;
+        snprintf(input->strings[i], 17, "%" PRIx64, input->random[i]);
+    }
+}
+
+static void micro_input_free(Micro_Input* input) {
+    if (input->count > 0) free(input->strings[0]);
+    free(input->strings);
+    free(input->random);
+    free(input->sorted);
+}
+
+static void micro_print_report(FILE* out, const Micro_Report* report, Bench_Format format) {
+    switch (format) {
+        case BENCH_TEXT:
+            fprintf(out, "%-6s %-16s %9s %12s %12s %10s\n", "group", "case", "size", "median(ms)", "Mops/s",
+                    "ns/op");
+            for (size_t i = 0; i < report->count; ++i) {
+                const Micro_Row* row = &report->items[i];
+                double seconds = row->stats.median / 1e9;
+                fprintf(out, "%-6s %-16s %9zu %12.3f %12.2f %10.1f\n", row->group, row->name, row->size, seconds * 1e3,
+                        row->ops / seconds / 1e6, (double)row->stats.median / (double)row->ops);
+            }
+            break;
+
+        case BENCH_CSV:
+            fprintf(out, "group,case,size,ops,runs,min_ns,median_ns,p90_ns,ops_per_sec\n");
+            for (size_t i = 0; i < report->count; ++i) {
+                const Micro_Row* row = &report->items[i];
+                fprintf(out, "%s,%s,%zu,%" PRIu64 ",%zu,%" PRIu64 ",%" PRIu64 ",%" PRIu64 ",%.1f\n", row->group,
+                        row->name, row->size, row->ops, row->stats.runs, row->stats.min, row->stats.median, row->stats.p90,
+                        row->ops / (row->stats.median / 1e9));
+            }
+            break;
+
+        case BENCH_JSON:
+            fprintf(out, "[\n");
+            for (size_t i = 0; i < report->count; ++i) {
+                const Micro_Row* row = &report->items[i];
+                fprintf(out,
+                        "  {\"group\": \"%s\", \"case\": \"%s\", \"size\": %zu, \"ops\": %" PRIu64
+                        ", \"runs\": %zu, \"min_ns\": %" PRIu64 ", \"median_ns\": %" PRIu64 ", \"p90_ns\": %" PRIu64
+                        ", \"ops_per_sec\": %.1f}%s\n",
+                        row->group, row->name, row->size, row->ops, row->stats.runs, row->stats.min, row->stats.median,
+                        row->stats.p90, row->ops / (row->stats.median / 1e9), i + 1 < report->count ? "," : "");
+            }
+            fprintf(out, "]\n");
+            break;
+    }
+}
+
+static bool parse_sizes(const char* value, Micro_Sizes* sizes) {
+    sizes->count = 0;
+    while (value && *value) {
+        char* end = NULL;
+        unsigned long long size = strtoull(value, &end, 10);
+        if (end == value || size == 0 || (*end != ',' && *end != '\0')) return false;
+        da_append(sizes, (size_t)size);
+        value = *end == ',' ? end + 1 : end;
+    }
+    return sizes->count > 0;
+}
+
+static void usage(const char* program) {
+    fprintf(stderr, "Usage: %s [--filter TEXT] [--sizes N,N,...] [--seed N] [--format text|csv|json]\n", program);
+    fprintf(stderr, "\n%-6s %-16s %s\n", "group", "case", "max size");
+    for (size_t i = 0; i < ARRAY_LEN(micro_cases); ++i) {
+        const Micro_Case* c = &micro_cases[i];
+        fprintf(stderr, "%-6s %-16s %s\n", c->group, c->name, c->max_size ? temp_sprintf("%zu", c->max_size) : "-");
+    }
+}
+
+int main(int argc, char** argv) {
+    const char* program = shift(argv, argc);
+    const char* filter = NULL;
+    uint64_t seed = 1;
+    Bench_Format format = BENCH_TEXT;
+    Micro_Sizes sizes = {0};
+    parse_sizes("1000,10000,100000,1000000", &sizes);
+
+    while (argc > 0) {
+        const char* flag = shift(argv, argc);
+        const char* value = argc > 0 ? argv[0] : NULL;
+
+        if (strcmp(flag, "--filter") == 0 && value) {
+            filter = value;
+        } else if (strcmp(flag, "--sizes") == 0 && value) {
+            if (!parse_sizes(value, &sizes)) {
+                nob_log(ERROR, "--sizes expects positive numbers separated by commas");
+                return 1;
+            }
+        } else if (strcmp(flag, "--seed") == 0 && value) {
+            seed = strtoull(value, NULL, 10);
+        } else if (strcmp(flag, "--format") == 0 && value) {
+            if (!bench_parse_format(value, &format)) {
+                nob_log(ERROR, "Unknown format %s, expected text, csv or json", value);
+                return 1;
+            }
+        } else {
+            if (strcmp(flag, "--help") != 0 && strcmp(flag, "-h") != 0) {
+                nob_log(ERROR, "Unknown flag or missing value: %s", flag);
+            }
+            usage(program);
+            return 1;
+        }
+        shift(argv, argc);
+    }
+
+    Micro_Report report = {0};
+    Bench_Samples samples = {0};
+    for (size_t c = 0; c < ARRAY_LEN(micro_cases); ++c) {
+        const Micro_Case* micro = &micro_cases[c];
+        char label[64];
+        snprintf(label, sizeof(label), "%s %s", micro->group, micro->name);
+        if (filter && strstr(label, filter) == NULL) continue;
+
+        uint64_t slowest_run = 0;
+        for (size_t s = 0; s < sizes.count; ++s) {
+            size_t size = sizes.items[s];
+            if (micro->max_size && size > micro->max_size) break;
+            if (slowest_run > MICRO_SLOW_NS) {
+                nob_log(INFO, "%s: skipping %zu and up, one run took %.2fs", label, size, slowest_run / 1e9);
+                break;
+            }
+
+            // Every run gets the same keys, rebuilding them is not timed
+            Micro_Input input = {0};
+            micro_input_init(&input, size, seed);
+
+            samples.count = 0;
+            uint64_t ops = 0;
+            uint64_t measured = 0;
+            while (samples.count < MICRO_MIN_RUNS || measured < MICRO_MIN_NS) {
+                Micro_Timer timer = {0};
+                input.rng = (Gen_Rng){seed ^ size};
+                ops = micro->run(&input, &timer);
+                da_append(&samples, timer.elapsed);
+                measured += timer.elapsed;
+                if (timer.elapsed > slowest_run) slowest_run = timer.elapsed;
+                if (measured > MICRO_MAX_NS || timer.elapsed > MICRO_SLOW_NS) break;
+            }
+            micro_input_free(&input);
+
+            Micro_Row row = {.group = micro->group, .name = micro->name, .size = size, .ops = ops};
+            row.stats = bench_stats(&samples);
+            da_append(&report, row);
+        }
+    }
+
+    micro_print_report(stdout, &report, format);
+    da_free(samples);
+    da_free(report);
+    da_free(sizes);
+    return 0;
+}